@@ -5,7 +5,7 @@ import shutil
 INCLUDE_DIR = "include/crosstalk"
 DIST_DIR = "dist"
 OUTPUT_HEADER = "crosstalk.hpp"
-HEADERS = ["refl.hpp", "endian.hpp", "serial_abstraction.hpp", "crosstalker.hpp"]
+HEADERS = ["refl.hpp", "endian.hpp", "serial_abstraction.hpp", "crosstalker.hpp", "log.hpp", "flow_control.hpp", "reliable.hpp", "rpc.hpp"]
 
 
 def strip_includes(content, to_strip):
@@ -52,6 +52,14 @@ def main():
             dst_path = os.path.join(DIST_DIR, "serial_abstractions", file)
             shutil.copy(src_path, dst_path)
             print(f"Copied {file} to {dst_path}")
+    print("Copying host tools")
+    os.makedirs(os.path.join(DIST_DIR, "host"), exist_ok=True)
+    for file in os.listdir(os.path.join(INCLUDE_DIR, "host")):
+        if file.endswith(".hpp"):
+            src_path = os.path.join(INCLUDE_DIR, "host", file)
+            dst_path = os.path.join(DIST_DIR, "host", file)
+            shutil.copy(src_path, dst_path)
+            print(f"Copied {file} to {dst_path}")
 
 if __name__ == "__main__":
     main()
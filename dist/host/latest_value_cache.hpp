@@ -0,0 +1,176 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef CROSSTALK_HOST_LATEST_VALUE_CACHE_HPP
+#define CROSSTALK_HOST_LATEST_VALUE_CACHE_HPP
+
+#ifndef CROSSTALK_CROSSTALKER_HPP
+  #error "Include crosstalk.hpp or crosstalk/crosstalker.hpp before including host/latest_value_cache.hpp"
+#endif // CROSSTALK_CROSSTALKER_HPP
+
+#include <atomic>
+#include <cstring>
+#include <tuple>
+
+namespace crosstalk
+{
+
+/*!
+ * Slot holding the most recent value of T, written by one thread and read by any number of threads.
+ * Uses a seqlock: the writer increments the sequence before and after writing, readers copy the
+ * value and retry if the sequence changed or a write was in progress. Reads never block the writer
+ * and only retry while a write is in progress. The value is stored in atomic words, so T has to be
+ * trivially copyable, e.g., an object with only scalar and std::array fields.
+ */
+template<typename T>
+class LatestValue
+{
+  static_assert( std::is_trivially_copyable_v<T>, "LatestValue requires a trivially copyable type." );
+
+public:
+  LatestValue() = default;
+  LatestValue( const LatestValue & ) = delete;
+  LatestValue &operator=( const LatestValue & ) = delete;
+
+  //! Stores the value. Must only be called from one thread at a time.
+  void store( const T &value )
+  {
+    Words words{};
+    std::memcpy( words.data(), &value, sizeof( T ) );
+    const uint64_t sequence = sequence_.load( std::memory_order_relaxed );
+    sequence_.store( sequence + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    for ( size_t i = 0; i < WORD_COUNT; ++i ) data_[i].store( words[i], std::memory_order_relaxed );
+    sequence_.store( sequence + 2, std::memory_order_release );
+  }
+
+  /*!
+   * Copies the latest value.
+   * @param version If not null, set to the version of the value, see version().
+   * @return False if no value was stored yet.
+   */
+  bool load( T &value, uint64_t *version = nullptr ) const
+  {
+    Words words;
+    uint64_t sequence;
+    while ( true ) {
+      sequence = sequence_.load( std::memory_order_acquire );
+      if ( sequence & 1 )
+        continue; // Write in progress
+      for ( size_t i = 0; i < WORD_COUNT; ++i ) words[i] = data_[i].load( std::memory_order_relaxed );
+      std::atomic_thread_fence( std::memory_order_acquire );
+      if ( sequence_.load( std::memory_order_relaxed ) == sequence )
+        break;
+    }
+    if ( version != nullptr )
+      *version = sequence / 2;
+    if ( sequence == 0 )
+      return false;
+    std::memcpy( static_cast<void *>( &value ), words.data(), sizeof( T ) );
+    return true;
+  }
+
+  //! Number of stored values. Can be used to check for a new value without copying it.
+  uint64_t version() const { return sequence_.load( std::memory_order_acquire ) / 2; }
+
+private:
+  static constexpr size_t WORD_COUNT = ( sizeof( T ) + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t );
+  using Words = std::array<uint64_t, WORD_COUNT>;
+
+  std::atomic<uint64_t> sequence_{ 0 };
+  std::array<std::atomic<uint64_t>, WORD_COUNT> data_{};
+};
+
+/*!
+ * Keeps the most recent object of each of the types Ts, e.g., for consumers that only need the
+ * newest state and poll it from other threads at their own rate.
+ * @code
+ * crosstalk::LatestValueCache<CommStatus, TestObjectSimple> cache;
+ * // Receive thread
+ * crosstalker.processSerialData();
+ * while ( crosstalker.hasObject() ) {
+ *   if ( cache.read( crosstalker ) == crosstalk::ReadResult::ObjectIdMismatch )
+ *     crosstalker.skipObject(); // Or handle other types
+ * }
+ * // Any thread
+ * CommStatus status;
+ * if ( cache.load( status ) ) ...
+ * @endcode
+ */
+template<typename... Ts>
+class LatestValueCache
+{
+public:
+  //! Stores the value if T is one of the cached types.
+  template<typename T>
+  void store( const T &value )
+  {
+    std::get<LatestValue<T>>( slots_ ).store( value );
+  }
+
+  template<typename T>
+  bool load( T &value, uint64_t *version = nullptr ) const
+  {
+    return std::get<LatestValue<T>>( slots_ ).load( value, version );
+  }
+
+  template<typename T>
+  uint64_t version() const
+  {
+    return std::get<LatestValue<T>>( slots_ ).version();
+  }
+
+  //! True if frames with the given id are cached.
+  static constexpr bool contains( int16_t id ) { return ( ( object_id<Ts>() == id ) || ... ); }
+
+  /*!
+   * Reads the current object and stores it if it is one of the cached types.
+   * @return ObjectIdMismatch without reading the object if it is not one of the cached types.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  ReadResult read( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker )
+  {
+    if ( !crosstalker.hasObject() )
+      return ReadResult::NoObjectAvailable;
+    const int16_t id = crosstalker.getObjectId();
+    ReadResult result = ReadResult::ObjectIdMismatch;
+    ( ( object_id<Ts>() == id ? void( result = _read<Ts>( crosstalker ) ) : void() ), ... );
+    return result;
+  }
+
+private:
+  template<typename T, typename CrossTalkerT>
+  ReadResult _read( CrossTalkerT &crosstalker )
+  {
+    T obj;
+    ReadResult result = crosstalker.readObject( obj );
+    if ( result == ReadResult::Success )
+      store( obj );
+    return result;
+  }
+
+  std::tuple<LatestValue<Ts>...> slots_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_LATEST_VALUE_CACHE_HPP
@@ -0,0 +1,203 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_HOST_LOG_FORMATTER_HPP
+#define CROSSTALK_HOST_LOG_FORMATTER_HPP
+
+#ifndef CROSSTALK_LOG_HPP
+  #error "Include crosstalk.hpp or crosstalk/log.hpp before including host/log_formatter.hpp"
+#endif // CROSSTALK_LOG_HPP
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+namespace crosstalk
+{
+namespace detail
+{
+//! Strings are sent as const char * and received as std::string.
+template<typename T>
+struct ReceivedLogArgument {
+  using type = T;
+};
+
+template<>
+struct ReceivedLogArgument<const char *> {
+  using type = std::string;
+};
+
+template<typename T>
+void appendLogArgument( std::string &message, const T &value )
+{
+  if constexpr ( std::is_same_v<T, bool> ) {
+    message += value ? "true" : "false";
+  } else if constexpr ( std::is_same_v<T, char> ) {
+    message += value;
+  } else if constexpr ( std::is_enum_v<T> ) {
+    message += std::to_string( static_cast<std::underlying_type_t<T>>( value ) );
+  } else if constexpr ( std::is_floating_point_v<T> ) {
+    char buffer[32];
+    std::snprintf( buffer, sizeof( buffer ), "%g", static_cast<double>( value ) );
+    message += buffer;
+  } else {
+    message += std::to_string( value );
+  }
+}
+
+inline void appendLogArgument( std::string &message, const std::string &value ) { message += value; }
+} // namespace detail
+
+/*!
+ * Host side string table of the log formats declared in the shared header.
+ * @code
+ * auto table = crosstalk::LogStringTable::create<LogTestStarted, LogObjectResult>();
+ * std::string message;
+ * if ( crosstalk::readLog( crosstalker, table, message ) == crosstalk::ReadResult::Success )
+ *   std::cout << message << std::endl;
+ * @endcode
+ */
+class LogStringTable
+{
+public:
+  template<typename... Formats>
+  static LogStringTable create()
+  {
+    LogStringTable table;
+    ( table.add<Formats>(), ... );
+    return table;
+  }
+
+  //! Adds the format. Returns false if a format with the same id was already added.
+  template<typename Format>
+  bool add()
+  {
+    return entries_.emplace( Format::LOG_ID, Entry{ Format::FORMAT, &LogStringTable::_format<Format> } )
+        .second;
+  }
+
+  //! Returns the format string for the id or nullptr if it is unknown.
+  const char *formatString( uint16_t log_id ) const
+  {
+    auto it = entries_.find( log_id );
+    return it == entries_.end() ? nullptr : it->second.format;
+  }
+
+  /*!
+   * Formats the payload of a log frame into message.
+   * @return The number of consumed payload bytes. Smaller than size if the format is unknown or
+   *   the arguments do not match, which indicates that the table does not match the firmware.
+   */
+  size_t format( const uint8_t *payload, size_t size, std::string &message ) const
+  {
+    uint16_t log_id = 0;
+    if ( util::deserialize( payload, size, log_id ) == 0 ) {
+      message = "Invalid log message";
+      return 0;
+    }
+    auto it = entries_.find( log_id );
+    if ( it == entries_.end() ) {
+      message = "Unknown log format " + std::to_string( log_id );
+      return sizeof( uint16_t );
+    }
+    return sizeof( uint16_t ) + it->second.formatter( it->second.format, payload + sizeof( uint16_t ),
+                                                      size - sizeof( uint16_t ), message );
+  }
+
+private:
+  using Formatter = size_t ( * )( const char *, const uint8_t *, size_t, std::string & );
+
+  struct Entry {
+    const char *format;
+    Formatter formatter;
+  };
+
+  template<typename Format>
+  static size_t _format( const char *format, const uint8_t *data, size_t size, std::string &message )
+  {
+    return _format( format, data, size, message,
+                    std::make_index_sequence<std::tuple_size_v<typename Format::Arguments>>{},
+                    static_cast<typename Format::Arguments *>( nullptr ) );
+  }
+
+  template<size_t... Is, typename... Args>
+  static size_t _format( const char *format, const uint8_t *data, size_t size, std::string &message,
+                         std::index_sequence<Is...>, std::tuple<Args...> * )
+  {
+    std::tuple<typename detail::ReceivedLogArgument<Args>::type...> arguments;
+    size_t offset = 0;
+    bool valid = true;
+    (void)data; // Unused if the format has no arguments
+    (void)size;
+    ( ( valid = valid && _decode( data, size, offset, std::get<Is>( arguments ) ) ), ... );
+    if ( !valid ) {
+      message = std::string( "Invalid arguments for log format: " ) + format;
+      return offset;
+    }
+    // Replace each {} with the next argument
+    message.clear();
+    size_t argument = 0;
+    for ( const char *c = format; *c != '\0'; ++c ) {
+      if ( c[0] == '{' && c[1] == '}' && argument < sizeof...( Is ) ) {
+        size_t index = 0;
+        ( ( index++ == argument ? detail::appendLogArgument( message, std::get<Is>( arguments ) )
+                                : void() ),
+          ... );
+        ++argument;
+        ++c;
+        continue;
+      }
+      message += *c;
+    }
+    return offset;
+  }
+
+  template<typename T>
+  static bool _decode( const uint8_t *data, size_t size, size_t &offset, T &value )
+  {
+    size_t consumed = util::deserialize( data + offset, static_cast<int>( size - offset ), value );
+    offset += consumed;
+    return consumed != 0;
+  }
+
+  std::unordered_map<uint16_t, Entry> entries_;
+};
+
+/*!
+ * Reads the current frame as a log message and formats it using the table.
+ * @return ObjectIdMismatch if the current frame is not a log message and ObjectSizeMismatch if the
+ *   format is unknown or the arguments do not match. The message describes the problem in that case.
+ */
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+ReadResult readLog( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                    const LogStringTable &table, std::string &message )
+{
+  if ( crosstalker.hasObject() &&
+       crosstalker.getObjectId() != static_cast<int16_t>( InternalObjectId::Log ) )
+    return ReadResult::ObjectIdMismatch;
+  return crosstalker.readFrame( [&table, &message]( int16_t, const uint8_t *payload, size_t size ) {
+    return table.format( payload, size, message );
+  } );
+}
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_LOG_FORMATTER_HPP
@@ -0,0 +1,228 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef CROSSTALK_HOST_MESSAGE_BUS_HPP
+#define CROSSTALK_HOST_MESSAGE_BUS_HPP
+
+#ifndef CROSSTALK_CROSSTALKER_HPP
+  #error "Include crosstalk.hpp or crosstalk/crosstalker.hpp before including host/message_bus.hpp"
+#endif // CROSSTALK_CROSSTALKER_HPP
+
+#include "object_pool.hpp"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace crosstalk
+{
+
+/*!
+ * Typed publish/subscribe on top of the receive path. Each received object with subscribers is
+ * deserialized once into an object of a per-type ObjectPool and the same const object is passed to
+ * all subscribers, which may keep the handle, e.g., to pass it to another thread.
+ * The bus itself is not thread-safe, subscribe and dispatch from the same thread.
+ * @code
+ * crosstalk::MessageBus bus;
+ * bus.subscribe<CommStatus>( []( const crosstalk::PooledPtr<const CommStatus> &status ) { ... } );
+ * crosstalker.processSerialData();
+ * while ( crosstalker.hasObject() ) {
+ *   if ( bus.dispatch( crosstalker ) == crosstalk::ReadResult::ObjectIdMismatch )
+ *     crosstalker.skipObject(); // No subscribers for this id
+ * }
+ * @endcode
+ */
+class MessageBus
+{
+public:
+  using SubscriptionId = uint64_t;
+
+  template<typename T>
+  using Callback = std::function<void( const PooledPtr<const T> & )>;
+
+  /*!
+   * Subscribes to objects of type T, identified by object_id<T>().
+   * @return The id to unsubscribe or 0 if another type with the same object id was subscribed.
+   */
+  template<typename T>
+  SubscriptionId subscribe( Callback<T> callback )
+  {
+    static_assert( refl::is_reflectable<T>(), "Type must be reflectable." );
+    auto &topic = topics_[object_id<T>()];
+    if ( topic == nullptr )
+      topic = std::make_unique<Topic<T>>();
+    auto *typed = dynamic_cast<Topic<T> *>( topic.get() );
+    if ( typed == nullptr )
+      return 0;
+    const SubscriptionId id = ++last_subscription_id_;
+    typed->subscribers.push_back( std::make_unique<typename Topic<T>::Subscriber>(
+        typename Topic<T>::Subscriber{ id, std::move( callback ) } ) );
+    return id;
+  }
+
+  //! Returns false if there is no subscription with that id.
+  bool unsubscribe( SubscriptionId id )
+  {
+    for ( auto &entry : topics_ ) {
+      if ( entry.second->unsubscribe( id ) )
+        return true;
+    }
+    return false;
+  }
+
+  //! True if there is at least one subscriber for frames with the given id.
+  bool hasSubscribers( int16_t id ) const
+  {
+    auto it = topics_.find( id );
+    return it != topics_.end() && it->second->subscriberCount() > 0;
+  }
+
+  /*!
+   * Called by dispatch before an object is passed to its subscribers if frames with the same id
+   * were lost in front of it or if it is older than a previous object, see
+   * CrossTalker::setSequenceNumbers. Subscribers can then, e.g., interpolate or request a resync.
+   */
+  void setSequenceHandler( std::function<void( const SequenceInfo & )> handler )
+  {
+    sequence_handler_ = std::move( handler );
+  }
+
+  //! Publishes a locally created object to the subscribers of its type.
+  template<typename T>
+  void publish( const T &value )
+  {
+    auto it = topics_.find( object_id<T>() );
+    if ( it == topics_.end() )
+      return;
+    auto *typed = dynamic_cast<Topic<T> *>( it->second.get() );
+    if ( typed == nullptr )
+      return;
+    PooledPtr<T> message = typed->pool.acquire();
+    *message = value;
+    typed->publish( std::move( message ) );
+  }
+
+  /*!
+   * Reads the current object and passes it to the subscribers of its id.
+   * @return ObjectIdMismatch without reading the object if there are no subscribers for its id.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  ReadResult dispatch( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker )
+  {
+    if ( !crosstalker.hasObject() )
+      return ReadResult::NoObjectAvailable;
+    auto it = topics_.find( crosstalker.getObjectId() );
+    if ( it == topics_.end() || it->second->subscriberCount() == 0 )
+      return ReadResult::ObjectIdMismatch;
+    TopicBase &topic = *it->second;
+    ReadResult result = crosstalker.readFrame( [&topic]( int16_t, const uint8_t *payload, size_t size ) {
+      return topic.decode( payload, size );
+    } );
+    if ( result == ReadResult::Success ) {
+      const SequenceInfo &sequence = crosstalker.lastSequence();
+      if ( sequence_handler_ && ( sequence.lost_frames > 0 || sequence.reordered ) )
+        sequence_handler_( sequence );
+      topic.publishDecoded();
+    } else {
+      topic.discardDecoded();
+    }
+    return result;
+  }
+
+private:
+  struct TopicBase {
+    virtual ~TopicBase() = default;
+    virtual size_t decode( const uint8_t *payload, size_t size ) = 0;
+    virtual void publishDecoded() = 0;
+    virtual void discardDecoded() = 0;
+    virtual bool unsubscribe( SubscriptionId id ) = 0;
+    virtual size_t subscriberCount() const = 0;
+  };
+
+  template<typename T>
+  struct Topic : TopicBase {
+    struct Subscriber {
+      SubscriptionId id;
+      Callback<T> callback;
+    };
+
+    size_t decode( const uint8_t *payload, size_t size ) override
+    {
+      decoded = pool.acquire();
+      return util::deserialize( payload, static_cast<int>( size ), *decoded );
+    }
+
+    void publishDecoded() override { publish( std::move( decoded ) ); }
+
+    void discardDecoded() override { decoded.reset(); }
+
+    void publish( PooledPtr<T> message )
+    {
+      const PooledPtr<const T> shared( std::move( message ) );
+      // Callbacks may subscribe, unsubscribe and publish. New subscribers receive the next message
+      // and removed subscribers are only marked until the outermost publish called all callbacks.
+      ++publish_depth;
+      const size_t count = subscribers.size();
+      for ( size_t i = 0; i < count && i < subscribers.size(); ++i ) {
+        if ( subscribers[i]->id != 0 )
+          subscribers[i]->callback( shared );
+      }
+      if ( --publish_depth > 0 )
+        return;
+      subscribers.erase( std::remove_if( subscribers.begin(), subscribers.end(),
+                                         []( const auto &subscriber ) { return subscriber->id == 0; } ),
+                         subscribers.end() );
+    }
+
+    bool unsubscribe( SubscriptionId id ) override
+    {
+      auto it = std::find_if( subscribers.begin(), subscribers.end(),
+                              [id]( const auto &subscriber ) { return subscriber->id == id; } );
+      if ( it == subscribers.end() )
+        return false;
+      if ( publish_depth > 0 )
+        ( *it )->id = 0;
+      else
+        subscribers.erase( it );
+      return true;
+    }
+
+    size_t subscriberCount() const override
+    {
+      return std::count_if( subscribers.begin(), subscribers.end(),
+                            []( const auto &subscriber ) { return subscriber->id != 0; } );
+    }
+
+    ObjectPool<T> pool;
+    PooledPtr<T> decoded;
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    int publish_depth = 0;
+  };
+
+  std::unordered_map<int16_t, std::unique_ptr<TopicBase>> topics_;
+  std::function<void( const SequenceInfo & )> sequence_handler_;
+  SubscriptionId last_subscription_id_ = 0;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_MESSAGE_BUS_HPP
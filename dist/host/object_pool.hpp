@@ -0,0 +1,252 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef CROSSTALK_HOST_OBJECT_POOL_HPP
+#define CROSSTALK_HOST_OBJECT_POOL_HPP
+
+#ifndef CROSSTALK_CROSSTALKER_HPP
+  #error "Include crosstalk.hpp or crosstalk/crosstalker.hpp before including host/object_pool.hpp"
+#endif // CROSSTALK_CROSSTALKER_HPP
+
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace crosstalk
+{
+template<typename T>
+class ObjectPool;
+
+namespace detail
+{
+template<typename T>
+struct PoolState;
+
+template<typename T>
+struct PoolBlock {
+  T value;
+  std::atomic<uint32_t> references{ 0 };
+  PoolState<T> *state = nullptr;
+};
+
+template<typename T>
+struct PoolState {
+  std::mutex mutex;
+  std::vector<PoolBlock<T> *> free;
+  size_t outstanding = 0;
+  bool closed = false;
+
+  void release( PoolBlock<T> *block )
+  {
+    std::unique_lock<std::mutex> lock( mutex );
+    --outstanding;
+    if ( !closed ) {
+      free.push_back( block );
+      return;
+    }
+    // The pool was destroyed while this object was in use
+    delete block;
+    if ( outstanding != 0 )
+      return;
+    lock.unlock();
+    delete this;
+  }
+};
+} // namespace detail
+
+/*!
+ * Reference counted handle to an object of an ObjectPool. Copies share the object, which returns to
+ * the pool when the last handle is released. A PooledPtr<T> converts to a PooledPtr<const T>.
+ * The reference count is atomic, so handles can be passed to and released on other threads.
+ */
+template<typename T>
+class PooledPtr
+{
+  using Value = std::remove_const_t<T>;
+  using Block = detail::PoolBlock<Value>;
+
+public:
+  PooledPtr() = default;
+
+  PooledPtr( const PooledPtr &other ) : block_( other.block_ ) { _retain(); }
+
+  PooledPtr( PooledPtr &&other ) noexcept : block_( std::exchange( other.block_, nullptr ) ) { }
+
+  template<typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_const_v<U>>>
+  PooledPtr( const PooledPtr<U> &other ) : block_( other.block_ )
+  {
+    _retain();
+  }
+
+  template<typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_const_v<U>>>
+  PooledPtr( PooledPtr<U> &&other ) noexcept : block_( std::exchange( other.block_, nullptr ) )
+  {
+  }
+
+  ~PooledPtr() { reset(); }
+
+  PooledPtr &operator=( PooledPtr other ) noexcept
+  {
+    std::swap( block_, other.block_ );
+    return *this;
+  }
+
+  //! Releases this handle. The object returns to its pool if this was the last handle.
+  void reset()
+  {
+    Block *block = std::exchange( block_, nullptr );
+    if ( block != nullptr && block->references.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+      block->state->release( block );
+  }
+
+  T *get() const { return block_ == nullptr ? nullptr : &block_->value; }
+  T &operator*() const { return block_->value; }
+  T *operator->() const { return &block_->value; }
+  explicit operator bool() const { return block_ != nullptr; }
+
+  //! Number of handles sharing the object.
+  uint32_t useCount() const
+  {
+    return block_ == nullptr ? 0 : block_->references.load( std::memory_order_relaxed );
+  }
+
+private:
+  template<typename U>
+  friend class PooledPtr;
+  friend class ObjectPool<Value>;
+
+  explicit PooledPtr( Block *block ) : block_( block ) { }
+
+  void _retain()
+  {
+    if ( block_ != nullptr )
+      block_->references.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  Block *block_ = nullptr;
+};
+
+/*!
+ * Free list of objects of type T. Released objects are not destroyed or reset, so vectors and
+ * strings in them keep their capacity and refilling them, e.g., by deserializing the next message
+ * into them, does not allocate once the capacity is large enough.
+ * Acquiring and releasing is thread-safe. The pool can be destroyed while handles are in use.
+ */
+template<typename T>
+class ObjectPool
+{
+  using Block = detail::PoolBlock<T>;
+
+public:
+  ObjectPool() : state_( new detail::PoolState<T>() ) { }
+
+  ObjectPool( const ObjectPool & ) = delete;
+  ObjectPool &operator=( const ObjectPool & ) = delete;
+
+  ~ObjectPool()
+  {
+    std::unique_lock<std::mutex> lock( state_->mutex );
+    state_->closed = true;
+    for ( Block *block : state_->free ) delete block;
+    state_->free.clear();
+    if ( state_->outstanding != 0 )
+      return; // Deleted when the last handle is released
+    lock.unlock();
+    delete state_;
+  }
+
+  //! Takes an object from the free list or creates one if the free list is empty.
+  PooledPtr<T> acquire()
+  {
+    Block *block = nullptr;
+    {
+      std::lock_guard<std::mutex> lock( state_->mutex );
+      ++state_->outstanding;
+      if ( !state_->free.empty() ) {
+        block = state_->free.back();
+        state_->free.pop_back();
+      }
+    }
+    if ( block == nullptr ) {
+      block = new Block();
+      block->state = state_;
+    }
+    block->references.store( 1, std::memory_order_relaxed );
+    return PooledPtr<T>( block );
+  }
+
+  //! Creates objects until count objects are in the free list.
+  void reserve( size_t count )
+  {
+    std::lock_guard<std::mutex> lock( state_->mutex );
+    while ( state_->free.size() < count ) {
+      Block *block = new Block();
+      block->state = state_;
+      state_->free.push_back( block );
+    }
+  }
+
+  //! Number of objects in the free list.
+  size_t freeCount() const
+  {
+    std::lock_guard<std::mutex> lock( state_->mutex );
+    return state_->free.size();
+  }
+
+  //! Number of objects that are currently in use.
+  size_t inUseCount() const
+  {
+    std::lock_guard<std::mutex> lock( state_->mutex );
+    return state_->outstanding;
+  }
+
+private:
+  detail::PoolState<T> *state_;
+};
+
+/*!
+ * Reads the current object into an object taken from the pool. The previous contents of the pooled
+ * object are overwritten, strings and vectors reuse their capacity, so reading messages of similar
+ * size does not allocate once the pool is warmed up, even if handles are kept across iterations.
+ * Vector elements beyond the new size are destroyed though.
+ * @param obj Set to the handle if successful, unchanged otherwise.
+ */
+template<typename T, int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+ReadResult readObject( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                       ObjectPool<T> &pool, PooledPtr<T> &obj )
+{
+  if ( !crosstalker.hasObject() )
+    return ReadResult::NoObjectAvailable;
+  if ( crosstalker.getObjectId() != object_id<T>() )
+    return ReadResult::ObjectIdMismatch;
+  PooledPtr<T> handle = pool.acquire();
+  const ReadResult result = crosstalker.readObject( *handle );
+  if ( result == ReadResult::Success )
+    obj = std::move( handle );
+  return result;
+}
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_OBJECT_POOL_HPP
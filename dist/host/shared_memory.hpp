@@ -0,0 +1,620 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef CROSSTALK_HOST_SHARED_MEMORY_HPP
+#define CROSSTALK_HOST_SHARED_MEMORY_HPP
+
+#ifndef CROSSTALK_CROSSTALKER_HPP
+  #error "Include crosstalk.hpp or crosstalk/crosstalker.hpp before including host/shared_memory.hpp"
+#endif // CROSSTALK_CROSSTALKER_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crosstalk
+{
+
+struct SharedFrameRingOptions {
+  //! Size of the ring in bytes. Rounded up to a multiple of the page size.
+  size_t capacity = 1 << 20;
+  //! Maximum number of readers that can be attached at the same time.
+  uint32_t max_readers = 8;
+};
+
+namespace detail
+{
+static_assert( std::atomic<uint64_t>::is_always_lock_free && std::atomic<int32_t>::is_always_lock_free,
+               "The shared frame ring requires lock-free atomics to work across processes." );
+
+struct SharedFrameReaderSlot {
+  //! Process id of the attached reader or 0 if the slot is free.
+  std::atomic<int32_t> pid;
+  //! Stream position up to which the reader has read.
+  std::atomic<uint64_t> position;
+  std::atomic<uint64_t> dropped_bytes;
+};
+
+struct SharedFrameRingHeader {
+  static constexpr uint32_t MAGIC = 0x52544358; // "XCTR"
+  static constexpr uint32_t VERSION = 1;
+
+  //! Written last by the broker, readers only attach once it is set.
+  std::atomic<uint32_t> magic;
+  uint32_t version;
+  uint64_t capacity;
+  uint32_t max_readers;
+  std::atomic<uint32_t> closed;
+  //! End of the data the broker is currently writing. Set before the data is written.
+  std::atomic<uint64_t> reserved;
+  //! End of the completely written data. Always at a frame boundary.
+  std::atomic<uint64_t> written;
+  std::atomic<uint64_t> frames;
+
+  SharedFrameReaderSlot *readers() { return reinterpret_cast<SharedFrameReaderSlot *>( this + 1 ); }
+
+  static size_t size( uint32_t max_readers )
+  {
+    return sizeof( SharedFrameRingHeader ) + max_readers * sizeof( SharedFrameReaderSlot );
+  }
+};
+
+/*!
+ * Mapping of a shared frame ring. The data region is mapped twice back to back, so every range of
+ * up to capacity bytes is contiguous in memory, and frames can be written and read in place even if
+ * they wrap around the end of the ring.
+ */
+class SharedFrameRingMapping
+{
+public:
+  SharedFrameRingMapping() = default;
+  ~SharedFrameRingMapping() { unmap(); }
+
+  SharedFrameRingMapping( const SharedFrameRingMapping & ) = delete;
+  SharedFrameRingMapping &operator=( const SharedFrameRingMapping & ) = delete;
+
+  static size_t pageSize() { return static_cast<size_t>( sysconf( _SC_PAGESIZE ) ); }
+
+  static size_t roundToPages( size_t size )
+  {
+    const size_t page_size = pageSize();
+    return ( size + page_size - 1 ) / page_size * page_size;
+  }
+
+  bool map( int fd, size_t header_size, size_t capacity )
+  {
+    unmap();
+    const size_t total = header_size + 2 * capacity;
+    // Reserve the address range first, then replace it with the two mappings of the file
+    void *base = mmap( nullptr, total, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if ( base == MAP_FAILED )
+      return false;
+    auto *bytes = static_cast<uint8_t *>( base );
+    if ( mmap( bytes, header_size + capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) ==
+             MAP_FAILED ||
+         mmap( bytes + header_size + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+               fd, static_cast<off_t>( header_size ) ) == MAP_FAILED ) {
+      munmap( base, total );
+      return false;
+    }
+    base_ = bytes;
+    header_size_ = header_size;
+    capacity_ = capacity;
+    return true;
+  }
+
+  void unmap()
+  {
+    if ( base_ != nullptr )
+      munmap( base_, header_size_ + 2 * capacity_ );
+    base_ = nullptr;
+    header_size_ = 0;
+    capacity_ = 0;
+  }
+
+  bool isMapped() const { return base_ != nullptr; }
+
+  SharedFrameRingHeader *header() const { return reinterpret_cast<SharedFrameRingHeader *>( base_ ); }
+
+  //! Pointer to the byte at the given stream position. The following capacity bytes are contiguous.
+  uint8_t *at( uint64_t position ) const { return base_ + header_size_ + position % capacity_; }
+
+  size_t capacity() const { return capacity_; }
+
+private:
+  uint8_t *base_ = nullptr;
+  size_t header_size_ = 0;
+  size_t capacity_ = 0;
+};
+} // namespace detail
+
+/*!
+ * Owner side of a shared-memory ring that fans out frames received on a serial port to readers in
+ * other processes. Only complete frames with a valid CRC are written, so the ring is always at a
+ * frame boundary after each write.
+ * The broker never waits for readers since it has to keep up with the serial port. A reader that
+ * falls behind by more than the capacity loses the overwritten data and continues at the newest
+ * frame, which is counted in its dropped bytes.
+ */
+class SharedFrameBroker
+{
+public:
+  SharedFrameBroker() = default;
+
+  SharedFrameBroker( const std::string &name, const SharedFrameRingOptions &options = {} )
+  {
+    create( name, options );
+  }
+
+  ~SharedFrameBroker() { close(); }
+
+  SharedFrameBroker( const SharedFrameBroker & ) = delete;
+  SharedFrameBroker &operator=( const SharedFrameBroker & ) = delete;
+
+  /*!
+   * Creates the shared memory object with the given name, e.g., "/crosstalk_ttyACM0".
+   * An existing ring with the same name is replaced. Readers attached to it keep their mapping
+   * but will not receive new frames.
+   * @return False if the shared memory could not be created or mapped.
+   */
+  bool create( const std::string &name, const SharedFrameRingOptions &options = {} )
+  {
+    close();
+    if ( options.max_readers == 0 )
+      return false;
+    const size_t header_size =
+        detail::SharedFrameRingMapping::roundToPages( detail::SharedFrameRingHeader::size( options.max_readers ) );
+    const size_t capacity = detail::SharedFrameRingMapping::roundToPages( std::max<size_t>( options.capacity, 1 ) );
+    shm_unlink( name.c_str() );
+    int fd = shm_open( name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+    if ( fd < 0 )
+      return false;
+    if ( ftruncate( fd, static_cast<off_t>( header_size + capacity ) ) != 0 ||
+         !mapping_.map( fd, header_size, capacity ) ) {
+      ::close( fd );
+      shm_unlink( name.c_str() );
+      return false;
+    }
+    ::close( fd ); // The mapping stays valid
+    name_ = name;
+
+    auto *header = new ( mapping_.header() ) detail::SharedFrameRingHeader();
+    header->version = detail::SharedFrameRingHeader::VERSION;
+    header->capacity = capacity;
+    header->max_readers = options.max_readers;
+    header->closed.store( 0, std::memory_order_relaxed );
+    header->reserved.store( 0, std::memory_order_relaxed );
+    header->written.store( 0, std::memory_order_relaxed );
+    header->frames.store( 0, std::memory_order_relaxed );
+    for ( uint32_t i = 0; i < options.max_readers; ++i ) {
+      auto *slot = new ( &header->readers()[i] ) detail::SharedFrameReaderSlot();
+      slot->pid.store( 0, std::memory_order_relaxed );
+      slot->position.store( 0, std::memory_order_relaxed );
+      slot->dropped_bytes.store( 0, std::memory_order_relaxed );
+    }
+    header->magic.store( detail::SharedFrameRingHeader::MAGIC, std::memory_order_release );
+    return true;
+  }
+
+  //! Marks the ring as closed for attached readers and removes its name.
+  void close()
+  {
+    if ( !mapping_.isMapped() )
+      return;
+    mapping_.header()->closed.store( 1, std::memory_order_release );
+    shm_unlink( name_.c_str() );
+    mapping_.unmap();
+    name_.clear();
+  }
+
+  bool isOpen() const { return mapping_.isMapped(); }
+
+  const std::string &name() const { return name_; }
+
+  size_t capacity() const { return mapping_.capacity(); }
+
+  /*!
+   * Writes a frame built from the id and payload, e.g., from the handler of CrossTalker::readFrame.
+   * If sequence_bytes is 1 or 2, the sequence counter is appended, see CrossTalker::setSequenceNumbers.
+   * @return False if the ring is not open or the frame is larger than the ring.
+   */
+  bool publish( int16_t id, const uint8_t *payload, size_t size, int sequence_bytes = 0, uint16_t sequence = 0 )
+  {
+    const size_t frame_size = 8 + size + sequence_bytes;
+    if ( !mapping_.isMapped() || size > detail::FRAME_SIZE_MASK || sequence_bytes < 0 || sequence_bytes > 2 ||
+         frame_size > mapping_.capacity() )
+      return false;
+    uint8_t *frame = _reserve( frame_size );
+    frame[0] = 0x02;
+    frame[1] = 0x42;
+    const uint16_t le_id = hosttole16( static_cast<uint16_t>( id ) );
+    const uint16_t le_size = hosttole16( static_cast<uint16_t>( size | ( sequence_bytes << 14 ) ) );
+    std::memcpy( frame + 2, &le_id, 2 );
+    std::memcpy( frame + 4, &le_size, 2 );
+    std::memcpy( frame + 6, payload, size );
+    const uint16_t le_sequence = hosttole16( sequence );
+    std::memcpy( frame + 6 + size, &le_sequence, sequence_bytes );
+    const uint16_t crc = hosttole16( util::compute_crc16( frame, 6 + size + sequence_bytes ) );
+    std::memcpy( frame + 6 + size + sequence_bytes, &crc, 2 );
+    _commit( frame_size );
+    return true;
+  }
+
+  /*!
+   * Writes a raw frame including start marker and CRC.
+   * @return False if the data is not exactly one frame with a valid CRC or does not fit the ring.
+   */
+  bool publishFrame( const uint8_t *data, size_t size )
+  {
+    if ( !mapping_.isMapped() || size < 8 || size > mapping_.capacity() || data[0] != 0x02 || data[1] != 0x42 )
+      return false;
+    uint16_t size_field = 0;
+    uint16_t crc = 0;
+    util::deserialize( data + 4, 2, size_field );
+    // The content includes the sequence counter, if any
+    const uint16_t content_size = detail::frameContentSize( size_field );
+    if ( content_size == 0xFFFF || content_size + 8u != size )
+      return false;
+    util::deserialize( data + 6 + content_size, 2, crc );
+    if ( crc != util::compute_crc16( data, 6 + content_size ) )
+      return false;
+    std::memcpy( _reserve( size ), data, size );
+    _commit( size );
+    return true;
+  }
+
+  /*!
+   * Reads the current frame of the crosstalker and writes it to the ring, including its sequence
+   * counter. The frame is consumed, so the port owner should attach its own reader if it also needs it.
+   * @return The result of CrossTalker::readFrame.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  ReadResult forward( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker )
+  {
+    return crosstalker.readFrame( [this, &crosstalker]( int16_t id, const uint8_t *payload, size_t size ) -> size_t {
+      const SequenceInfo &sequence = crosstalker.lastSequence();
+      publish( id, payload, size, sequence.valid ? sequence.sequence_bytes : 0, sequence.sequence );
+      return size;
+    } );
+  }
+
+  //! Number of frames written since the ring was created.
+  uint64_t frameCount() const
+  {
+    return mapping_.isMapped() ? mapping_.header()->frames.load( std::memory_order_relaxed ) : 0;
+  }
+
+  //! Number of currently attached readers.
+  uint32_t readerCount() const
+  {
+    if ( !mapping_.isMapped() )
+      return 0;
+    uint32_t count = 0;
+    detail::SharedFrameRingHeader *header = mapping_.header();
+    for ( uint32_t i = 0; i < header->max_readers; ++i )
+      count += header->readers()[i].pid.load( std::memory_order_relaxed ) != 0 ? 1 : 0;
+    return count;
+  }
+
+  //! The number of written bytes the slowest attached reader has not read yet.
+  uint64_t maxReaderLag() const
+  {
+    if ( !mapping_.isMapped() )
+      return 0;
+    detail::SharedFrameRingHeader *header = mapping_.header();
+    const uint64_t written = header->written.load( std::memory_order_relaxed );
+    uint64_t lag = 0;
+    for ( uint32_t i = 0; i < header->max_readers; ++i ) {
+      const detail::SharedFrameReaderSlot &slot = header->readers()[i];
+      if ( slot.pid.load( std::memory_order_relaxed ) != 0 )
+        lag = std::max( lag, written - std::min( written, slot.position.load( std::memory_order_relaxed ) ) );
+    }
+    return lag;
+  }
+
+private:
+  uint8_t *_reserve( size_t size )
+  {
+    detail::SharedFrameRingHeader *header = mapping_.header();
+    const uint64_t written = header->written.load( std::memory_order_relaxed );
+    // Readers check the reservation after copying to detect data overwritten while they read it
+    header->reserved.store( written + size, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    return mapping_.at( written );
+  }
+
+  void _commit( size_t size )
+  {
+    detail::SharedFrameRingHeader *header = mapping_.header();
+    header->written.store( header->written.load( std::memory_order_relaxed ) + size, std::memory_order_release );
+    header->frames.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  detail::SharedFrameRingMapping mapping_;
+  std::string name_;
+};
+
+/*!
+ * Reader side of a shared frame ring created by a SharedFrameBroker, usually in another process.
+ * Each reader has its own cursor in the shared memory. Frames can be read in place with readFrame()
+ * and readObject() without copying them out of the ring, or as a byte stream with read(), e.g.,
+ * through the SharedMemorySerialWrapper.
+ * A reader must only be used from one thread at a time.
+ */
+class SharedFrameReader
+{
+public:
+  SharedFrameReader() = default;
+
+  explicit SharedFrameReader( const std::string &name ) { attach( name ); }
+
+  ~SharedFrameReader() { detach(); }
+
+  SharedFrameReader( const SharedFrameReader & ) = delete;
+  SharedFrameReader &operator=( const SharedFrameReader & ) = delete;
+
+  /*!
+   * Attaches to the ring with the given name and starts reading at the newest frame.
+   * Slots of readers whose process no longer exists are reclaimed.
+   * @return False if the ring does not exist (yet) or all reader slots are in use.
+   */
+  bool attach( const std::string &name )
+  {
+    detach();
+    int fd = shm_open( name.c_str(), O_RDWR, 0 );
+    if ( fd < 0 )
+      return false;
+    struct stat st {};
+    detail::SharedFrameRingHeader *header = nullptr;
+    // Map only the header first to learn the layout
+    const size_t page_size = detail::SharedFrameRingMapping::pageSize();
+    if ( fstat( fd, &st ) != 0 || static_cast<size_t>( st.st_size ) < page_size ) {
+      ::close( fd );
+      return false;
+    }
+    void *first_page = mmap( nullptr, page_size, PROT_READ, MAP_SHARED, fd, 0 );
+    if ( first_page == MAP_FAILED ) {
+      ::close( fd );
+      return false;
+    }
+    header = static_cast<detail::SharedFrameRingHeader *>( first_page );
+    const bool valid = header->magic.load( std::memory_order_acquire ) == detail::SharedFrameRingHeader::MAGIC &&
+                       header->version == detail::SharedFrameRingHeader::VERSION;
+    const size_t capacity = valid ? header->capacity : 0;
+    const size_t header_size =
+        valid ? detail::SharedFrameRingMapping::roundToPages( detail::SharedFrameRingHeader::size( header->max_readers ) )
+              : 0;
+    munmap( first_page, page_size );
+    if ( !valid || static_cast<size_t>( st.st_size ) != header_size + capacity ||
+         !mapping_.map( fd, header_size, capacity ) ) {
+      ::close( fd );
+      return false;
+    }
+    ::close( fd );
+
+    header = mapping_.header();
+    const int32_t pid = static_cast<int32_t>( getpid() );
+    for ( int pass = 0; pass < 2 && slot_ == nullptr; ++pass ) {
+      for ( uint32_t i = 0; i < header->max_readers; ++i ) {
+        detail::SharedFrameReaderSlot &slot = header->readers()[i];
+        int32_t owner = slot.pid.load( std::memory_order_relaxed );
+        // In the second pass, take over slots of readers that exited without detaching
+        if ( owner != 0 && ( pass == 0 || kill( owner, 0 ) == 0 || errno != ESRCH ) )
+          continue;
+        if ( slot.pid.compare_exchange_strong( owner, pid ) ) {
+          slot_ = &slot;
+          break;
+        }
+      }
+    }
+    if ( slot_ == nullptr ) {
+      mapping_.unmap();
+      return false;
+    }
+    position_ = header->written.load( std::memory_order_acquire );
+    slot_->dropped_bytes.store( 0, std::memory_order_relaxed );
+    slot_->position.store( position_, std::memory_order_release );
+    return true;
+  }
+
+  void detach()
+  {
+    if ( slot_ != nullptr )
+      slot_->pid.store( 0, std::memory_order_release );
+    slot_ = nullptr;
+    mapping_.unmap();
+  }
+
+  bool isAttached() const { return slot_ != nullptr; }
+
+  //! True if the broker closed the ring. Frames written before can still be read.
+  bool isClosed() const
+  {
+    return slot_ != nullptr && mapping_.header()->closed.load( std::memory_order_acquire ) != 0;
+  }
+
+  //! Number of bytes written by the broker that this reader has not read yet.
+  size_t available() const
+  {
+    if ( slot_ == nullptr )
+      return 0;
+    const uint64_t written = mapping_.header()->written.load( std::memory_order_acquire );
+    return std::min<uint64_t>( written - position_, mapping_.capacity() );
+  }
+
+  //! True if a complete frame is available.
+  bool hasObject() const { return available() != 0; }
+
+  /*!
+   * Id of the next frame. Only valid if hasObject() is true.
+   * The frame may be overwritten if the reader lags behind, which is detected when reading it.
+   */
+  int16_t getObjectId() const
+  {
+    int16_t id = 0;
+    util::deserialize( mapping_.at( position_ ) + 2, 2, id );
+    return id;
+  }
+
+  /*!
+   * Copies up to length bytes of the stream of frames.
+   * @return The number of bytes copied. 0 if nothing is available or the reader lagged behind by
+   *   more than the capacity, in which case it continues at the newest frame.
+   */
+  size_t read( uint8_t *data, size_t length )
+  {
+    const size_t count = std::min( length, available() );
+    if ( count == 0 )
+      return 0;
+    std::memcpy( data, mapping_.at( position_ ), count );
+    if ( _wasOverwritten() ) {
+      _resync();
+      return 0;
+    }
+    _advance( count );
+    return count;
+  }
+
+  /*!
+   * Passes the next frame to the handler directly from the shared memory.
+   * @param handler Called as handler( int16_t id, const uint8_t *payload, size_t size ) and has to
+   *   return the number of payload bytes it consumed.
+   * @return NoObjectAvailable if there is no new frame. CrcError if the frame was overwritten by
+   *   the broker before or while it was read, in which case the reader continues at the newest frame.
+   */
+  template<typename Handler>
+  ReadResult readFrame( Handler &&handler )
+  {
+    if ( available() < 8 )
+      return ReadResult::NoObjectAvailable;
+    const uint8_t *frame = mapping_.at( position_ );
+    uint16_t size_field = 0;
+    util::deserialize( frame + 4, 2, size_field );
+    // The sequence counter, if any, is between the payload and the CRC
+    const size_t content_size = detail::frameContentSize( size_field );
+    const size_t payload_size = content_size - detail::frameSequenceBytes( size_field );
+    uint16_t crc = 0;
+    if ( content_size + 8u <= available() )
+      util::deserialize( frame + 6 + content_size, 2, crc );
+    if ( content_size + 8u > available() || crc != util::compute_crc16( frame, 6 + content_size ) ||
+         _wasOverwritten() ) {
+      _resync();
+      return ReadResult::CrcError;
+    }
+    int16_t id = 0;
+    util::deserialize( frame + 2, 2, id );
+    const size_t consumed = handler( id, frame + 6, payload_size );
+    if ( _wasOverwritten() ) {
+      _resync();
+      return ReadResult::CrcError;
+    }
+    _advance( 8 + content_size );
+    return consumed != payload_size ? ReadResult::ObjectSizeMismatch : ReadResult::Success;
+  }
+
+  //! Deserializes the next frame if it is a T. Other frames are left for readFrame or skipObject.
+  template<typename T>
+  ReadResult readObject( T &obj )
+  {
+    if ( !hasObject() )
+      return ReadResult::NoObjectAvailable;
+    if ( getObjectId() != object_id<T>() )
+      return ReadResult::ObjectIdMismatch;
+    return readFrame( [&obj]( int16_t, const uint8_t *payload, size_t size ) -> size_t {
+      return util::deserialize( payload, size, obj );
+    } );
+  }
+
+  ReadResult skipObject()
+  {
+    return readFrame( []( int16_t, const uint8_t *, size_t size ) { return size; } );
+  }
+
+  //! Bytes this reader lost because it fell behind the broker by more than the capacity.
+  uint64_t droppedBytes() const
+  {
+    return slot_ != nullptr ? slot_->dropped_bytes.load( std::memory_order_relaxed ) : 0;
+  }
+
+private:
+  bool _wasOverwritten() const
+  {
+    // Pairs with the fence in SharedFrameBroker::_reserve, so the reservation seen here covers
+    // every write that could have modified the data read before
+    std::atomic_thread_fence( std::memory_order_acquire );
+    return mapping_.header()->reserved.load( std::memory_order_relaxed ) > position_ + mapping_.capacity();
+  }
+
+  void _resync()
+  {
+    const uint64_t written = mapping_.header()->written.load( std::memory_order_acquire );
+    slot_->dropped_bytes.fetch_add( written - position_, std::memory_order_relaxed );
+    position_ = written;
+    slot_->position.store( position_, std::memory_order_release );
+  }
+
+  void _advance( size_t count )
+  {
+    position_ += count;
+    slot_->position.store( position_, std::memory_order_release );
+  }
+
+  detail::SharedFrameRingMapping mapping_;
+  detail::SharedFrameReaderSlot *slot_ = nullptr;
+  uint64_t position_ = 0;
+};
+
+/*!
+ * Serial abstraction that reads the frames of a shared frame ring as a byte stream, so a
+ * CrossTalker in another process can receive the frames of a serial port owned by a
+ * SharedFrameBroker. The ring only carries frames from the port, hence, writes fail.
+ */
+class SharedMemorySerialWrapper : public crosstalk::SerialAbstraction
+{
+public:
+  explicit SharedMemorySerialWrapper( const std::string &name ) : reader_( name ) { }
+
+  int available() const override
+  {
+    return static_cast<int>( std::min<size_t>( reader_.available(), INT_MAX ) );
+  }
+
+  int read( uint8_t *data, size_t length ) override { return static_cast<int>( reader_.read( data, length ) ); }
+
+  bool write( const uint8_t *, size_t ) override { return false; }
+
+  SharedFrameReader &reader() { return reader_; }
+
+private:
+  SharedFrameReader reader_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_SHARED_MEMORY_HPP
@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_FD_SERIAL_WRAPPER_HPP
+#define CROSSTALK_FD_SERIAL_WRAPPER_HPP
+
+#ifndef CROSSTALK_SERIAL_ABSTRACTION_HPP
+  #error "Include crosstalk.hpp or crosstalk/serial_abstraction.hpp before including crosstalk_fd_serial_wrapper.hpp"
+#endif // CROSSTALK_SERIAL_ABSTRACTION_HPP
+
+#include <cerrno>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace crosstalk
+{
+/*!
+ * Serial abstraction for POSIX file descriptors, e.g., a tty opened with open() or a pty.
+ * The file descriptor is not owned and has to be closed by the caller.
+ */
+class FileDescriptorSerialWrapper : public crosstalk::SerialAbstraction
+{
+public:
+  explicit FileDescriptorSerialWrapper( int fd ) : fd_( fd ) { }
+
+  int available() const override
+  {
+    int count = 0;
+    if ( ioctl( fd_, FIONREAD, &count ) != 0 )
+      return 0;
+    return count;
+  }
+
+  int read( uint8_t *data, size_t length ) override
+  {
+    ssize_t count;
+    do {
+      count = ::read( fd_, data, length );
+    } while ( count < 0 && errno == EINTR );
+    return count < 0 ? 0 : static_cast<int>( count );
+  }
+
+  //! Writes all data. Partial writes would corrupt objects, hence, this waits until the fd is writable.
+  bool write( const uint8_t *data, size_t length ) override
+  {
+    while ( length > 0 ) {
+      ssize_t count = ::write( fd_, data, length );
+      if ( count < 0 ) {
+        if ( errno == EINTR )
+          continue;
+        if ( errno != EAGAIN && errno != EWOULDBLOCK )
+          return false;
+        pollfd pfd = { fd_, POLLOUT, 0 };
+        if ( poll( &pfd, 1, -1 ) < 0 && errno != EINTR )
+          return false;
+        continue;
+      }
+      data += count;
+      length -= count;
+    }
+    return true;
+  }
+
+  int fd() const { return fd_; }
+
+private:
+  int fd_;
+};
+
+//! Puts the tty into raw mode (no echo, no line editing, no character translation).
+inline bool makeRawTty( int fd )
+{
+  termios tio{};
+  if ( tcgetattr( fd, &tio ) != 0 )
+    return false;
+  cfmakeraw( &tio );
+  return tcsetattr( fd, TCSANOW, &tio ) == 0;
+}
+} // namespace crosstalk
+
+#endif // CROSSTALK_FD_SERIAL_WRAPPER_HPP
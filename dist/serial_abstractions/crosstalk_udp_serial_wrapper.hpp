@@ -0,0 +1,161 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef CROSSTALK_UDP_SERIAL_WRAPPER_HPP
+#define CROSSTALK_UDP_SERIAL_WRAPPER_HPP
+
+#ifndef CROSSTALK_SERIAL_ABSTRACTION_HPP
+  #error "Include crosstalk.hpp or crosstalk/serial_abstraction.hpp before including crosstalk_udp_serial_wrapper.hpp"
+#endif // CROSSTALK_SERIAL_ABSTRACTION_HPP
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace crosstalk
+{
+/*!
+ * Packet transport over UDP, e.g., to a local simulator. Each datagram holds one or more frames
+ * without start markers, packed by the CrossTalker up to max_packet_size if packet batching is
+ * enabled. Only datagrams from the remote address are received. Lost datagrams are not detected.
+ */
+class UdpSerialWrapper : public crosstalk::SerialAbstraction
+{
+public:
+  /*!
+   * @param remote_address IPv4 address of the peer, e.g., "127.0.0.1".
+   * @param local_port Port to bind to, 0 picks a free port (see localPort()).
+   * @param max_packet_size Largest datagram that is sent. The default fits an Ethernet MTU.
+   */
+  UdpSerialWrapper( const char *remote_address, uint16_t remote_port, uint16_t local_port = 0,
+                    size_t max_packet_size = 1472 )
+      : max_packet_size_( max_packet_size )
+  {
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons( local_port );
+    local.sin_addr.s_addr = htonl( INADDR_ANY );
+    sockaddr_in remote{};
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons( remote_port );
+    fd_ = socket( AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0 );
+    if ( fd_ < 0 )
+      return;
+    if ( inet_pton( AF_INET, remote_address, &remote.sin_addr ) != 1 ||
+         bind( fd_, reinterpret_cast<const sockaddr *>( &local ), sizeof( local ) ) != 0 ||
+         // Connecting filters datagrams from other addresses and sets the destination for send
+         ( remote_port != 0 &&
+           ::connect( fd_, reinterpret_cast<const sockaddr *>( &remote ), sizeof( remote ) ) != 0 ) ) {
+      ::close( fd_ );
+      fd_ = -1;
+    }
+  }
+
+  ~UdpSerialWrapper() override
+  {
+    if ( fd_ >= 0 )
+      ::close( fd_ );
+  }
+
+  UdpSerialWrapper( const UdpSerialWrapper & ) = delete;
+  UdpSerialWrapper &operator=( const UdpSerialWrapper & ) = delete;
+
+  bool isOpen() const { return fd_ >= 0; }
+
+  //! Connects to the peer if the remote port was not known on construction.
+  bool connect( const char *remote_address, uint16_t remote_port )
+  {
+    sockaddr_in remote{};
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons( remote_port );
+    return fd_ >= 0 && inet_pton( AF_INET, remote_address, &remote.sin_addr ) == 1 &&
+           ::connect( fd_, reinterpret_cast<const sockaddr *>( &remote ), sizeof( remote ) ) == 0;
+  }
+
+  uint16_t localPort() const
+  {
+    sockaddr_in local{};
+    socklen_t length = sizeof( local );
+    if ( fd_ < 0 || getsockname( fd_, reinterpret_cast<sockaddr *>( &local ), &length ) != 0 )
+      return 0;
+    return ntohs( local.sin_port );
+  }
+
+  //! Size of the next non-empty datagram. Empty datagrams are discarded.
+  int available() const override
+  {
+    uint8_t byte;
+    while ( true ) {
+      ssize_t size = recv( fd_, &byte, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT );
+      if ( size < 0 && errno == EINTR )
+        continue;
+      if ( size != 0 )
+        return size < 0 ? 0 : static_cast<int>( size );
+      // Without a datagram, recv fails with EAGAIN, so an empty datagram is queued. It would
+      // block the datagrams behind it since a size of 0 means that nothing is available.
+      recv( fd_, &byte, 0, MSG_DONTWAIT );
+    }
+  }
+
+  int read( uint8_t *data, size_t length ) override
+  {
+    int size = receivePacket( data, length );
+    return size < 0 ? 0 : size;
+  }
+
+  //! Sends the data as one datagram.
+  bool write( const uint8_t *data, size_t length ) override
+  {
+    ssize_t count;
+    do {
+      count = send( fd_, data, length, 0 );
+    } while ( count < 0 && errno == EINTR );
+    return count == static_cast<ssize_t>( length );
+  }
+
+  bool isPacketTransport() const override { return true; }
+
+  size_t maxPacketSize() const override { return max_packet_size_; }
+
+  int receivePacket( uint8_t *data, size_t length ) override
+  {
+    ssize_t count;
+    do {
+      count = recv( fd_, data, length, MSG_DONTWAIT | MSG_TRUNC );
+    } while ( count < 0 && errno == EINTR );
+    if ( count < 0 )
+      return 0;
+    return static_cast<size_t>( count ) > length ? -1 : static_cast<int>( count );
+  }
+
+  int fd() const { return fd_; }
+
+private:
+  int fd_ = -1;
+  size_t max_packet_size_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_UDP_SERIAL_WRAPPER_HPP
@@ -26,7 +26,9 @@
 #include "endian.hpp"
 #include "refl.hpp"
 #include "serial_abstraction.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <stddef.h>
 #include <vector>
 
@@ -44,6 +46,62 @@ struct id : public refl::attr::usage::type {
   explicit constexpr id( const int16_t id ) noexcept : id_value( id ) { }
 };
 
+/*!
+ * Ids of the frames used internally. Negative ids are reserved for these, except for -1 which
+ * getObjectId() returns if there is no object.
+ */
+enum class InternalObjectId : int16_t {
+  //! Deferred-format log message, see log.hpp.
+  Log = -2,
+  //! Flow control credit report, see flow_control.hpp.
+  Credit = -3,
+  //! Frame of the reliable channel, see reliable.hpp.
+  Reliable = -4,
+  //! Acknowledgement of the reliable channel.
+  ReliableAck = -5,
+  //! Remote procedure call, see rpc.hpp.
+  RpcRequest = -6,
+  //! Response to a remote procedure call.
+  RpcResponse = -7,
+};
+
+/*!
+ * Per-id sequence counter appended to the payload of sent frames, see
+ * CrossTalker::setSequenceNumbers. The two high bits of the size field of a frame contain the
+ * number of counter bytes between the payload and the CRC, so payloads are limited to 16383 bytes.
+ */
+enum class SequenceNumbers : uint8_t { None = 0, OneByte = 1, TwoBytes = 2 };
+
+inline std::string to_string( SequenceNumbers sequence_numbers )
+{
+  switch ( sequence_numbers ) {
+  case SequenceNumbers::None:
+    return "None";
+  case SequenceNumbers::OneByte:
+    return "OneByte";
+  case SequenceNumbers::TwoBytes:
+    return "TwoBytes";
+  }
+  return "UnknownSequenceNumbers";
+}
+
+namespace detail
+{
+//! Mask of the payload size in the size field of a frame.
+constexpr uint16_t FRAME_SIZE_MASK = 0x3FFF;
+
+//! Number of sequence counter bytes behind the payload of a frame with the given size field.
+constexpr int frameSequenceBytes( uint16_t size_field ) { return size_field >> 14; }
+
+//! Number of bytes between the header and the CRC or 0xFFFF if the size field is invalid.
+constexpr uint16_t frameContentSize( uint16_t size_field )
+{
+  return frameSequenceBytes( size_field ) == 3
+             ? 0xFFFF
+             : static_cast<uint16_t>( ( size_field & FRAME_SIZE_MASK ) + frameSequenceBytes( size_field ) );
+}
+} // namespace detail
+
 template<typename T>
 constexpr int16_t object_id() noexcept
 {
@@ -57,6 +115,7 @@ enum class ReadResult : uint8_t {
   CrcError = 3,
   ObjectIdMismatch = 4,
   ObjectSizeMismatch = 5, // This is usually when types without clear size are used like int or long
+  ObjectTooLarge = 6,     // The object can not fit into the buffers, usually due to a corrupted header
 };
 
 inline std::string to_string( ReadResult result )
@@ -74,11 +133,13 @@ inline std::string to_string( ReadResult result )
     return "ObjectIdMismatch";
   case ReadResult::ObjectSizeMismatch:
     return "ObjectSizeMismatch";
+  case ReadResult::ObjectTooLarge:
+    return "ObjectTooLarge";
   }
   return "UnknownReadResult";
 }
 
-enum class WriteResult : uint8_t { Success = 0, ObjectTooLarge = 1, WriteError = 2 };
+enum class WriteResult : uint8_t { Success = 0, ObjectTooLarge = 1, WriteError = 2, NoCredit = 3, WindowFull = 4 };
 
 inline std::string to_string( WriteResult result )
 {
@@ -89,15 +150,102 @@ inline std::string to_string( WriteResult result )
     return "ObjectTooLarge";
   case WriteResult::WriteError:
     return "WriteError";
+  case WriteResult::NoCredit:
+    return "NoCredit";
+  case WriteResult::WindowFull:
+    return "WindowFull";
   }
   return "UnknownWriteResult";
 }
 
-template<int BUFFER_SIZE = 512, int SERIALIZATION_BUFFER_SIZE = BUFFER_SIZE / 2>
+//! What is dropped when more data is received than the receive buffer can hold.
+enum class OverflowPolicy : uint8_t {
+  //! Drop the oldest bytes. This may cut frames which then fail the CRC check.
+  DropOldestBytes = 0,
+  //! Drop generic data first, then the oldest whole frames.
+  DropGenericFirst = 1,
+  //! Drop the oldest frames and generic data at frame boundaries.
+  DropOldestFrames = 2,
+  //! Drop frames for which a newer frame with the same id is buffered first, then generic data, then the oldest frames.
+  KeepNewestPerId = 3,
+};
+
+inline std::string to_string( OverflowPolicy policy )
+{
+  switch ( policy ) {
+  case OverflowPolicy::DropOldestBytes:
+    return "DropOldestBytes";
+  case OverflowPolicy::DropGenericFirst:
+    return "DropGenericFirst";
+  case OverflowPolicy::DropOldestFrames:
+    return "DropOldestFrames";
+  case OverflowPolicy::KeepNewestPerId:
+    return "KeepNewestPerId";
+  }
+  return "UnknownOverflowPolicy";
+}
+
+//! Counters of the receive path.
+struct ReceiveStatistics {
+  //! Generic data and partial frames dropped due to buffer overflows.
+  uint32_t dropped_bytes = 0;
+  //! Whole frames dropped due to buffer overflows or invalid packets of a packet transport.
+  uint32_t dropped_frames = 0;
+  //! Superseded frames skipped by catchUp.
+  uint32_t skipped_frames = 0;
+  /*!
+   * Frames missing according to the sequence counters of read frames, see setSequenceNumbers.
+   * Includes frames dropped due to overflows and skipped by catchUp.
+   */
+  uint32_t lost_frames = 0;
+  //! Read frames with a sequence counter older than that of a previously read frame with the same id.
+  uint32_t reordered_frames = 0;
+};
+
+//! Sequence counter of the last frame that was read from the receive buffer.
+struct SequenceInfo {
+  //! False if the frame had no sequence counter.
+  bool valid = false;
+  int16_t id = -1;
+  uint16_t sequence = 0;
+  //! Size of the counter in the frame, see SequenceNumbers.
+  uint8_t sequence_bytes = 0;
+  //! Frames with the same id that were missing in front of this frame.
+  uint16_t lost_frames = 0;
+  //! True if the frame is older than a previously read frame with the same id.
+  bool reordered = false;
+};
+
+//! A contiguous range of bytes in the serial buffer.
+struct ByteSpan {
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+};
+
+//! The generic (non-object) data in the serial buffer, split in two spans if it wraps around.
+struct GenericData {
+  ByteSpan first;
+  ByteSpan second;
+
+  size_t size() const { return first.size + second.size; }
+};
+
+/*!
+ * @tparam BUFFER_SIZE Size of the receive ring buffer.
+ * @tparam SERIALIZATION_BUFFER_SIZE Size of the buffer used to serialize objects and to copy
+ *   received objects that wrap around the end of the ring buffer.
+ * @tparam TEXT_BUFFER_SIZE If greater than 0, received data is demultiplexed when it is read from
+ *   the serial connection. Frames are queued in the receive buffer and generic data is stored in a
+ *   separate ring of this size, so unread generic data does not block objects and vice versa.
+ */
+template<int BUFFER_SIZE = 512, int SERIALIZATION_BUFFER_SIZE = BUFFER_SIZE / 2, int TEXT_BUFFER_SIZE = 0>
 class CrossTalker final
 {
+  static_assert( TEXT_BUFFER_SIZE >= 0, "TEXT_BUFFER_SIZE must not be negative." );
+
 public:
-  explicit CrossTalker( std::unique_ptr<SerialAbstraction> serial ) : serial_( std::move( serial ) )
+  explicit CrossTalker( std::unique_ptr<SerialAbstraction> serial )
+      : serial_( std::move( serial ) ), packet_transport_( serial_->isPacketTransport() )
   {
   }
 
@@ -116,11 +264,54 @@ public:
   //! Returns the id of the available object or -1 if no object.
   int16_t getObjectId() const;
 
+  /*!
+   * Sets what is dropped if the receive buffer overflows in processSerialData( true ).
+   * If demultiplexing is enabled, the receive buffer only contains frames and DropOldestBytes and
+   * DropGenericFirst behave like DropOldestFrames.
+   */
+  void setOverflowPolicy( OverflowPolicy policy ) { overflow_policy_ = policy; }
+
+  OverflowPolicy overflowPolicy() const { return overflow_policy_; }
+
+  const ReceiveStatistics &statistics() const { return statistics_; }
+
+  void resetStatistics() { statistics_ = {}; }
+
+  /*!
+   * Total number of bytes received from the serial connection including re-added start markers of
+   * packet transports. Wraps around and is not reset by resetStatistics, see flow_control.hpp.
+   */
+  uint32_t receivedBytes() const { return received_bytes_; }
+
+  //! Number of bytes that can be received without dropping buffered data.
+  int freeSpace() const { return BUFFER_SIZE - buffer_size_; }
+
+  /*!
+   * Catch-up mode for a receiver that fell behind. While more than threshold bytes are buffered or
+   * waiting on the serial connection, reads them without overwriting and skips every frame of the
+   * Conflatable types that is superseded by a newer frame with the same id. Only the frame headers
+   * are parsed, skipped frames are neither CRC checked nor deserialized. Other frames and generic
+   * data are kept in order. Stops early if the buffer is full and contains no superseded frames.
+   * @code
+   * crosstalker.catchUp<CommStatus>();
+   * while ( crosstalker.hasObject() ) ...
+   * @endcode
+   * @return The number of skipped frames.
+   */
+  template<typename... Conflatable>
+  size_t catchUp( int threshold = BUFFER_SIZE / 2 );
+
   //! Clear the internal serial buffer.
   void clearBuffer()
   {
     buffer_index_ = 0;
     buffer_size_ = 0;
+    text_index_ = 0;
+    text_size_ = 0;
+    frame_received_ = 0;
+    frame_length_ = 0;
+    pending_marker_ = false;
+    partial_line_.clear();
   }
 
   //! Read non-object data from the serial buffer.
@@ -129,6 +320,33 @@ public:
   //! Skip non-object data in the serial buffer. Only skips until the next object start marker.
   size_t skip( size_t length = BUFFER_SIZE );
 
+  /*!
+   * Returns views of the generic data that is available without removing it from the buffer.
+   * The views are valid until the buffer is modified, e.g., by processSerialData or consumeGeneric.
+   */
+  GenericData peekGeneric() const;
+
+  /*!
+   * Removes up to length bytes of generic data, e.g., after processing the data from peekGeneric.
+   * Unlike skip, this does not read new data from the serial connection.
+   * @return The number of removed bytes.
+   */
+  size_t consumeGeneric( size_t length );
+
+  /*!
+   * Calls callback( const char *line, size_t length ) for each complete line of non-object data
+   * without the line ending. Lines that are contiguous in the buffer are passed without copying.
+   * Text in front of an object or filling the whole buffer without a line ending is kept as a
+   * partial line and continued by the text after the object. Partial lines longer than BUFFER_SIZE
+   * are passed as a line.
+   * @return The number of lines.
+   */
+  template<typename Callback>
+  size_t forEachLine( Callback &&callback );
+
+  //! Reads the next complete line without the line ending. Returns false if there is none.
+  bool readLine( std::string &line );
+
   /*!
    * Reads the object from the serial buffer.
    * @return True if successful, false if object is not complete or CRC check fails.
@@ -143,26 +361,201 @@ public:
   template<typename T>
   WriteResult sendObject( const T &obj );
 
+  /*!
+   * Reads the current frame without knowing its type, e.g., for internal frames.
+   * @param handler Called as handler( int16_t id, const uint8_t *payload, size_t size ) if the CRC
+   *   is valid and has to return the number of payload bytes it consumed.
+   * @return ObjectSizeMismatch if the handler did not consume the whole payload.
+   */
+  template<typename Handler>
+  ReadResult readFrame( Handler &&handler );
+
+  /*!
+   * Finds the first complete frame with a valid CRC anywhere in the buffered data, passes it to the
+   * handler as in readFrame and removes it from the buffer. The generic data and frames around it
+   * are left untouched, so frames can be read without consuming the generic data in front of them.
+   * @return NoObjectAvailable if no complete and valid frame is buffered.
+   */
+  template<typename Handler>
+  ReadResult extractFrame( Handler &&handler );
+
+  /*!
+   * Like extractFrame but finds the first complete and valid frame of type T and deserializes it.
+   * Frames of other types are left in the buffer.
+   */
+  template<typename T>
+  ReadResult extractObject( T &obj );
+
+  /*!
+   * Sends a frame with the given id.
+   * @param serialize Called as serialize( uint8_t *payload ) and has to write exactly payload_size
+   *   bytes.
+   */
+  template<typename Serializer>
+  WriteResult sendFrame( int16_t id, size_t payload_size, Serializer &&serialize );
+
+  /*!
+   * If enabled and the serial abstraction is a packet transport, frames are packed into one packet
+   * up to the maximum packet size of the transport instead of sending a packet per frame.
+   * Packed frames are sent once the next frame does not fit, on flushPackets() and before data is
+   * received, e.g., in processSerialData, so frames sent in one loop iteration share packets.
+   * If a packet can not be sent before data is received, its frames are lost and the failure is
+   * reported by the next sendFrame, which returns WriteError without sending its frame, or the next
+   * flushPackets().
+   */
+  void setPacketBatching( bool enabled ) { packet_batching_ = enabled; }
+
+  bool packetBatching() const { return packet_batching_; }
+
+  /*!
+   * Sends the frames packed for the next packet.
+   * Returns false if sending the packet failed or a packet could not be sent before receiving.
+   */
+  bool flushPackets()
+  {
+    const bool success = _flushPacket() && !packet_failed_;
+    packet_failed_ = false;
+    return success;
+  }
+
+  /*!
+   * If enabled, a counter per id is appended to every sent frame with an id >= 0, so the receiver
+   * can detect lost and reordered frames. The receiver detects the counters automatically, they
+   * are tracked for up to MAX_SEQUENCED_IDS ids on both sides. If the counter size of an id
+   * changes, the receiver resynchronizes on the next frame without reporting a gap.
+   */
+  void setSequenceNumbers( SequenceNumbers sequence_numbers ) { sequence_numbers_ = sequence_numbers; }
+
+  SequenceNumbers sequenceNumbers() const { return sequence_numbers_; }
+
+  /*!
+   * Size of a frame with the given id and payload size sent by sendFrame, including the start
+   * marker and the sequence counter if one is appended. This is what the receiver counts in
+   * receivedBytes, see flow_control.hpp.
+   */
+  size_t frameSize( int16_t id, size_t payload_size ) const;
+
+  /*!
+   * The sequence counter of the last frame read with readFrame, readObject, extractFrame or
+   * extractObject. Gaps and reorders are also counted in the statistics.
+   */
+  const SequenceInfo &lastSequence() const { return last_sequence_; }
+
+  static constexpr int MAX_SEQUENCED_IDS = 16;
+
 private:
   void _processSerialData( int max_to_read = BUFFER_SIZE );
 
   void _processSerialDataUntil( int index );
 
+  //! Returns the number of bytes between header and CRC of the frame starting at start_index.
   uint16_t _readObjectSize( int start_index ) const;
 
+  uint16_t _readSizeField( int start_index ) const;
+
   int _findNextObjectIndex( int start, int end ) const;
 
   void _markRead( int count );
 
+  enum class ItemType : uint8_t { Generic, Frame, IncompleteFrame };
+
+  //! Type and length of the generic data or frame starting offset bytes after buffer_index_.
+  ItemType _itemAt( int offset, int &length ) const;
+
+  int16_t _readFrameId( int start_index ) const;
+
+  //! Removes length bytes starting offset bytes after buffer_index_ from the receive buffer.
+  void _erase( int offset, int length );
+
+  //! Drops buffered data according to the overflow policy until at least count bytes are free.
+  void _makeRoom( int count );
+
+  /*!
+   * Drops complete frames that are superseded by a newer complete frame with the same id, oldest
+   * first, until at least count bytes were freed. If ids is not null, only frames with one of the
+   * id_count ids are dropped.
+   * @return The number of dropped frames.
+   */
+  int _dropSupersededFrames( int count, const int16_t *ids, int id_count, int &freed );
+
+  template<typename Callback>
+  bool _nextLine( Callback &&callback );
+
+  void _appendPartialLine( int count );
+
+  template<typename Handler>
+  ReadResult _extractFrame( bool match_id, int16_t id, Handler &&handler );
+
+  void _demultiplexSerialData( bool overwrite_buffer );
+
+  void _demultiplex( const uint8_t *data, int count );
+
+  void _pushFrameBytes( const uint8_t *data, int count );
+
+  void _pushText( const uint8_t *data, int count );
+
+  //! Receives packets of a packet transport as long as their frames fit into max_to_read bytes.
+  void _receivePackets( int max_to_read );
+
+  //! Adds the start markers to the frames of a packet and pushes them into the receive buffer.
+  void _pushPacketFrames( const uint8_t *packet, int size );
+
+  //! Writes a frame including start marker, sequence counter and CRC to data.
+  template<typename Serializer>
+  static void _writeFrame( uint8_t *data, int16_t id, size_t payload_size, Serializer &&serialize,
+                           int sequence_bytes = 0, uint16_t sequence = 0 );
+
+  //! Sends the packed frames in obj_buffer_ as one packet.
+  bool _flushPacket();
+
+  struct SequenceCounter {
+    int16_t id = -1; // Unused if negative
+    uint16_t next = 0;
+    uint8_t bytes = 0; // Counter size of the last frame, only used for received counters
+  };
+
+  //! Finds or adds the counter of the id. Returns nullptr if the table is full.
+  static SequenceCounter *_sequenceCounter( std::array<SequenceCounter, MAX_SEQUENCED_IDS> &counters, int16_t id,
+                                            bool &added );
+
+  //! Updates the received sequence counters. Gaps and reorders are only counted if report is true.
+  void _trackSequence( int16_t id, uint16_t sequence, int sequence_bytes, bool report );
+
+  //! Generic data is in text_buffer_ if demultiplexing is enabled and in buffer_ otherwise.
+  static constexpr int GENERIC_BUFFER_SIZE = TEXT_BUFFER_SIZE > 0 ? TEXT_BUFFER_SIZE : BUFFER_SIZE;
+
   std::array<uint8_t, BUFFER_SIZE> buffer_;
   std::array<uint8_t, SERIALIZATION_BUFFER_SIZE> obj_buffer_;
   std::unique_ptr<SerialAbstraction> serial_;
+  // Packets only contain frames, so buffer_ only contains frames and no marker scanning is needed
+  bool packet_transport_;
+  bool packet_batching_ = false;
+  // Frames packed for the next packet without start markers in obj_buffer_, starting at offset 2
+  size_t packet_size_ = 0;
+  // A packet flushed before receiving could not be sent, reported by the next send
+  bool packet_failed_ = false;
   int buffer_index_ = 0;
   int buffer_size_ = 0;
+  std::string partial_line_;
+  // Demultiplexing state, only used if TEXT_BUFFER_SIZE > 0
+  std::array<uint8_t, TEXT_BUFFER_SIZE> text_buffer_;
+  int text_index_ = 0;
+  int text_size_ = 0;
+  int frame_received_ = 0; // Bytes of the current frame in buffer_, 0 if not in a frame
+  int frame_length_ = 0;   // Length of the current frame, 0 until its header is complete
+  bool pending_marker_ = false;
+  OverflowPolicy overflow_policy_ = OverflowPolicy::DropOldestBytes;
+  ReceiveStatistics statistics_;
+  uint32_t received_bytes_ = 0;
+  SequenceNumbers sequence_numbers_ = SequenceNumbers::None;
+  std::array<SequenceCounter, MAX_SEQUENCED_IDS> send_sequences_;
+  std::array<SequenceCounter, MAX_SEQUENCED_IDS> receive_sequences_;
+  SequenceInfo last_sequence_;
 };
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline void CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::_markRead( int count )
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_markRead( int count )
 {
   buffer_size_ -= count;
   buffer_index_ += count;
@@ -174,31 +567,45 @@ inline void CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::_markRead( int
   }
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline void CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::_processSerialData( int max_to_read )
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_processSerialData( int max_to_read )
 {
   int available;
   while ( ( available = serial_->available() ) > 0 ) {
     if ( max_to_read == 0 )
       return;
+    int count = std::min( { available, max_to_read, BUFFER_SIZE } );
+    // Make room according to the overflow policy to ensure buffer_size_ does not exceed BUFFER_SIZE
+    if ( buffer_size_ + count > BUFFER_SIZE )
+      _makeRoom( buffer_size_ + count - BUFFER_SIZE );
     int index = buffer_index_ + buffer_size_;
     if ( index >= BUFFER_SIZE )
       index -= BUFFER_SIZE;
-    int count = std::min( available, BUFFER_SIZE - index );
-    count = std::min( count, max_to_read );
+    count = std::min( { count, BUFFER_SIZE - buffer_size_, BUFFER_SIZE - index } );
+    if ( count <= 0 )
+      return;
     count = serial_->read( &buffer_[index], count );
+    if ( count <= 0 )
+      return;
     buffer_size_ += count;
+    received_bytes_ += count;
     max_to_read -= count;
-    if ( buffer_size_ > BUFFER_SIZE ) {
-      // Remove the oldest data to ensure buffer_size_ does not exceed BUFFER_SIZE
-      _markRead( buffer_size_ - BUFFER_SIZE );
-    }
   }
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline void CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::_processSerialDataUntil( int index )
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_processSerialDataUntil( int index )
 {
+  if ( packet_transport_ ) {
+    _receivePackets( BUFFER_SIZE - buffer_size_ );
+    return;
+  }
+  if constexpr ( TEXT_BUFFER_SIZE > 0 ) {
+    _demultiplexSerialData( false );
+    return;
+  }
   int max_to_read = index - buffer_index_;
   if ( max_to_read < 0 )
     max_to_read += BUFFER_SIZE;
@@ -206,10 +613,19 @@ inline void CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::_processSerialD
   _processSerialData( max_to_read );
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
 inline void
-CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::processSerialData( bool overwrite_buffer )
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::processSerialData( bool overwrite_buffer )
 {
+  if ( packet_transport_ ) {
+    // Packets never contain generic data, so there is nothing to demultiplex
+    _receivePackets( overwrite_buffer ? BUFFER_SIZE : BUFFER_SIZE - buffer_size_ );
+    return;
+  }
+  if constexpr ( TEXT_BUFFER_SIZE > 0 ) {
+    _demultiplexSerialData( overwrite_buffer );
+    return;
+  }
   // Read one byte less than the buffer size to ensure we don't lose an object start marker
   if ( overwrite_buffer )
     _processSerialData( buffer_size_ == 0 ? BUFFER_SIZE : BUFFER_SIZE - 1 );
@@ -217,8 +633,16 @@ CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::processSerialData( bool ove
     _processSerialData( BUFFER_SIZE - buffer_size_ );
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-uint16_t CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::_readObjectSize( int start_index ) const
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+uint16_t
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_readObjectSize( int start_index ) const
+{
+  return detail::frameContentSize( _readSizeField( start_index ) );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+uint16_t
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_readSizeField( int start_index ) const
 {
   int index = start_index + 4; // Size is at index + 4
   if ( index >= BUFFER_SIZE )
@@ -232,9 +656,9 @@ uint16_t CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::_readObjectSize( i
   return le16tohost( serialized_size );
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline int CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::_findNextObjectIndex( int start,
-                                                                                      int end ) const
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline int
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_findNextObjectIndex( int start, int end ) const
 {
   assert( 0 <= end && end < 2 * BUFFER_SIZE &&
           "End index must be >= 0 and smaller than 2 * BUFFER_SIZE" );
@@ -259,9 +683,11 @@ inline int CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::_findNextObjectI
   return -1; // No object found
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline int CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::available() const
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline int CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::available() const
 {
+  if constexpr ( TEXT_BUFFER_SIZE > 0 )
+    return text_size_;
   if ( buffer_size_ == 0 )
     return 0;
   int obj_index = _findNextObjectIndex( buffer_index_, buffer_index_ + buffer_size_ );
@@ -278,39 +704,506 @@ inline int CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::available() cons
   return available;
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline size_t CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::read( uint8_t *data, size_t length )
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline size_t
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::read( uint8_t *data, size_t length )
 {
-  if ( int available_bytes = available(); static_cast<int>( length ) > available_bytes )
-    length = available_bytes;
-  if ( length == 0 )
-    return 0;
-
-  int start = buffer_index_;
-  int end = buffer_index_ + length;
-  if ( end > BUFFER_SIZE ) {
-    std::memcpy( data, &buffer_[start], BUFFER_SIZE - start );
-    data += ( BUFFER_SIZE - start );
-    start = 0;
-    end -= BUFFER_SIZE; // Wrap around the buffer index
-  }
-  std::memcpy( data, &buffer_[start], end - start );
-  _markRead( length );
-  return length;
+  const GenericData generic = peekGeneric();
+  length = std::min( length, generic.size() );
+  const size_t first = std::min( length, generic.first.size );
+  if ( first > 0 )
+    std::memcpy( data, generic.first.data, first );
+  if ( length > first )
+    std::memcpy( data + first, generic.second.data, length - first );
+  return consumeGeneric( length );
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline size_t CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::skip( size_t length )
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline size_t
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::skip( size_t length )
 {
   processSerialData( false );
+  return consumeGeneric( length );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline GenericData
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::peekGeneric() const
+{
+  const int generic = available();
+  const uint8_t *buffer = TEXT_BUFFER_SIZE > 0 ? text_buffer_.data() : buffer_.data();
+  const int index = TEXT_BUFFER_SIZE > 0 ? text_index_ : buffer_index_;
+  const int first = std::min( generic, GENERIC_BUFFER_SIZE - index );
+  GenericData result;
+  result.first = { buffer + index, static_cast<size_t>( first ) };
+  if ( generic > first )
+    result.second = { buffer, static_cast<size_t>( generic - first ) };
+  return result;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline size_t
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::consumeGeneric( size_t length )
+{
   if ( int available_bytes = available(); static_cast<int>( length ) > available_bytes )
     length = available_bytes;
-  _markRead( length );
+  if constexpr ( TEXT_BUFFER_SIZE > 0 ) {
+    text_size_ -= length;
+    text_index_ = text_size_ == 0 ? 0 : ( text_index_ + length ) % TEXT_BUFFER_SIZE;
+  } else {
+    _markRead( length );
+  }
   return length;
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline bool CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::hasObject() const
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_appendPartialLine( int count )
+{
+  const GenericData generic = peekGeneric();
+  const size_t first = std::min<size_t>( count, generic.first.size );
+  partial_line_.append( reinterpret_cast<const char *>( generic.first.data ), first );
+  partial_line_.append( reinterpret_cast<const char *>( generic.second.data ), count - first );
+  consumeGeneric( count );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+template<typename Callback>
+inline bool
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_nextLine( Callback &&callback )
+{
+  while ( true ) {
+    const GenericData data = peekGeneric();
+    const int generic = static_cast<int>( data.size() );
+    if ( generic == 0 )
+      return false;
+    // memchr uses SIMD where available
+    const auto *newline =
+        static_cast<const uint8_t *>( std::memchr( data.first.data, '\n', data.first.size ) );
+    int length = newline == nullptr ? -1 : static_cast<int>( newline - data.first.data );
+    if ( newline == nullptr && data.second.size > 0 ) {
+      newline = static_cast<const uint8_t *>( std::memchr( data.second.data, '\n', data.second.size ) );
+      length = newline == nullptr ? -1
+                                  : static_cast<int>( data.first.size + ( newline - data.second.data ) );
+    }
+    if ( length < 0 ) {
+      // Keep waiting for the line ending unless an object follows or the buffer is full.
+      // If no object follows, at most the last byte is excluded since it could start a marker.
+      if constexpr ( TEXT_BUFFER_SIZE > 0 ) {
+        if ( generic < TEXT_BUFFER_SIZE )
+          return false;
+      } else if ( buffer_size_ < BUFFER_SIZE && generic >= buffer_size_ - 1 ) {
+        return false;
+      }
+      _appendPartialLine( generic );
+      if ( static_cast<int>( partial_line_.size() ) < GENERIC_BUFFER_SIZE )
+        continue;
+      callback( partial_line_.data(), partial_line_.size() );
+      partial_line_.clear();
+      return true;
+    }
+    if ( partial_line_.empty() && length < static_cast<int>( data.first.size ) ) {
+      const char *line = reinterpret_cast<const char *>( data.first.data );
+      callback( line, length > 0 && line[length - 1] == '\r' ? length - 1 : length );
+      consumeGeneric( length + 1 );
+      return true;
+    }
+    _appendPartialLine( length );
+    consumeGeneric( 1 );
+    if ( !partial_line_.empty() && partial_line_.back() == '\r' )
+      partial_line_.pop_back();
+    callback( partial_line_.data(), partial_line_.size() );
+    partial_line_.clear();
+    return true;
+  }
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+template<typename Callback>
+inline size_t
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::forEachLine( Callback &&callback )
+{
+  size_t count = 0;
+  while ( _nextLine( callback ) ) ++count;
+  return count;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline bool
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::readLine( std::string &line )
+{
+  return _nextLine( [&line]( const char *data, size_t length ) { line.assign( data, length ); } );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_demultiplexSerialData( bool overwrite_buffer )
+{
+  uint8_t chunk[64];
+  int max_to_read = BUFFER_SIZE + TEXT_BUFFER_SIZE;
+  int available;
+  while ( max_to_read > 0 && ( available = serial_->available() ) > 0 ) {
+    int count = std::min( { available, static_cast<int>( sizeof( chunk ) ), max_to_read } );
+    if ( !overwrite_buffer ) {
+      // Every byte ends up in one of the two buffers, so this can not overflow either of them
+      count = std::min( { count, BUFFER_SIZE - buffer_size_, TEXT_BUFFER_SIZE - text_size_ } );
+    }
+    if ( count <= 0 )
+      return;
+    count = serial_->read( chunk, count );
+    if ( count <= 0 )
+      return;
+    max_to_read -= count;
+    received_bytes_ += count;
+    _demultiplex( chunk, count );
+  }
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_demultiplex( const uint8_t *data, int count )
+{
+  static constexpr uint8_t MARKER = 0x02;
+  int i = 0;
+  while ( i < count ) {
+    if ( frame_received_ > 0 ) {
+      // Copy the header and then the rest of the frame to the frame queue
+      const int needed = frame_length_ > 0 ? frame_length_ - frame_received_ : 6 - frame_received_;
+      const int n = std::min( needed, count - i );
+      _pushFrameBytes( data + i, n );
+      frame_received_ += n;
+      i += n;
+      if ( frame_length_ == 0 && frame_received_ == 6 ) {
+        int start = buffer_index_ + buffer_size_ - 6;
+        if ( start >= BUFFER_SIZE )
+          start -= BUFFER_SIZE;
+        const int length = _readObjectSize( start ) + 8;
+        if ( length <= BUFFER_SIZE ) {
+          frame_length_ = length;
+        } else {
+          // Can not be a valid frame. Move the marker to the text and rescan the rest of the header.
+          uint8_t header[6];
+          for ( int k = 0; k < 6; ++k ) header[k] = buffer_[( start + k ) % BUFFER_SIZE];
+          buffer_size_ -= 6;
+          frame_received_ = 0;
+          _pushText( header, 1 );
+          _demultiplex( header + 1, 5 );
+          continue;
+        }
+      }
+      if ( frame_received_ == frame_length_ ) {
+        frame_received_ = 0;
+        frame_length_ = 0;
+      }
+      continue;
+    }
+    if ( pending_marker_ ) {
+      pending_marker_ = false;
+      if ( data[i] == 0x42 ) {
+        _pushFrameBytes( &MARKER, 1 );
+        frame_received_ = 1;
+        continue;
+      }
+      _pushText( &MARKER, 1 );
+    }
+    const auto *marker = static_cast<const uint8_t *>( std::memchr( data + i, MARKER, count - i ) );
+    const int end = marker == nullptr ? count : static_cast<int>( marker - data );
+    _pushText( data + i, end - i );
+    i = end;
+    if ( marker != nullptr ) {
+      pending_marker_ = true;
+      ++i;
+    }
+  }
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_pushFrameBytes( const uint8_t *data, int count )
+{
+  // Drop complete frames to make room. The current frame always fits since its length was checked
+  // when its header was complete.
+  if ( buffer_size_ + count > BUFFER_SIZE )
+    _makeRoom( buffer_size_ + count - BUFFER_SIZE );
+  int index = buffer_index_ + buffer_size_;
+  if ( index >= BUFFER_SIZE )
+    index -= BUFFER_SIZE;
+  const int first = std::min( count, BUFFER_SIZE - index );
+  std::memcpy( &buffer_[index], data, first );
+  std::memcpy( &buffer_[0], data + first, count - first );
+  buffer_size_ += count;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_receivePackets( int max_to_read )
+{
+  // The serialization buffer is needed to receive packets
+  if ( !_flushPacket() )
+    packet_failed_ = true;
+  int size;
+  while ( ( size = serial_->available() ) > 0 ) {
+    // Each frame of at least 6 bytes grows by its start marker. If the buffer is empty, packets are
+    // received even if they do not fit, since they would never fit.
+    if ( size + size / 3 > max_to_read && buffer_size_ > 0 )
+      return;
+    int index = buffer_index_ + buffer_size_;
+    if ( index >= BUFFER_SIZE )
+      index -= BUFFER_SIZE;
+    // Receive a packet directly behind the start marker of its first frame in the ring buffer if it
+    // is contiguous, otherwise receive it into the serialization buffer and copy it
+    const bool in_place = size + 2 <= BUFFER_SIZE - buffer_size_ && size + 2 <= BUFFER_SIZE - index;
+    uint8_t *packet = in_place ? &buffer_[index + 2] : obj_buffer_.data();
+    size = serial_->receivePacket( packet, in_place ? size : SERIALIZATION_BUFFER_SIZE );
+    if ( size == 0 )
+      return;
+    if ( size < 0 ) {
+      ++statistics_.dropped_frames; // Larger than the serialization buffer
+      continue;
+    }
+    uint16_t payload_size = 0;
+    if ( size >= 6 )
+      std::memcpy( &payload_size, packet + 2, 2 );
+    if ( in_place && detail::frameContentSize( le16tohost( payload_size ) ) + 6 == size ) {
+      // A single frame, the CRC is checked when it is read
+      buffer_[index] = 0x02;
+      buffer_[index + 1] = 0x42;
+      buffer_size_ += size + 2;
+      max_to_read -= size + 2;
+      received_bytes_ += size + 2;
+      continue;
+    }
+    if ( in_place && size > SERIALIZATION_BUFFER_SIZE ) {
+      ++statistics_.dropped_frames;
+      continue;
+    }
+    if ( in_place ) {
+      std::memcpy( obj_buffer_.data(), packet, size );
+      packet = obj_buffer_.data();
+    }
+    const int previous_size = buffer_size_;
+    _pushPacketFrames( packet, size );
+    max_to_read -= std::max( buffer_size_ - previous_size, 0 );
+  }
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_pushPacketFrames( const uint8_t *packet,
+                                                                                         int size )
+{
+  static constexpr uint8_t MARKER[2] = { 0x02, 0x42 };
+  int offset = 0;
+  while ( offset < size ) {
+    uint16_t payload_size = 0;
+    if ( size - offset >= 6 )
+      std::memcpy( &payload_size, packet + offset + 2, 2 );
+    const int length = detail::frameContentSize( le16tohost( payload_size ) ) + 6;
+    if ( size - offset < 6 || length > size - offset || length + 2 > BUFFER_SIZE ) {
+      // The rest of the packet can not be split into frames
+      ++statistics_.dropped_frames;
+      return;
+    }
+    _pushFrameBytes( MARKER, 2 );
+    _pushFrameBytes( packet + offset, length );
+    received_bytes_ += length + 2;
+    offset += length;
+  }
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_pushText( const uint8_t *data, int count )
+{
+  if constexpr ( TEXT_BUFFER_SIZE > 0 ) {
+    if ( count > TEXT_BUFFER_SIZE ) {
+      data += count - TEXT_BUFFER_SIZE;
+      count = TEXT_BUFFER_SIZE;
+    }
+    // Drop the oldest text if the text buffer is full
+    if ( int overflow = text_size_ + count - TEXT_BUFFER_SIZE; overflow > 0 ) {
+      consumeGeneric( overflow );
+      statistics_.dropped_bytes += overflow;
+    }
+    const int index = ( text_index_ + text_size_ ) % TEXT_BUFFER_SIZE;
+    const int first = std::min( count, TEXT_BUFFER_SIZE - index );
+    std::memcpy( &text_buffer_[index], data, first );
+    std::memcpy( &text_buffer_[0], data + first, count - first );
+    text_size_ += count;
+  } else {
+    (void)data;
+    (void)count;
+  }
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline typename CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::ItemType
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_itemAt( int offset, int &length ) const
+{
+  const int remaining = buffer_size_ - offset;
+  int start = buffer_index_ + offset;
+  if ( start >= BUFFER_SIZE )
+    start -= BUFFER_SIZE;
+  const int second = start + 1 == BUFFER_SIZE ? 0 : start + 1;
+  if ( buffer_[start] == 0x02 && ( remaining < 2 || buffer_[second] == 0x42 ) ) {
+    if ( remaining < 6 ) {
+      length = remaining;
+      return ItemType::IncompleteFrame;
+    }
+    length = _readObjectSize( start ) + 8;
+    if ( length > BUFFER_SIZE ) {
+      length = 2; // Can never be complete, the marker is skipped when reading
+      return ItemType::Generic;
+    }
+    if ( length > remaining ) {
+      length = remaining;
+      return ItemType::IncompleteFrame;
+    }
+    return ItemType::Frame;
+  }
+  const int next = _findNextObjectIndex( start, buffer_index_ + buffer_size_ );
+  if ( next != -1 ) {
+    length = next - start;
+    if ( length < 0 )
+      length += BUFFER_SIZE;
+    return ItemType::Generic;
+  }
+  int last = buffer_index_ + buffer_size_ - 1;
+  if ( last >= BUFFER_SIZE )
+    last -= BUFFER_SIZE;
+  // The last byte could be the start of a marker
+  length = buffer_[last] == 0x02 ? remaining - 1 : remaining;
+  return ItemType::Generic;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_erase( int offset, int length )
+{
+  if ( offset == 0 ) {
+    _markRead( length );
+    return;
+  }
+  const int tail = buffer_size_ - offset - length;
+  if ( offset <= tail ) {
+    // Move the data in front of the erased range forward
+    for ( int i = offset - 1; i >= 0; --i )
+      buffer_[( buffer_index_ + i + length ) % BUFFER_SIZE] = buffer_[( buffer_index_ + i ) % BUFFER_SIZE];
+    _markRead( length );
+  } else {
+    // Move the data behind the erased range back
+    for ( int i = offset + length; i < buffer_size_; ++i )
+      buffer_[( buffer_index_ + i - length ) % BUFFER_SIZE] = buffer_[( buffer_index_ + i ) % BUFFER_SIZE];
+    buffer_size_ -= length;
+  }
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline int CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_dropSupersededFrames(
+    int count, const int16_t *ids, int id_count, int &freed )
+{
+  int dropped = 0;
+  int length = 0;
+  for ( int offset = 0; freed < count && offset < buffer_size_; ) {
+    if ( _itemAt( offset, length ) != ItemType::Frame ) {
+      offset += length == 0 ? 1 : length;
+      continue;
+    }
+    const int16_t id = _readFrameId( ( buffer_index_ + offset ) % BUFFER_SIZE );
+    bool superseded = ids == nullptr || std::find( ids, ids + id_count, id ) != ids + id_count;
+    if ( superseded ) {
+      superseded = false;
+      int newer_length = 0;
+      for ( int newer = offset + length; !superseded && newer < buffer_size_; newer += newer_length ) {
+        const ItemType type = _itemAt( newer, newer_length );
+        if ( newer_length == 0 )
+          break;
+        superseded = type == ItemType::Frame &&
+                     _readFrameId( ( buffer_index_ + newer ) % BUFFER_SIZE ) == id;
+      }
+    }
+    if ( !superseded ) {
+      offset += length;
+      continue;
+    }
+    _erase( offset, length );
+    freed += length;
+    ++dropped;
+  }
+  return dropped;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+template<typename... Conflatable>
+inline size_t CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::catchUp( int threshold )
+{
+  static_assert( sizeof...( Conflatable ) > 0, "At least one conflatable type is required." );
+  static constexpr int16_t ids[] = { object_id<Conflatable>()... };
+  size_t skipped = 0;
+  while ( buffer_size_ + text_size_ + serial_->available() > threshold ) {
+    processSerialData( false );
+    int freed = 0;
+    const int dropped = _dropSupersededFrames( BUFFER_SIZE, ids, sizeof...( Conflatable ), freed );
+    if ( dropped == 0 )
+      break;
+    skipped += dropped;
+  }
+  statistics_.skipped_frames += skipped;
+  return skipped;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_makeRoom( int count )
+{
+  int freed = 0;
+  int length = 0;
+  if ( overflow_policy_ == OverflowPolicy::DropOldestBytes && TEXT_BUFFER_SIZE == 0 && !packet_transport_ ) {
+    freed = std::min( count, buffer_size_ );
+    _markRead( freed );
+    statistics_.dropped_bytes += freed;
+    return;
+  }
+  if ( overflow_policy_ == OverflowPolicy::KeepNewestPerId )
+    statistics_.dropped_frames += _dropSupersededFrames( count, nullptr, 0, freed );
+  if ( overflow_policy_ == OverflowPolicy::DropGenericFirst ||
+       overflow_policy_ == OverflowPolicy::KeepNewestPerId ) {
+    // Drop generic data, oldest first
+    for ( int offset = 0; freed < count && offset < buffer_size_; ) {
+      const ItemType type = _itemAt( offset, length );
+      if ( length == 0 || type == ItemType::IncompleteFrame )
+        break;
+      if ( type == ItemType::Frame ) {
+        offset += length;
+        continue;
+      }
+      length = std::min( length, count - freed );
+      _erase( offset, length );
+      freed += length;
+      statistics_.dropped_bytes += length;
+    }
+  }
+  // Drop the oldest items at frame boundaries
+  while ( freed < count && buffer_size_ > 0 ) {
+    const ItemType type = _itemAt( 0, length );
+    if ( length == 0 || type == ItemType::IncompleteFrame )
+      break;
+    _markRead( length );
+    freed += length;
+    if ( type == ItemType::Frame )
+      ++statistics_.dropped_frames;
+    else
+      statistics_.dropped_bytes += length;
+  }
+  if ( freed < count && TEXT_BUFFER_SIZE == 0 ) {
+    // Only an incomplete frame is left which is larger than the free space
+    const int remaining = std::min( count - freed, buffer_size_ );
+    _markRead( remaining );
+    statistics_.dropped_bytes += remaining;
+  }
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline bool CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::hasObject() const
 {
   if ( buffer_size_ < 4 || buffer_[buffer_index_] != 0x02 )
     return false;
@@ -320,13 +1213,21 @@ inline bool CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::hasObject() con
   return buffer_[second_index] == 0x42;
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline int16_t CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::getObjectId() const
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline int16_t
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::getObjectId() const
 {
   if ( buffer_size_ < 4 || !hasObject() )
     return -1;
+  return _readFrameId( buffer_index_ );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline int16_t
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_readFrameId( int start_index ) const
+{
   // ID is the third and fourth byte in the serialized object
-  int index = buffer_index_ + 2;
+  int index = start_index + 2;
   if ( index >= BUFFER_SIZE )
     index -= BUFFER_SIZE;
   uint16_t tmp = 0;
@@ -560,9 +1461,84 @@ inline uint16_t compute_crc16( const uint8_t *data, size_t length )
 }
 } // namespace util
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+template<typename Handler>
+inline ReadResult
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_extractFrame( bool match_id, int16_t id,
+                                                                                     Handler &&handler )
+{
+  int length = 0;
+  for ( int offset = 0; offset < buffer_size_; offset += length ) {
+    const ItemType type = _itemAt( offset, length );
+    if ( length == 0 )
+      break;
+    if ( type == ItemType::IncompleteFrame ) {
+      // Might also be a marker in the generic data followed by a random size, search behind it
+      length = std::min( length, 2 );
+      continue;
+    }
+    if ( type != ItemType::Frame )
+      continue;
+    const int start = ( buffer_index_ + offset ) % BUFFER_SIZE;
+    const uint8_t *data = &buffer_[start];
+    if ( start + length > BUFFER_SIZE ) {
+      if ( length > SERIALIZATION_BUFFER_SIZE ) {
+        length = 2;
+        continue;
+      }
+      if ( !_flushPacket() )
+        packet_failed_ = true;
+      std::memcpy( obj_buffer_.data(), &buffer_[start], BUFFER_SIZE - start );
+      std::memcpy( obj_buffer_.data() + BUFFER_SIZE - start, &buffer_[0], start + length - BUFFER_SIZE );
+      data = obj_buffer_.data();
+    }
+    uint16_t crc = 0;
+    std::memcpy( &crc, data + length - 2, 2 );
+    if ( le16tohost( crc ) != util::compute_crc16( data, length - 2 ) ) {
+      // Not a frame, e.g., a marker in the generic data. Continue the search behind the marker.
+      length = 2;
+      continue;
+    }
+    if ( match_id && _readFrameId( start ) != id )
+      continue;
+    const int16_t frame_id = _readFrameId( start );
+    uint16_t size_field = 0;
+    std::memcpy( &size_field, data + 4, 2 );
+    const int sequence_bytes = detail::frameSequenceBytes( le16tohost( size_field ) );
+    const size_t payload_size = length - 8 - sequence_bytes;
+    uint16_t sequence = 0;
+    std::memcpy( &sequence, data + 6 + payload_size, sequence_bytes );
+    _trackSequence( frame_id, le16tohost( sequence ), sequence_bytes, true );
+    const size_t consumed = handler( frame_id, data + 6, payload_size );
+    _erase( offset, length );
+    return consumed != payload_size ? ReadResult::ObjectSizeMismatch : ReadResult::Success;
+  }
+  return ReadResult::NoObjectAvailable;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+template<typename Handler>
+inline ReadResult
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::extractFrame( Handler &&handler )
+{
+  return _extractFrame( false, 0, handler );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+template<typename T>
+inline ReadResult
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::extractObject( T &obj )
+{
+  static_assert( refl::is_reflectable<T>(), "Type must be reflectable." );
+  return _extractFrame( true, object_id<T>(), [&obj]( int16_t, const uint8_t *payload, size_t size ) -> size_t {
+    return util::deserialize<T>( payload, size, obj );
+  } );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
 template<typename T>
-inline ReadResult CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::readObject( T &obj )
+inline ReadResult
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::readObject( T &obj )
 {
   static_assert( refl::is_reflectable<T>(), "Type must be reflectable." );
   constexpr auto type_info = refl::reflect<T>();
@@ -578,13 +1554,44 @@ inline ReadResult CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::readObjec
   }
   if ( getObjectId() != id )
     return ReadResult::ObjectIdMismatch;
+  return readFrame( [&obj]( int16_t, const uint8_t *payload, size_t size ) -> size_t {
+    return util::deserialize<T>( payload, size, obj );
+  } );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+template<typename Handler>
+inline ReadResult
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::readFrame( Handler &&handler )
+{
+  if ( !hasObject() ) {
+    return ReadResult::NoObjectAvailable;
+  }
+  // Read as much data as available
+  _processSerialDataUntil( buffer_index_ );
+  if ( buffer_size_ < 6 ) {
+    return ReadResult::NotEnoughData; // Not enough data to read metadata
+  }
   uint16_t serialized_size = _readObjectSize( buffer_index_ );
+  if ( serialized_size + 8 > BUFFER_SIZE ) {
+    // This object can never be complete. Skip the start marker to resync on the next object.
+    _markRead( 2 );
+    return ReadResult::ObjectTooLarge;
+  }
   if ( serialized_size + 8 > buffer_size_ ) {
     return ReadResult::NotEnoughData; // Not enough data to deserialize the object
   }
   const uint8_t *data = &buffer_[buffer_index_];
   if ( buffer_index_ + serialized_size + 8 > BUFFER_SIZE ) {
+    if ( serialized_size + 8 > SERIALIZATION_BUFFER_SIZE ) {
+      // Can not copy the wrapped object into the read buffer. If demultiplexing, the receive buffer
+      // only contains frames, hence, the whole frame is skipped to keep the next frame at the start.
+      _markRead( TEXT_BUFFER_SIZE > 0 ? 8 + serialized_size : 2 );
+      return ReadResult::ObjectTooLarge;
+    }
     // If data wraps around circular buffer, copy it to read buffer for continuous access
+    if ( !_flushPacket() )
+      packet_failed_ = true;
     std::memcpy( obj_buffer_.data(), &buffer_[buffer_index_], BUFFER_SIZE - buffer_index_ );
     std::memcpy( obj_buffer_.data() + BUFFER_SIZE - buffer_index_, &buffer_[0],
                  buffer_index_ + 8 + serialized_size - BUFFER_SIZE );
@@ -596,19 +1603,26 @@ inline ReadResult CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::readObjec
   std::memcpy( &crc, data + serialized_size + 6, 2 );
   crc = le16tohost( crc );
   uint16_t computed_crc = util::compute_crc16( data, 6 + serialized_size );
+  const int sequence_bytes = detail::frameSequenceBytes( _readSizeField( buffer_index_ ) );
+  const size_t payload_size = serialized_size - sequence_bytes;
   size_t consumed = 0;
   if ( crc == computed_crc ) {
-    consumed = util::deserialize<T>( data + 6, serialized_size, obj );
+    const int16_t id = getObjectId();
+    uint16_t sequence = 0;
+    std::memcpy( &sequence, data + 6 + payload_size, sequence_bytes );
+    _trackSequence( id, le16tohost( sequence ), sequence_bytes, true );
+    consumed = handler( id, data + 6, payload_size );
   }
   // Whether or not the CRC is valid, we need to update the buffer indices
   _markRead( 8 + serialized_size );
   if ( crc != computed_crc )
     return ReadResult::CrcError;
-  return serialized_size != consumed ? ReadResult::ObjectSizeMismatch : ReadResult::Success;
+  return payload_size != consumed ? ReadResult::ObjectSizeMismatch : ReadResult::Success;
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
-inline ReadResult CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::skipObject()
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline ReadResult
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::skipObject()
 {
   if ( !hasObject() ) {
     return ReadResult::NoObjectAvailable;
@@ -618,43 +1632,205 @@ inline ReadResult CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::skipObjec
     return ReadResult::NotEnoughData; // Not enough data to read metadata
   }
   uint16_t serialized_size = _readObjectSize( buffer_index_ );
+  if ( serialized_size + 8 > BUFFER_SIZE ) {
+    _markRead( 2 );
+    return ReadResult::ObjectTooLarge;
+  }
   if ( serialized_size + 8 > buffer_size_ ) {
     return ReadResult::NotEnoughData; // Not enough data to skip the object
   }
+  // Skipped frames are not lost, only their sequence counter is taken over
+  const int sequence_bytes = detail::frameSequenceBytes( _readSizeField( buffer_index_ ) );
+  if ( sequence_bytes > 0 ) {
+    uint16_t sequence = 0;
+    for ( int i = 0; i < sequence_bytes; ++i ) {
+      const int index = ( buffer_index_ + 6 + serialized_size - sequence_bytes + i ) % BUFFER_SIZE;
+      sequence |= static_cast<uint16_t>( buffer_[index] ) << ( 8 * i );
+    }
+    _trackSequence( getObjectId(), sequence, sequence_bytes, false );
+  }
   _markRead( serialized_size + 8 );
   return ReadResult::Success;
 }
 
-template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE>
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
 template<typename T>
-inline WriteResult CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE>::sendObject( const T &obj )
+inline WriteResult
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::sendObject( const T &obj )
 {
   static_assert( refl::is_reflectable<T>(), "Type must be reflectable." );
   constexpr auto type_info = refl::reflect<T>();
   constexpr auto id = std::get<crosstalk::id>( type_info.attributes ).id_value;
   static_assert( id >= 0, "Object ID must be greater or equal to 0. Negative ids are reserved." );
+  return sendFrame( id, util::compute_size( obj ), [&obj]( uint8_t *payload ) {
+    size_t serialized_size = util::serialize<T>( obj, payload );
+    assert( serialized_size == util::compute_size( obj ) &&
+            "Serialized size does not match expected size" );
+    (void)serialized_size;
+  } );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline size_t CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::frameSize( int16_t id,
+                                                                                              size_t payload_size ) const
+{
+  // 2 bytes start, 2 byte id, 2 bytes length, 2 bytes crc
+  const size_t size = 8 + payload_size;
+  if ( sequence_numbers_ == SequenceNumbers::None || id < 0 )
+    return size;
+  // Same lookup as _sequenceCounter, ids that do not fit into the table are sent without counter
+  for ( const SequenceCounter &counter : send_sequences_ ) {
+    if ( counter.id == id || counter.id < 0 )
+      return size + static_cast<size_t>( sequence_numbers_ );
+  }
+  return size;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+template<typename Serializer>
+inline WriteResult
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::sendFrame( int16_t id,
+                                                                                  size_t payload_size,
+                                                                                  Serializer &&serialize )
+{
+  SequenceCounter *counter = nullptr;
+  if ( sequence_numbers_ != SequenceNumbers::None && id >= 0 ) {
+    bool added = false;
+    counter = _sequenceCounter( send_sequences_, id, added );
+  }
+  const int sequence_bytes = counter != nullptr ? static_cast<int>( sequence_numbers_ ) : 0;
   // 2 bytes start, 2 byte id, 2 bytes length, 2 bytes crc
-  size_t size = 8 + util::compute_size( obj );
-  if ( size > SERIALIZATION_BUFFER_SIZE ) {
+  size_t size = 8 + payload_size + sequence_bytes;
+  if ( size > SERIALIZATION_BUFFER_SIZE || payload_size > detail::FRAME_SIZE_MASK ) {
     return WriteResult::ObjectTooLarge;
   }
-  obj_buffer_[0] = 0x02;
-  obj_buffer_[1] = 0x42;
+  const uint16_t sequence = counter != nullptr ? counter->next : 0;
+  if ( !packet_transport_ ) {
+    if ( counter != nullptr )
+      ++counter->next;
+    _writeFrame( obj_buffer_.data(), id, payload_size, serialize, sequence_bytes, sequence );
+    return serial_->write( obj_buffer_.data(), size ) ? WriteResult::Success : WriteResult::WriteError;
+  }
+  if ( packet_failed_ ) {
+    packet_failed_ = false;
+    return WriteResult::WriteError;
+  }
+  // Packets contain the frames without start markers
+  size_t max_packet_size = SERIALIZATION_BUFFER_SIZE - 2;
+  if ( serial_->maxPacketSize() > 0 )
+    max_packet_size = std::min( max_packet_size, serial_->maxPacketSize() );
+  if ( size - 2 > max_packet_size )
+    return WriteResult::ObjectTooLarge;
+  if ( packet_size_ + size - 2 > max_packet_size && !_flushPacket() )
+    return WriteResult::WriteError;
+  if ( counter != nullptr )
+    ++counter->next;
+  // The start marker is written over the CRC of the previous frame since the CRC covers it
+  uint8_t *frame = obj_buffer_.data() + packet_size_;
+  uint8_t previous_crc[2];
+  std::memcpy( previous_crc, frame, 2 );
+  _writeFrame( frame, id, payload_size, serialize, sequence_bytes, sequence );
+  if ( packet_size_ > 0 )
+    std::memcpy( frame, previous_crc, 2 );
+  packet_size_ += size - 2;
+  if ( !packet_batching_ && !_flushPacket() )
+    return WriteResult::WriteError;
+  return WriteResult::Success;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+template<typename Serializer>
+inline void
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_writeFrame( uint8_t *data, int16_t id,
+                                                                                   size_t payload_size,
+                                                                                   Serializer &&serialize,
+                                                                                   int sequence_bytes,
+                                                                                   uint16_t sequence )
+{
+  data[0] = 0x02;
+  data[1] = 0x42;
   // Write the ID in little-endian format
   uint16_t uid;
   std::memcpy( &uid, &id, sizeof( uint16_t ) );
   uid = hosttole16( uid );
-  *reinterpret_cast<uint16_t *>( obj_buffer_.data() + 2 ) = uid;
+  std::memcpy( data + 2, &uid, 2 );
+  // Write the size of the serialized object and the number of sequence counter bytes
+  const uint16_t size = hosttole16( static_cast<uint16_t>( payload_size | ( sequence_bytes << 14 ) ) );
+  std::memcpy( data + 4, &size, 2 );
   // Write the serialized object
-  size_t serialized_size = util::serialize<T>( obj, obj_buffer_.data() + 6 );
-  // Write the size of the serialized object
-  *reinterpret_cast<uint16_t *>( obj_buffer_.data() + 4 ) =
-      hosttole16( static_cast<uint16_t>( serialized_size ) );
-  assert( serialized_size == size - 8 && "Serialized size does not match expected size" );
+  serialize( data + 6 );
+  sequence = hosttole16( sequence );
+  std::memcpy( data + 6 + payload_size, &sequence, sequence_bytes );
   // Write the CRC
-  *reinterpret_cast<uint16_t *>( obj_buffer_.data() + 6 + serialized_size ) =
-      hosttole16( util::compute_crc16( obj_buffer_.data(), 6 + serialized_size ) );
-  return serial_->write( obj_buffer_.data(), size ) ? WriteResult::Success : WriteResult::WriteError;
+  const uint16_t crc = hosttole16( util::compute_crc16( data, 6 + payload_size + sequence_bytes ) );
+  std::memcpy( data + 6 + payload_size + sequence_bytes, &crc, 2 );
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline typename CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::SequenceCounter *
+CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_sequenceCounter(
+    std::array<SequenceCounter, MAX_SEQUENCED_IDS> &counters, int16_t id, bool &added )
+{
+  added = false;
+  for ( SequenceCounter &counter : counters ) {
+    if ( counter.id == id )
+      return &counter;
+    if ( counter.id < 0 ) {
+      counter.id = id;
+      counter.next = 0;
+      added = true;
+      return &counter;
+    }
+  }
+  return nullptr;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline void CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_trackSequence( int16_t id,
+                                                                                                 uint16_t sequence,
+                                                                                                 int sequence_bytes,
+                                                                                                 bool report )
+{
+  last_sequence_ = SequenceInfo{};
+  if ( sequence_bytes == 0 || id < 0 )
+    return;
+  last_sequence_.valid = true;
+  last_sequence_.id = id;
+  last_sequence_.sequence = sequence;
+  last_sequence_.sequence_bytes = sequence_bytes;
+  bool added = false;
+  SequenceCounter *counter = _sequenceCounter( receive_sequences_, id, added );
+  if ( counter == nullptr )
+    return;
+  if ( counter->bytes != sequence_bytes ) {
+    counter->bytes = sequence_bytes;
+    added = true;
+  }
+  // The distance to the expected counter is signed to tell lost from late frames
+  const int distance = sequence_bytes == 1 ? static_cast<int8_t>( static_cast<uint8_t>( sequence - counter->next ) )
+                                           : static_cast<int16_t>( static_cast<uint16_t>( sequence - counter->next ) );
+  if ( !added && distance < 0 ) {
+    if ( report ) {
+      ++statistics_.reordered_frames;
+      last_sequence_.reordered = true;
+    }
+    return;
+  }
+  if ( !added && distance > 0 && report ) {
+    statistics_.lost_frames += distance;
+    last_sequence_.lost_frames = distance;
+  }
+  counter->next = sequence + 1;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+inline bool CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE>::_flushPacket()
+{
+  if ( packet_size_ == 0 )
+    return true;
+  const bool success = serial_->sendPacket( obj_buffer_.data() + 2, packet_size_ );
+  packet_size_ = 0;
+  return success;
 }
 } // namespace crosstalk
 
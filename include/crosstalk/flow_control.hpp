@@ -0,0 +1,380 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_FLOW_CONTROL_HPP
+#define CROSSTALK_FLOW_CONTROL_HPP
+
+#include "crosstalker.hpp"
+#include <cstring>
+
+namespace crosstalk
+{
+
+/*!
+ * Payload of an InternalObjectId::Credit frame that a receiver sends to the sender. The counters
+ * are cumulative and wrap around, so a lost report is superseded by the next one. The sender may
+ * have up to free_bytes bytes beyond received_bytes and up to frame_window frames beyond
+ * consumed_frames in flight.
+ */
+struct CreditReport {
+  //! Value of frame_window if the receiver only limits the number of bytes.
+  static constexpr uint16_t NO_FRAME_LIMIT = 0xFFFF;
+  //! Size of the serialized report.
+  static constexpr size_t SIZE = 15;
+
+  //! Bytes received so far, see CrossTalker::receivedBytes.
+  uint32_t received_bytes = 0;
+  //! Bytes the receive buffer can take in addition.
+  uint32_t free_bytes = 0;
+  //! Flow-controlled frames the receiving application has processed so far.
+  uint32_t consumed_frames = 0;
+  //! Frames that may be received but not yet processed.
+  uint16_t frame_window = NO_FRAME_LIMIT;
+  //! True if nothing was buffered or waiting to be processed when the report was sent.
+  bool idle = false;
+
+  size_t serialize( uint8_t *data ) const
+  {
+    size_t offset = util::serialize( received_bytes, data );
+    offset += util::serialize( free_bytes, data + offset );
+    offset += util::serialize( consumed_frames, data + offset );
+    offset += util::serialize( frame_window, data + offset );
+    offset += util::serialize( static_cast<uint8_t>( idle ? 1 : 0 ), data + offset );
+    return offset;
+  }
+
+  //! Returns the number of read bytes or 0 if size is too small.
+  size_t deserialize( const uint8_t *data, size_t size )
+  {
+    if ( size < SIZE )
+      return 0;
+    uint8_t flags = 0;
+    size_t offset = util::deserialize( data, size, received_bytes );
+    offset += util::deserialize( data + offset, size - offset, free_bytes );
+    offset += util::deserialize( data + offset, size - offset, consumed_frames );
+    offset += util::deserialize( data + offset, size - offset, frame_window );
+    offset += util::deserialize( data + offset, size - offset, flags );
+    idle = ( flags & 1 ) != 0;
+    return offset;
+  }
+};
+
+/*!
+ * Receiving side of the flow control. Reports the free space of the receive buffer and, if a
+ * frame window is given, how many frames the application can still take.
+ * @code
+ * crosstalker.processSerialData();
+ * while ( crosstalker.hasObject() ) { ...; reporter.consumed(); }
+ * if ( millis() - last_report > 50 ) reporter.report( crosstalker );
+ * @endcode
+ * Reports should be sent periodically even if nothing changed, since the sender uses two
+ * consecutive idle reports to write off data lost on the link. Hence, the interval has to be
+ * longer than the latency of the link.
+ */
+class CreditReporter
+{
+public:
+  explicit CreditReporter( uint16_t frame_window = CreditReport::NO_FRAME_LIMIT )
+      : frame_window_( frame_window )
+  {
+  }
+
+  //! Counts frames the application has processed. Only needed if a frame window is used.
+  void consumed( uint32_t frames = 1 ) { consumed_frames_ += frames; }
+
+  uint32_t consumedFrames() const { return consumed_frames_; }
+
+  /*!
+   * Sends a credit report to the sender. Should be called after processSerialData.
+   * @param pending_frames Frames that were read but are still queued by the application.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  WriteResult report( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                      uint32_t pending_frames = 0 )
+  {
+    CreditReport report;
+    report.received_bytes = crosstalker.receivedBytes();
+    report.free_bytes = crosstalker.freeSpace();
+    report.consumed_frames = consumed_frames_;
+    report.frame_window = frame_window_;
+    report.idle = crosstalker.freeSpace() == BUFFER_SIZE && pending_frames == 0;
+    return crosstalker.sendFrame( static_cast<int16_t>( InternalObjectId::Credit ), CreditReport::SIZE,
+                                  [&report]( uint8_t *payload ) { report.serialize( payload ); } );
+  }
+
+private:
+  uint32_t consumed_frames_ = 0;
+  uint16_t frame_window_;
+};
+
+//! Counters of the sending side of the flow control.
+struct FlowControlStatistics {
+  //! Frames that had to be held because there was not enough credit.
+  uint32_t held_frames = 0;
+  //! Held frames that were replaced by a newer frame of the same conflatable type.
+  uint32_t conflated_frames = 0;
+  //! Frames rejected with WriteResult::NoCredit because the hold buffer was full.
+  uint32_t rejected_frames = 0;
+  //! Bytes that were sent but never arrived according to the receiver and were written off.
+  uint32_t lost_bytes = 0;
+};
+
+/*!
+ * Sending side of the flow control. Objects are only sent if the receiver has advertised enough
+ * credit. Otherwise, they are held in a fixed buffer and sent in order once credit arrives. A held
+ * object of one of the Conflatable types is replaced by a newer object of the same type, so the
+ * receiver gets the latest value instead of every value. Frames sent without the flow control,
+ * e.g., generic data or logs, are not held but count against the credit once received.
+ * @code
+ * crosstalk::FlowControl<512, CommStatus> flow_control;
+ * flow_control.send( crosstalker, status );
+ * ...
+ * crosstalker.processSerialData();
+ * if ( crosstalker.getObjectId() == static_cast<int16_t>( crosstalk::InternalObjectId::Credit ) )
+ *   flow_control.readCredit( crosstalker );
+ * @endcode
+ * @tparam HOLD_BUFFER_SIZE Size of the buffer for held frames. Each frame takes 4 bytes + payload.
+ */
+template<size_t HOLD_BUFFER_SIZE = 256, typename... Conflatable>
+class FlowControl
+{
+public:
+  /*!
+   * @param initial_bytes Credit before the first report, e.g., the receive buffer size of the
+   *   receiver if it is known and empty.
+   * @param initial_frames Frame window before the first report.
+   */
+  explicit FlowControl( uint32_t initial_bytes = 0, uint16_t initial_frames = CreditReport::NO_FRAME_LIMIT )
+  {
+    report_.free_bytes = initial_bytes;
+    report_.frame_window = initial_frames;
+  }
+
+  /*!
+   * Sends the object if there is enough credit and no frames are held, otherwise holds it.
+   * @return Success if the object was sent or held, NoCredit if it had to be held but the hold
+   *   buffer is full.
+   */
+  template<typename T, int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  WriteResult send( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                    const T &obj )
+  {
+    static_assert( refl::is_reflectable<T>(), "Type must be reflectable." );
+    constexpr int16_t id = object_id<T>();
+    static_assert( id >= 0, "Object ID must be greater or equal to 0. Negative ids are reserved." );
+    const size_t payload_size = util::compute_size( obj );
+    const size_t frame_size = crosstalker.frameSize( id, payload_size );
+    if ( frame_size > SERIALIZATION_BUFFER_SIZE )
+      return WriteResult::ObjectTooLarge;
+    flush( crosstalker );
+    if ( held_count_ == 0 && _hasCredit( frame_size ) ) {
+      WriteResult result = crosstalker.sendObject( obj );
+      if ( result == WriteResult::Success )
+        _sent( frame_size );
+      return result;
+    }
+    return _hold( id, payload_size, ( std::is_same_v<T, Conflatable> || ... ),
+                  [&obj]( uint8_t *payload ) { util::serialize<T>( obj, payload ); } );
+  }
+
+  /*!
+   * Sends held frames in order as long as there is enough credit.
+   * @return The number of sent frames.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  size_t flush( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker )
+  {
+    size_t count = 0;
+    while ( held_count_ > 0 ) {
+      int16_t id = 0;
+      uint16_t payload_size = 0;
+      util::deserialize( &hold_buffer_[hold_start_], 2, id );
+      util::deserialize( &hold_buffer_[hold_start_ + 2], 2, payload_size );
+      // Includes the sequence counter, which the receiver counts as well
+      const size_t frame_size = crosstalker.frameSize( id, payload_size );
+      if ( !_hasCredit( frame_size ) )
+        break;
+      const uint8_t *payload = &hold_buffer_[hold_start_ + 4];
+      if ( crosstalker.sendFrame( id, payload_size, [payload, payload_size]( uint8_t *data ) {
+             std::memcpy( data, payload, payload_size );
+           } ) != WriteResult::Success )
+        break;
+      _sent( frame_size );
+      _remove( hold_start_, 4 + payload_size );
+      ++count;
+    }
+    return count;
+  }
+
+  /*!
+   * Reads the current frame as a credit report and sends held frames the new credit allows.
+   * @return ObjectIdMismatch if the current frame is not a credit report.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  ReadResult readCredit( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker )
+  {
+    if ( crosstalker.hasObject() &&
+         crosstalker.getObjectId() != static_cast<int16_t>( InternalObjectId::Credit ) )
+      return ReadResult::ObjectIdMismatch;
+    CreditReport report;
+    ReadResult result = crosstalker.readFrame( [&report]( int16_t, const uint8_t *payload, size_t size ) {
+      return report.deserialize( payload, size );
+    } );
+    if ( result != ReadResult::Success )
+      return result;
+    applyReport( report );
+    flush( crosstalker );
+    return ReadResult::Success;
+  }
+
+  //! Updates the credit from a report, e.g., if the report was received on another way.
+  void applyReport( const CreditReport &report )
+  {
+    // The receiver counted more than was sent with flow control, e.g., because of generic data or
+    // a restart of the sender. There can not be anything in flight then.
+    if ( static_cast<int32_t>( sent_bytes_ - report.received_bytes ) < 0 )
+      sent_bytes_ = report.received_bytes;
+    if ( static_cast<int32_t>( sent_frames_ - report.consumed_frames ) < 0 )
+      sent_frames_ = report.consumed_frames;
+    if ( report.idle && report_.idle && report.received_bytes == report_.received_bytes ) {
+      // Nothing arrived between two idle reports, so what was sent before the previous one was lost
+      const int32_t lost_bytes = static_cast<int32_t>( sent_at_report_ - report.received_bytes );
+      if ( lost_bytes > 0 ) {
+        sent_bytes_ -= lost_bytes;
+        statistics_.lost_bytes += lost_bytes;
+      }
+      const int32_t lost_frames = static_cast<int32_t>( frames_at_report_ - report.consumed_frames );
+      if ( lost_frames > 0 )
+        sent_frames_ -= lost_frames;
+    }
+    report_ = report;
+    sent_at_report_ = sent_bytes_;
+    frames_at_report_ = sent_frames_;
+  }
+
+  //! The number of bytes that can currently be sent.
+  uint32_t credit() const
+  {
+    const uint32_t in_flight = sent_bytes_ - report_.received_bytes;
+    return in_flight < report_.free_bytes ? report_.free_bytes - in_flight : 0;
+  }
+
+  size_t heldFrames() const { return held_count_; }
+
+  size_t heldBytes() const { return hold_end_ - hold_start_; }
+
+  const FlowControlStatistics &statistics() const { return statistics_; }
+
+  void resetStatistics() { statistics_ = {}; }
+
+private:
+  bool _hasCredit( size_t size ) const
+  {
+    const uint32_t in_flight = sent_bytes_ - report_.received_bytes;
+    // Frames larger than the receive buffer are sent when the receiver is idle to not block forever
+    if ( !( in_flight == 0 && report_.idle ) &&
+         ( in_flight > report_.free_bytes || size > report_.free_bytes - in_flight ) )
+      return false;
+    return report_.frame_window == CreditReport::NO_FRAME_LIMIT ||
+           sent_frames_ - report_.consumed_frames < report_.frame_window;
+  }
+
+  void _sent( size_t size )
+  {
+    sent_bytes_ += size;
+    ++sent_frames_;
+  }
+
+  template<typename Serializer>
+  WriteResult _hold( int16_t id, size_t payload_size, bool conflate, Serializer &&serialize )
+  {
+    bool conflated = false;
+    if ( conflate ) {
+      for ( size_t offset = hold_start_; offset < hold_end_; ) {
+        int16_t held_id = 0;
+        uint16_t held_size = 0;
+        util::deserialize( &hold_buffer_[offset], 2, held_id );
+        util::deserialize( &hold_buffer_[offset + 2], 2, held_size );
+        if ( held_id != id ) {
+          offset += 4 + held_size;
+          continue;
+        }
+        ++statistics_.conflated_frames;
+        if ( held_size == payload_size ) {
+          serialize( &hold_buffer_[offset + 4] );
+          return WriteResult::Success;
+        }
+        // Different size, e.g., a string changed. The newer object is appended instead.
+        _remove( offset, 4 + held_size );
+        conflated = true;
+        break;
+      }
+    }
+    if ( hold_end_ + 4 + payload_size > HOLD_BUFFER_SIZE && hold_start_ > 0 ) {
+      std::memmove( hold_buffer_.data(), &hold_buffer_[hold_start_], hold_end_ - hold_start_ );
+      hold_end_ -= hold_start_;
+      hold_start_ = 0;
+    }
+    if ( hold_end_ + 4 + payload_size > HOLD_BUFFER_SIZE ) {
+      ++statistics_.rejected_frames;
+      return WriteResult::NoCredit;
+    }
+    util::serialize( id, &hold_buffer_[hold_end_] );
+    util::serialize( static_cast<uint16_t>( payload_size ), &hold_buffer_[hold_end_ + 2] );
+    serialize( &hold_buffer_[hold_end_ + 4] );
+    hold_end_ += 4 + payload_size;
+    ++held_count_;
+    if ( !conflated )
+      ++statistics_.held_frames;
+    return WriteResult::Success;
+  }
+
+  void _remove( size_t offset, size_t length )
+  {
+    if ( offset == hold_start_ ) {
+      hold_start_ += length;
+    } else {
+      std::memmove( &hold_buffer_[offset], &hold_buffer_[offset + length], hold_end_ - offset - length );
+      hold_end_ -= length;
+    }
+    --held_count_;
+    if ( held_count_ == 0 ) {
+      hold_start_ = 0;
+      hold_end_ = 0;
+    }
+  }
+
+  std::array<uint8_t, HOLD_BUFFER_SIZE> hold_buffer_;
+  size_t hold_start_ = 0;
+  size_t hold_end_ = 0;
+  size_t held_count_ = 0;
+  CreditReport report_;
+  uint32_t sent_bytes_ = 0;
+  uint32_t sent_frames_ = 0;
+  // Counters when the last report was applied, everything sent before that should have arrived
+  uint32_t sent_at_report_ = 0;
+  uint32_t frames_at_report_ = 0;
+  FlowControlStatistics statistics_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_FLOW_CONTROL_HPP
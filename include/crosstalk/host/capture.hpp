@@ -0,0 +1,415 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_HOST_CAPTURE_HPP
+#define CROSSTALK_HOST_CAPTURE_HPP
+
+#ifndef CROSSTALK_CROSSTALKER_HPP
+  #error "Include crosstalk.hpp or crosstalk/crosstalker.hpp before including host/capture.hpp"
+#endif // CROSSTALK_CROSSTALKER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace crosstalk
+{
+
+/*!
+ * Capture file format (all values little-endian):
+ *   File header: 8 byte magic "CTCAP01\0", uint64 capture start in ns since the unix epoch,
+ *                uint32 sequence number of the file within a ring, uint32 reserved.
+ *   Records:     uint64 timestamp in ns since capture start, uint32 length, uint8 direction,
+ *                3 bytes reserved, followed by length bytes of raw stream data.
+ * Every file of a ring starts with a header and only contains complete records.
+ */
+enum class CaptureDirection : uint8_t { Read = 0, Write = 1 };
+
+struct CaptureFileHeader {
+  static constexpr size_t SIZE = 24;
+  static constexpr char MAGIC[8] = { 'C', 'T', 'C', 'A', 'P', '0', '1', '\0' };
+
+  uint64_t start_time_ns = 0;
+  uint32_t sequence = 0;
+
+  void encode( uint8_t *data ) const
+  {
+    std::memcpy( data, MAGIC, sizeof( MAGIC ) );
+    util::serialize( start_time_ns, data + 8 );
+    util::serialize( sequence, data + 16 );
+    util::serialize( uint32_t( 0 ), data + 20 );
+  }
+
+  //! Returns false if the data does not start with a valid capture file header.
+  bool decode( const uint8_t *data, size_t length )
+  {
+    if ( length < SIZE || std::memcmp( data, MAGIC, sizeof( MAGIC ) ) != 0 )
+      return false;
+    util::deserialize( data + 8, 8, start_time_ns );
+    util::deserialize( data + 16, 4, sequence );
+    return true;
+  }
+};
+
+struct CaptureRecordHeader {
+  static constexpr size_t SIZE = 16;
+
+  uint64_t timestamp_ns = 0;
+  uint32_t length = 0;
+  CaptureDirection direction = CaptureDirection::Read;
+
+  void encode( uint8_t *data ) const
+  {
+    util::serialize( timestamp_ns, data );
+    util::serialize( length, data + 8 );
+    data[12] = static_cast<uint8_t>( direction );
+    data[13] = data[14] = data[15] = 0;
+  }
+
+  bool decode( const uint8_t *data, size_t length_available )
+  {
+    if ( length_available < SIZE )
+      return false;
+    util::deserialize( data, 8, timestamp_ns );
+    util::deserialize( data + 8, 4, length );
+    direction = static_cast<CaptureDirection>( data[12] );
+    return true;
+  }
+};
+
+struct CaptureOptions {
+  //! Size of each of the two buffers. If the writer falls behind and the buffer is full, data is dropped.
+  size_t buffer_size = 1 << 20;
+  //! If > 0, files are rotated once they would exceed this size.
+  size_t max_file_size = 0;
+  //! Number of files in the ring if max_file_size > 0. The oldest file is overwritten.
+  size_t max_files = 4;
+  //! Consecutive chunks of the same direction within this window are merged into one record.
+  std::chrono::nanoseconds coalesce_window = std::chrono::milliseconds( 1 );
+  //! How often the background thread writes the buffered data to disk.
+  std::chrono::milliseconds flush_interval = std::chrono::milliseconds( 100 );
+};
+
+/*!
+ * Writes timestamped chunks of raw stream data to a capture file.
+ * append() only copies into the front buffer, the file is written by a background thread that
+ * swaps in the front buffer whenever it has finished writing the back buffer.
+ * If max_file_size is set, the capture is written as a ring of files path.0, path.1, ... that acts
+ * as a flight recorder keeping only the most recent data.
+ */
+class CaptureWriter
+{
+public:
+  explicit CaptureWriter( std::string path, const CaptureOptions &options = {} )
+      : path_( std::move( path ) ), options_( options ),
+        start_( std::chrono::steady_clock::now() ),
+        start_time_ns_( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::system_clock::now().time_since_epoch() )
+                            .count() )
+  {
+    front_.reserve( options_.buffer_size );
+    back_.reserve( options_.buffer_size );
+    if ( !_openNextFile() )
+      return;
+    open_ = true;
+    thread_ = std::thread( &CaptureWriter::_run, this );
+  }
+
+  ~CaptureWriter()
+  {
+    {
+      std::lock_guard<std::mutex> lock( mutex_ );
+      running_ = false;
+    }
+    cv_.notify_one();
+    if ( thread_.joinable() )
+      thread_.join();
+    if ( file_ != nullptr )
+      std::fclose( file_ );
+  }
+
+  CaptureWriter( const CaptureWriter & ) = delete;
+  CaptureWriter &operator=( const CaptureWriter & ) = delete;
+
+  //! Returns false if the capture file could not be opened.
+  bool isOpen() const { return open_; }
+
+  //! Records a chunk of data. Never blocks on disk I/O, drops the data if the buffer is full.
+  void append( CaptureDirection direction, const uint8_t *data, size_t length )
+  {
+    if ( length == 0 )
+      return;
+    const uint64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - start_ )
+                                   .count();
+    std::unique_lock<std::mutex> lock( mutex_ );
+    if ( last_record_ != NO_RECORD && last_direction_ == direction &&
+         timestamp - last_timestamp_ns_ <= static_cast<uint64_t>( options_.coalesce_window.count() ) &&
+         front_.size() + length <= options_.buffer_size ) {
+      // Extend the last record instead of paying for another record header
+      uint32_t record_length = 0;
+      util::deserialize( &front_[last_record_ + 8], 4, record_length );
+      util::serialize( static_cast<uint32_t>( record_length + length ), &front_[last_record_ + 8] );
+      front_.insert( front_.end(), data, data + length );
+      return;
+    }
+    if ( front_.size() + CaptureRecordHeader::SIZE + length > options_.buffer_size ) {
+      dropped_bytes_ += length;
+      last_record_ = NO_RECORD;
+      return;
+    }
+    last_record_ = front_.size();
+    last_direction_ = direction;
+    last_timestamp_ns_ = timestamp;
+    front_.resize( front_.size() + CaptureRecordHeader::SIZE );
+    CaptureRecordHeader{ timestamp, static_cast<uint32_t>( length ), direction }.encode(
+        &front_[last_record_] );
+    front_.insert( front_.end(), data, data + length );
+    if ( front_.size() > options_.buffer_size / 2 ) {
+      lock.unlock();
+      cv_.notify_one();
+    }
+  }
+
+  //! Number of bytes that were dropped because the writer thread could not keep up.
+  size_t droppedBytes() const { return dropped_bytes_; }
+
+  //! Number of bytes written to disk including headers.
+  size_t writtenBytes() const { return written_bytes_; }
+
+  //! Blocks until all data appended so far is written to disk.
+  void flush()
+  {
+    if ( !open_ )
+      return;
+    std::unique_lock<std::mutex> lock( mutex_ );
+    const uint64_t target = appended_generation_ + 1;
+    flush_requested_ = true;
+    cv_.notify_one();
+    flushed_cv_.wait( lock, [&]() { return flushed_generation_ >= target || !running_; } );
+  }
+
+  //! Path of the file with the given sequence number.
+  std::string filePath( uint32_t sequence ) const
+  {
+    if ( options_.max_file_size == 0 )
+      return path_;
+    return path_ + "." + std::to_string( sequence % options_.max_files );
+  }
+
+private:
+  static constexpr size_t NO_RECORD = static_cast<size_t>( -1 );
+
+  void _run()
+  {
+    std::unique_lock<std::mutex> lock( mutex_ );
+    while ( true ) {
+      cv_.wait_for( lock, options_.flush_interval, [this]() {
+        return !running_ || flush_requested_ || front_.size() > options_.buffer_size / 2;
+      } );
+      const bool stop = !running_;
+      const uint64_t generation = ++appended_generation_;
+      flush_requested_ = false;
+      std::swap( front_, back_ );
+      last_record_ = NO_RECORD;
+      lock.unlock();
+      _writeRecords( back_ );
+      back_.clear();
+      lock.lock();
+      flushed_generation_ = generation;
+      flushed_cv_.notify_all();
+      if ( stop )
+        return;
+    }
+  }
+
+  void _writeRecords( const std::vector<uint8_t> &buffer )
+  {
+    if ( file_ == nullptr )
+      return;
+    if ( options_.max_file_size == 0 ) {
+      _write( buffer.data(), buffer.size() );
+      std::fflush( file_ );
+      return;
+    }
+    // Rotate at record boundaries so every file of the ring can be decoded on its own
+    size_t offset = 0;
+    while ( offset < buffer.size() ) {
+      size_t end = offset;
+      CaptureRecordHeader header;
+      while ( end < buffer.size() && header.decode( &buffer[end], buffer.size() - end ) ) {
+        size_t record_size = CaptureRecordHeader::SIZE + header.length;
+        if ( file_size_ + ( end - offset ) + record_size > options_.max_file_size &&
+             ( end > offset || file_size_ > CaptureFileHeader::SIZE ) )
+          break;
+        end += record_size;
+      }
+      _write( &buffer[offset], end - offset );
+      offset = end;
+      if ( offset < buffer.size() && !_openNextFile() )
+        return;
+    }
+    std::fflush( file_ );
+  }
+
+  void _write( const uint8_t *data, size_t length )
+  {
+    if ( length == 0 )
+      return;
+    std::fwrite( data, 1, length, file_ );
+    file_size_ += length;
+    written_bytes_ += length;
+  }
+
+  bool _openNextFile()
+  {
+    if ( file_ != nullptr )
+      std::fclose( file_ );
+    file_ = std::fopen( filePath( sequence_ ).c_str(), "wb" );
+    if ( file_ == nullptr )
+      return false;
+    uint8_t header[CaptureFileHeader::SIZE];
+    CaptureFileHeader{ start_time_ns_, sequence_ }.encode( header );
+    ++sequence_;
+    file_size_ = 0;
+    _write( header, sizeof( header ) );
+    return true;
+  }
+
+  std::string path_;
+  CaptureOptions options_;
+  std::chrono::steady_clock::time_point start_;
+  uint64_t start_time_ns_;
+  bool open_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable flushed_cv_;
+  std::vector<uint8_t> front_;
+  size_t last_record_ = NO_RECORD;
+  CaptureDirection last_direction_ = CaptureDirection::Read;
+  uint64_t last_timestamp_ns_ = 0;
+  bool running_ = true;
+  bool flush_requested_ = false;
+  uint64_t appended_generation_ = 0;
+  uint64_t flushed_generation_ = 0;
+  std::atomic<size_t> dropped_bytes_{ 0 };
+
+  // Only accessed by the writer thread
+  std::vector<uint8_t> back_;
+  std::FILE *file_ = nullptr;
+  uint32_t sequence_ = 0;
+  size_t file_size_ = 0;
+  std::atomic<size_t> written_bytes_{ 0 };
+  std::thread thread_;
+};
+
+/*!
+ * Decorator that records all data read from, and optionally written to, the wrapped serial
+ * abstraction with the given CaptureWriter. The writer has to outlive the wrapper.
+ * For packet transports, the start markers of the frames in a packet are restored in the capture,
+ * so it can be decoded like the capture of a stream transport.
+ */
+class CaptureSerialWrapper : public crosstalk::SerialAbstraction
+{
+public:
+  CaptureSerialWrapper( std::unique_ptr<SerialAbstraction> serial, CaptureWriter &writer,
+                        bool record_writes = false )
+      : serial_( std::move( serial ) ), writer_( writer ), record_writes_( record_writes )
+  {
+  }
+
+  int available() const override { return serial_->available(); }
+
+  int read( uint8_t *data, size_t length ) override
+  {
+    int count = serial_->read( data, length );
+    if ( count > 0 )
+      writer_.append( CaptureDirection::Read, data, count );
+    return count;
+  }
+
+  bool write( const uint8_t *data, size_t length ) override
+  {
+    bool result = serial_->write( data, length );
+    if ( result && record_writes_ )
+      writer_.append( CaptureDirection::Write, data, length );
+    return result;
+  }
+
+  bool isPacketTransport() const override { return serial_->isPacketTransport(); }
+
+  size_t maxPacketSize() const override { return serial_->maxPacketSize(); }
+
+  bool sendPacket( const uint8_t *data, size_t length ) override
+  {
+    bool result = serial_->sendPacket( data, length );
+    if ( result && record_writes_ )
+      _appendPacket( CaptureDirection::Write, data, length, write_packet_ );
+    return result;
+  }
+
+  int receivePacket( uint8_t *data, size_t length ) override
+  {
+    int count = serial_->receivePacket( data, length );
+    if ( count > 0 )
+      _appendPacket( CaptureDirection::Read, data, count, read_packet_ );
+    return count;
+  }
+
+private:
+  //! Appends the frames of the packet with their start markers. Bytes that are no frame are kept.
+  void _appendPacket( CaptureDirection direction, const uint8_t *data, size_t length,
+                      std::vector<uint8_t> &buffer )
+  {
+    buffer.clear();
+    size_t offset = 0;
+    while ( length - offset >= 6 ) {
+      uint16_t size_field = 0;
+      std::memcpy( &size_field, data + offset + 2, 2 );
+      const size_t frame_size = detail::frameContentSize( le16tohost( size_field ) ) + 6;
+      if ( frame_size > length - offset )
+        break;
+      buffer.insert( buffer.end(), { 0x02, 0x42 } );
+      buffer.insert( buffer.end(), data + offset, data + offset + frame_size );
+      offset += frame_size;
+    }
+    buffer.insert( buffer.end(), data + offset, data + length );
+    writer_.append( direction, buffer.data(), buffer.size() );
+  }
+
+  std::unique_ptr<SerialAbstraction> serial_;
+  CaptureWriter &writer_;
+  bool record_writes_;
+  // Only used for packet transports, reads and writes may happen on different threads
+  std::vector<uint8_t> read_packet_;
+  std::vector<uint8_t> write_packet_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_CAPTURE_HPP
@@ -0,0 +1,197 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_HOST_CAPTURE_INDEX_HPP
+#define CROSSTALK_HOST_CAPTURE_INDEX_HPP
+
+#include "offline_decoder.hpp"
+#include <fstream>
+#include <limits>
+
+namespace crosstalk
+{
+
+/*!
+ * Index of all frames in a CaptureStream for random access by type and time.
+ *
+ * Index file format (all values little-endian):
+ *   Header:  8 byte magic "CTIDX02\0", uint64 frame count n, uint64 size of the indexed stream.
+ *   Columns: uint64 offset[n], uint64 timestamp_ns[n], int16 id[n], uint16 size_field[n].
+ * The size field is encoded as in the frame: the payload size with the size of the sequence counter
+ * in the upper two bits.
+ * Frames are in stream order, so the timestamp column is sorted and time ranges are found by binary
+ * search. Queries by id only touch the 2 byte id column of the matching time range.
+ */
+class CaptureIndex
+{
+public:
+  static constexpr size_t HEADER_SIZE = 24;
+  static constexpr char MAGIC[8] = { 'C', 'T', 'I', 'D', 'X', '0', '2', '\0' };
+
+  CaptureIndex() = default;
+
+  //! Indexes the stream using an OfflineDecoder with the given options.
+  static CaptureIndex build( const CaptureStream &stream, const OfflineDecoderOptions &options = {} )
+  {
+    CaptureIndex index;
+    OfflineDecoder decoder( options );
+    std::vector<FrameInfo> frames = decoder.findFrames( stream );
+    index.stream_size_ = stream.size();
+    index.offsets_.reserve( frames.size() );
+    index.timestamps_.reserve( frames.size() );
+    index.ids_.reserve( frames.size() );
+    index.size_fields_.reserve( frames.size() );
+    for ( const auto &frame : frames ) {
+      index.offsets_.push_back( frame.offset );
+      index.timestamps_.push_back( frame.timestamp_ns );
+      index.ids_.push_back( frame.id );
+      index.size_fields_.push_back( static_cast<uint16_t>( frame.payload_size | frame.sequence_bytes << 14 ) );
+    }
+    return index;
+  }
+
+  //! Default path of the index for a capture file.
+  static std::string sidecarPath( const std::string &capture_path ) { return capture_path + ".idx"; }
+
+  bool save( const std::string &path ) const
+  {
+    std::vector<uint8_t> data( HEADER_SIZE + size() * ( 8 + 8 + 2 + 2 ) );
+    uint8_t *out = data.data();
+    std::memcpy( out, MAGIC, sizeof( MAGIC ) );
+    util::serialize( uint64_t( size() ), out + 8 );
+    util::serialize( stream_size_, out + 16 );
+    out += HEADER_SIZE;
+    out = _writeColumn( offsets_, out );
+    out = _writeColumn( timestamps_, out );
+    out = _writeColumn( ids_, out );
+    _writeColumn( size_fields_, out );
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    file.write( reinterpret_cast<const char *>( data.data() ), data.size() );
+    return static_cast<bool>( file );
+  }
+
+  //! Returns false if the file can not be read or is not a valid index.
+  bool load( const std::string &path )
+  {
+    std::ifstream file( path, std::ios::binary );
+    uint8_t header[HEADER_SIZE];
+    if ( !file.read( reinterpret_cast<char *>( header ), HEADER_SIZE ) ||
+         std::memcmp( header, MAGIC, sizeof( MAGIC ) ) != 0 )
+      return false;
+    uint64_t count = 0;
+    util::deserialize( header + 8, 8, count );
+    util::deserialize( header + 16, 8, stream_size_ );
+    if ( count > stream_size_ / 8 )
+      return false; // Every frame has at least 8 bytes
+    std::vector<uint8_t> data( count * ( 8 + 8 + 2 + 2 ) );
+    if ( !file.read( reinterpret_cast<char *>( data.data() ), data.size() ) )
+      return false;
+    const uint8_t *in = data.data();
+    in = _readColumn( in, count, offsets_ );
+    in = _readColumn( in, count, timestamps_ );
+    in = _readColumn( in, count, ids_ );
+    _readColumn( in, count, size_fields_ );
+    return true;
+  }
+
+  size_t size() const { return offsets_.size(); }
+
+  //! Size of the indexed stream. Can be used to check that an index belongs to a capture.
+  uint64_t streamSize() const { return stream_size_; }
+
+  FrameInfo frame( size_t i ) const
+  {
+    return { offsets_[i], timestamps_[i], ids_[i],
+             static_cast<uint16_t>( size_fields_[i] & detail::FRAME_SIZE_MASK ),
+             static_cast<uint8_t>( detail::frameSequenceBytes( size_fields_[i] ) ) };
+  }
+
+  //! Returns the index of the first frame at or after the given time.
+  size_t lowerBound( uint64_t timestamp_ns ) const
+  {
+    return std::lower_bound( timestamps_.begin(), timestamps_.end(), timestamp_ns ) -
+           timestamps_.begin();
+  }
+
+  //! Frames with the given id and a timestamp in [begin_ns, end_ns).
+  std::vector<FrameInfo> query( int16_t id, uint64_t begin_ns = 0,
+                                uint64_t end_ns = std::numeric_limits<uint64_t>::max() ) const
+  {
+    std::vector<FrameInfo> result;
+    for ( size_t i = lowerBound( begin_ns ), end = lowerBound( end_ns ); i < end; ++i ) {
+      if ( ids_[i] == id )
+        result.push_back( frame( i ) );
+    }
+    return result;
+  }
+
+  /*!
+   * Decodes all frames of type T with a timestamp in [begin_ns, end_ns) from the indexed stream.
+   * Frames whose payload does not match the type are skipped.
+   */
+  template<typename T>
+  std::vector<DecodedObject<T>> read( const CaptureStream &stream, uint64_t begin_ns = 0,
+                                      uint64_t end_ns = std::numeric_limits<uint64_t>::max() ) const
+  {
+    std::vector<DecodedObject<T>> result;
+    std::vector<uint8_t> scratch;
+    for ( const auto &frame : query( object_id<T>(), begin_ns, end_ns ) ) {
+      const uint8_t *payload = stream.contiguous( frame.offset + 6, frame.payload_size );
+      if ( payload == nullptr ) {
+        scratch.resize( frame.payload_size );
+        if ( !stream.copy( frame.offset + 6, frame.payload_size, scratch.data() ) )
+          break; // The index does not belong to this stream
+        payload = scratch.data();
+      }
+      T obj;
+      if ( util::deserialize( payload, frame.payload_size, obj ) != frame.payload_size )
+        continue;
+      result.push_back( { frame, std::move( obj ) } );
+    }
+    return result;
+  }
+
+private:
+  template<typename T>
+  static uint8_t *_writeColumn( const std::vector<T> &column, uint8_t *out )
+  {
+    for ( const T &value : column ) out += util::serialize( value, out );
+    return out;
+  }
+
+  template<typename T>
+  static const uint8_t *_readColumn( const uint8_t *in, size_t count, std::vector<T> &column )
+  {
+    column.resize( count );
+    for ( T &value : column ) in += util::deserialize( in, sizeof( T ), value );
+    return in;
+  }
+
+  std::vector<uint64_t> offsets_;
+  std::vector<uint64_t> timestamps_;
+  std::vector<int16_t> ids_;
+  std::vector<uint16_t> size_fields_;
+  uint64_t stream_size_ = 0;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_CAPTURE_INDEX_HPP
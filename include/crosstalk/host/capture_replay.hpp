@@ -0,0 +1,219 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_HOST_CAPTURE_REPLAY_HPP
+#define CROSSTALK_HOST_CAPTURE_REPLAY_HPP
+
+#include "capture.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crosstalk
+{
+
+struct CaptureRecord {
+  uint64_t timestamp_ns = 0;
+  CaptureDirection direction = CaptureDirection::Read;
+  const uint8_t *data = nullptr;
+  uint32_t length = 0;
+};
+
+/*!
+ * Read-only memory mapping of a capture file written by the CaptureWriter.
+ * Records point directly into the mapping and are valid as long as the CaptureFile exists.
+ */
+class CaptureFile
+{
+public:
+  CaptureFile() = default;
+
+  explicit CaptureFile( const std::string &path ) { open( path ); }
+
+  ~CaptureFile() { close(); }
+
+  CaptureFile( const CaptureFile & ) = delete;
+  CaptureFile &operator=( const CaptureFile & ) = delete;
+
+  //! Maps the file. Returns false if it can not be opened or is not a capture file.
+  bool open( const std::string &path )
+  {
+    close();
+    int fd = ::open( path.c_str(), O_RDONLY );
+    if ( fd < 0 )
+      return false;
+    struct stat st {};
+    if ( fstat( fd, &st ) != 0 || st.st_size < static_cast<off_t>( CaptureFileHeader::SIZE ) ) {
+      ::close( fd );
+      return false;
+    }
+    void *mapping = mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd ); // The mapping stays valid
+    if ( mapping == MAP_FAILED )
+      return false;
+    madvise( mapping, st.st_size, MADV_SEQUENTIAL );
+    data_ = static_cast<const uint8_t *>( mapping );
+    size_ = st.st_size;
+    if ( !header_.decode( data_, size_ ) ) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close()
+  {
+    if ( data_ != nullptr )
+      munmap( const_cast<uint8_t *>( data_ ), size_ );
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  bool isOpen() const { return data_ != nullptr; }
+
+  const CaptureFileHeader &header() const { return header_; }
+
+  //! The complete mapped file including headers.
+  const uint8_t *data() const { return data_; }
+
+  size_t size() const { return size_; }
+
+  //! Offset of the first record. Pass to nextRecord() to iterate all records.
+  static constexpr size_t firstRecordOffset() { return CaptureFileHeader::SIZE; }
+
+  /*!
+   * Reads the record at offset and advances offset to the next record.
+   * @return False at the end of the file or if the record is truncated.
+   */
+  bool nextRecord( size_t &offset, CaptureRecord &record ) const
+  {
+    CaptureRecordHeader header;
+    if ( offset >= size_ || !header.decode( data_ + offset, size_ - offset ) )
+      return false;
+    if ( header.length > size_ - offset - CaptureRecordHeader::SIZE )
+      return false; // Truncated, e.g., the capture was not closed properly
+    record.timestamp_ns = header.timestamp_ns;
+    record.direction = header.direction;
+    record.data = data_ + offset + CaptureRecordHeader::SIZE;
+    record.length = header.length;
+    offset += CaptureRecordHeader::SIZE + header.length;
+    return true;
+  }
+
+private:
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+  CaptureFileHeader header_;
+};
+
+enum class ReplayMode : uint8_t {
+  //! Serve the data as fast as it is read.
+  MaxSpeed,
+  //! Only make records available once their recorded timestamp (divided by the speed) has passed.
+  Timed,
+};
+
+/*!
+ * Serial abstraction that replays the data of a CaptureFile, e.g., to run the CrossTalker decode
+ * path on field captures. read() copies straight from the mapping into the caller's buffer.
+ * Writes are discarded. The CaptureFile has to outlive the wrapper.
+ */
+class ReplaySerialWrapper : public crosstalk::SerialAbstraction
+{
+public:
+  explicit ReplaySerialWrapper( const CaptureFile &file, ReplayMode mode = ReplayMode::MaxSpeed,
+                                double speed = 1.0,
+                                CaptureDirection direction = CaptureDirection::Read )
+      : file_( file ), mode_( mode ), speed_( speed ), direction_( direction )
+  {
+  }
+
+  int available() const override
+  {
+    if ( record_offset_ == record_.length && !_nextRecord() )
+      return 0;
+    if ( mode_ == ReplayMode::Timed && !_isDue( record_ ) )
+      return 0;
+    return static_cast<int>( record_.length - record_offset_ );
+  }
+
+  int read( uint8_t *data, size_t length ) override
+  {
+    size_t count = std::min<size_t>( length, std::max( available(), 0 ) );
+    std::memcpy( data, record_.data + record_offset_, count );
+    record_offset_ += count;
+    replayed_bytes_ += count;
+    return static_cast<int>( count );
+  }
+
+  bool write( const uint8_t *, size_t ) override { return true; }
+
+  //! True once all records have been read.
+  bool finished() const { return record_offset_ == record_.length && !_nextRecord(); }
+
+  //! Timestamp of the record that is currently replayed.
+  uint64_t timestampNs() const { return record_.timestamp_ns; }
+
+  size_t replayedBytes() const { return replayed_bytes_; }
+
+private:
+  bool _nextRecord() const
+  {
+    CaptureRecord record;
+    while ( file_.nextRecord( file_offset_, record ) ) {
+      if ( record.direction != direction_ || record.length == 0 )
+        continue;
+      record_ = record;
+      record_offset_ = 0;
+      return true;
+    }
+    return false;
+  }
+
+  bool _isDue( const CaptureRecord &record ) const
+  {
+    const auto now = std::chrono::steady_clock::now();
+    if ( !started_ ) {
+      // Align the first replayed record with the current time
+      start_ = now - std::chrono::nanoseconds( static_cast<int64_t>( record.timestamp_ns / speed_ ) );
+      started_ = true;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( now - start_ );
+    return elapsed.count() * speed_ >= static_cast<double>( record.timestamp_ns );
+  }
+
+  const CaptureFile &file_;
+  ReplayMode mode_;
+  double speed_;
+  CaptureDirection direction_;
+  // Advancing through the file is part of available() which is const in the interface
+  mutable size_t file_offset_ = CaptureFile::firstRecordOffset();
+  mutable CaptureRecord record_;
+  mutable size_t record_offset_ = 0;
+  mutable bool started_ = false;
+  mutable std::chrono::steady_clock::time_point start_;
+  size_t replayed_bytes_ = 0;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_CAPTURE_REPLAY_HPP
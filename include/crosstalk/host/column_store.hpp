@@ -0,0 +1,306 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_HOST_COLUMN_STORE_HPP
+#define CROSSTALK_HOST_COLUMN_STORE_HPP
+
+#include "offline_decoder.hpp"
+#include <array>
+#include <tuple>
+
+namespace crosstalk
+{
+namespace detail
+{
+template<typename Members>
+struct ColumnTraits;
+
+template<typename... Ms>
+struct ColumnTraits<refl::type_list<Ms...>> {
+  using Columns = std::tuple<std::vector<std::remove_cv_t<typename Ms::value_type>>...>;
+  static constexpr bool FIXED_LAYOUT = ( std::is_scalar_v<typename Ms::value_type> && ... );
+  //! Serialized size of the fields, only meaningful if FIXED_LAYOUT.
+  static constexpr std::array<size_t, sizeof...( Ms )> SIZES = { sizeof( typename Ms::value_type )... };
+
+  static constexpr size_t offset( size_t index )
+  {
+    size_t offset = 0;
+    for ( size_t i = 0; i < index; ++i ) offset += SIZES[i];
+    return offset;
+  }
+};
+} // namespace detail
+
+/*!
+ * Struct-of-arrays storage for many objects of type T with one column vector per field.
+ * Payloads are decoded directly into the columns without constructing T. For types that only have
+ * scalar fields, every field is at a fixed offset in the payload, so frames that are adjacent in
+ * memory are decoded column by column with a strided gather.
+ */
+template<typename T>
+class ColumnStore
+{
+  using Members = typename refl::type_descriptor<T>::member_types;
+  using Traits = detail::ColumnTraits<Members>;
+
+public:
+  static_assert( refl::is_reflectable<T>(), "Type must be reflectable." );
+
+  using Columns = typename Traits::Columns;
+  static constexpr size_t COLUMN_COUNT = Members::size;
+  //! True if all fields are scalars and the payload always has FIXED_PAYLOAD_SIZE bytes.
+  static constexpr bool FIXED_LAYOUT = Traits::FIXED_LAYOUT;
+  static constexpr size_t FIXED_PAYLOAD_SIZE = Traits::offset( COLUMN_COUNT );
+
+  size_t size() const { return size_; }
+
+  //! The column vector of the I-th field.
+  template<size_t I>
+  const auto &column() const
+  {
+    return std::get<I>( columns_ );
+  }
+
+  const Columns &columns() const { return columns_; }
+
+  //! Names of the fields in column order.
+  static std::array<const char *, COLUMN_COUNT> columnNames()
+  {
+    return _columnNames( std::make_index_sequence<COLUMN_COUNT>{} );
+  }
+
+  void reserve( size_t count ) { _reserve( count, std::make_index_sequence<COLUMN_COUNT>{} ); }
+
+  void clear()
+  {
+    _clear( std::make_index_sequence<COLUMN_COUNT>{} );
+    size_ = 0;
+  }
+
+  //! Decodes one payload. Returns false and leaves the store unchanged if it does not match T.
+  bool append( const uint8_t *payload, size_t length )
+  {
+    if constexpr ( FIXED_LAYOUT ) {
+      if ( length != FIXED_PAYLOAD_SIZE )
+        return false;
+      appendStrided( payload, FIXED_PAYLOAD_SIZE, 1 );
+      return true;
+    } else {
+      return _append( payload, length, std::make_index_sequence<COLUMN_COUNT>{} );
+    }
+  }
+
+  /*!
+   * Decodes count payloads where payload i starts at first_payload + i * stride, e.g., a run of
+   * adjacent frames with stride 8 + FIXED_PAYLOAD_SIZE. Only available for fixed layout types.
+   */
+  void appendStrided( const uint8_t *first_payload, size_t stride, size_t count )
+  {
+    static_assert( FIXED_LAYOUT, "Strided decoding requires a type with only scalar fields." );
+    _appendStrided( first_payload, stride, count, std::make_index_sequence<COLUMN_COUNT>{} );
+    size_ += count;
+  }
+
+  //! Decodes count payloads of FIXED_PAYLOAD_SIZE bytes at the given addresses, e.g., non-adjacent frames.
+  void appendGather( const uint8_t *const *payloads, size_t count )
+  {
+    static_assert( FIXED_LAYOUT, "Gathered decoding requires a type with only scalar fields." );
+    _appendGather( payloads, count, std::make_index_sequence<COLUMN_COUNT>{} );
+    size_ += count;
+  }
+
+  //! Reassembles the i-th object.
+  T row( size_t i ) const
+  {
+    T obj;
+    _row( i, obj, std::make_index_sequence<COLUMN_COUNT>{} );
+    return obj;
+  }
+
+private:
+  template<size_t... Is>
+  static std::array<const char *, COLUMN_COUNT> _columnNames( std::index_sequence<Is...> )
+  {
+    return { refl::trait::get_t<Is, Members>::name.c_str()... };
+  }
+
+  template<size_t... Is>
+  void _reserve( size_t count, std::index_sequence<Is...> )
+  {
+    ( std::get<Is>( columns_ ).reserve( count ), ... );
+  }
+
+  template<size_t... Is>
+  void _clear( std::index_sequence<Is...> )
+  {
+    ( std::get<Is>( columns_ ).clear(), ... );
+  }
+
+  template<size_t... Is>
+  bool _append( const uint8_t *payload, size_t length, std::index_sequence<Is...> )
+  {
+    size_t offset = 0;
+    ( ( offset += util::deserialize( payload + offset, static_cast<int>( length - offset ),
+                                     std::get<Is>( columns_ ).emplace_back() ) ),
+      ... );
+    if ( offset != length ) {
+      ( std::get<Is>( columns_ ).pop_back(), ... );
+      return false;
+    }
+    ++size_;
+    return true;
+  }
+
+  template<size_t I>
+  void _gatherColumn( const uint8_t *first_payload, size_t stride, size_t count )
+  {
+    auto &column = std::get<I>( columns_ );
+    using Value = typename std::decay_t<decltype( column )>::value_type;
+    const size_t start = column.size();
+    column.resize( start + count );
+    Value *out = column.data() + start;
+    const uint8_t *in = first_payload + Traits::offset( I );
+    for ( size_t i = 0; i < count; ++i, in += stride ) util::deserialize( in, sizeof( Value ), out[i] );
+  }
+
+  template<size_t... Is>
+  void _appendStrided( const uint8_t *first_payload, size_t stride, size_t count,
+                       std::index_sequence<Is...> )
+  {
+    ( _gatherColumn<Is>( first_payload, stride, count ), ... );
+  }
+
+  template<size_t I>
+  void _gatherColumn( const uint8_t *const *payloads, size_t count )
+  {
+    auto &column = std::get<I>( columns_ );
+    using Value = typename std::decay_t<decltype( column )>::value_type;
+    const size_t start = column.size();
+    column.resize( start + count );
+    Value *out = column.data() + start;
+    for ( size_t i = 0; i < count; ++i )
+      util::deserialize( payloads[i] + Traits::offset( I ), sizeof( Value ), out[i] );
+  }
+
+  template<size_t... Is>
+  void _appendGather( const uint8_t *const *payloads, size_t count, std::index_sequence<Is...> )
+  {
+    ( _gatherColumn<Is>( payloads, count ), ... );
+  }
+
+  template<size_t... Is>
+  void _row( size_t i, T &obj, std::index_sequence<Is...> ) const
+  {
+    ( ( refl::trait::get_t<Is, Members>{}( obj ) = std::get<Is>( columns_ )[i] ), ... );
+  }
+
+  Columns columns_;
+  size_t size_ = 0;
+};
+
+/*!
+ * Decodes the frames of type T into the store. Frames with other ids or mismatching payloads are
+ * skipped. For fixed layout types, runs of adjacent frames are decoded with strided gathers and
+ * the remaining frames are collected in batches and decoded with indexed gathers.
+ * @return The number of decoded objects.
+ */
+template<typename T>
+size_t readObjects( const CaptureStream &stream, const std::vector<FrameInfo> &frames,
+                    ColumnStore<T> &store )
+{
+  constexpr int16_t id = object_id<T>();
+  const size_t initial_size = store.size();
+  store.reserve( initial_size + std::count_if( frames.begin(), frames.end(), [id]( const FrameInfo &frame ) {
+                   return frame.id == id;
+                 } ) );
+  std::vector<uint8_t> scratch;
+  if constexpr ( ColumnStore<T>::FIXED_LAYOUT ) {
+    constexpr size_t payload_size = ColumnStore<T>::FIXED_PAYLOAD_SIZE;
+    constexpr size_t frame_size = 8 + payload_size;
+    constexpr size_t BATCH_SIZE = 1024;
+    std::vector<const uint8_t *> batch;
+    batch.reserve( BATCH_SIZE );
+    // Payloads that span capture records are copied, reserve so the pointers stay valid
+    scratch.reserve( BATCH_SIZE * payload_size );
+    auto flush = [&]() {
+      store.appendGather( batch.data(), batch.size() );
+      batch.clear();
+      scratch.clear();
+    };
+    for ( size_t i = 0; i < frames.size(); ) {
+      const FrameInfo &frame = frames[i];
+      if ( frame.id != id || frame.payload_size != payload_size ) {
+        ++i;
+        continue;
+      }
+      // Frames with a sequence counter have a different stride and are never part of a run
+      size_t run = 1;
+      while ( frame.sequence_bytes == 0 && i + run < frames.size() && frames[i + run].id == id &&
+              frames[i + run].payload_size == payload_size && frames[i + run].sequence_bytes == 0 &&
+              frames[i + run].offset == frame.offset + run * frame_size )
+        ++run;
+      const uint8_t *data = stream.contiguous( frame.offset, run * frame_size );
+      if ( run >= 16 && data != nullptr ) {
+        flush();
+        store.appendStrided( data + 6, frame_size, run );
+        i += run;
+        continue;
+      }
+      const uint8_t *payload = stream.contiguous( frame.offset + 6, payload_size );
+      if ( payload == nullptr ) {
+        scratch.resize( scratch.size() + payload_size );
+        payload = scratch.data() + scratch.size() - payload_size;
+        stream.copy( frame.offset + 6, payload_size, const_cast<uint8_t *>( payload ) );
+      }
+      batch.push_back( payload );
+      if ( batch.size() == BATCH_SIZE )
+        flush();
+      ++i;
+    }
+    flush();
+  } else {
+    for ( const auto &frame : frames ) {
+      if ( frame.id != id )
+        continue;
+      const uint8_t *payload = stream.contiguous( frame.offset + 6, frame.payload_size );
+      if ( payload == nullptr ) {
+        scratch.resize( frame.payload_size );
+        stream.copy( frame.offset + 6, frame.payload_size, scratch.data() );
+        payload = scratch.data();
+      }
+      store.append( payload, frame.payload_size );
+    }
+  }
+  return store.size() - initial_size;
+}
+
+//! Decodes the frames of type T into a new ColumnStore.
+template<typename T>
+ColumnStore<T> readObjects( const CaptureStream &stream, const std::vector<FrameInfo> &frames )
+{
+  ColumnStore<T> store;
+  readObjects( stream, frames, store );
+  return store;
+}
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_COLUMN_STORE_HPP
@@ -0,0 +1,409 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_HOST_OFFLINE_DECODER_HPP
+#define CROSSTALK_HOST_OFFLINE_DECODER_HPP
+
+#include "capture_replay.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <variant>
+
+namespace crosstalk
+{
+
+/*!
+ * Read-only view of a raw byte stream as one contiguous range of offsets.
+ * The stream is either a single buffer, e.g., a memory-mapped dump of a serial port, or the records
+ * of one direction of a CaptureFile. No data is copied, the underlying memory has to outlive the
+ * stream.
+ */
+class CaptureStream
+{
+public:
+  CaptureStream( const uint8_t *data, size_t size )
+  {
+    if ( size > 0 )
+      segments_.push_back( { 0, data, size, 0 } );
+    size_ = size;
+  }
+
+  explicit CaptureStream( const CaptureFile &file, CaptureDirection direction = CaptureDirection::Read )
+  {
+    size_t offset = CaptureFile::firstRecordOffset();
+    CaptureRecord record;
+    while ( file.nextRecord( offset, record ) ) {
+      if ( record.direction != direction || record.length == 0 )
+        continue;
+      segments_.push_back( { size_, record.data, record.length, record.timestamp_ns } );
+      size_ += record.length;
+    }
+  }
+
+  uint64_t size() const { return size_; }
+
+  //! Copies length bytes starting at offset. Returns false if the range exceeds the stream.
+  bool copy( uint64_t offset, size_t length, uint8_t *out ) const
+  {
+    if ( offset + length > size_ )
+      return false;
+    for ( size_t index = _segmentIndex( offset ); length > 0; ++index ) {
+      const Segment &segment = segments_[index];
+      size_t start = offset - segment.offset;
+      size_t count = std::min( length, segment.length - start );
+      std::memcpy( out, segment.data + start, count );
+      out += count;
+      offset += count;
+      length -= count;
+    }
+    return true;
+  }
+
+  //! Returns a pointer to the range if it lies within a single segment, nullptr otherwise.
+  const uint8_t *contiguous( uint64_t offset, size_t length ) const
+  {
+    if ( offset + length > size_ )
+      return nullptr;
+    const Segment &segment = segments_[_segmentIndex( offset )];
+    if ( offset + length > segment.offset + segment.length )
+      return nullptr;
+    return segment.data + ( offset - segment.offset );
+  }
+
+  //! Timestamp of the capture record containing the byte at offset. 0 for raw streams.
+  uint64_t timestampNs( uint64_t offset ) const
+  {
+    return offset < size_ ? segments_[_segmentIndex( offset )].timestamp_ns : 0;
+  }
+
+  /*!
+   * Returns the offset of the next 0x02 0x42 start marker that begins in [begin, end).
+   * Returns end if there is none.
+   */
+  uint64_t findMarker( uint64_t begin, uint64_t end ) const
+  {
+    end = std::min( end, size_ );
+    if ( begin >= end )
+      return end;
+    size_t index = _segmentIndex( begin );
+    while ( begin < end ) {
+      const Segment &segment = segments_[index];
+      const size_t start = begin - segment.offset;
+      const size_t stop = std::min<uint64_t>( segment.length, end - segment.offset );
+      const void *hit = std::memchr( segment.data + start, 0x02, stop - start );
+      if ( hit == nullptr ) {
+        begin = segment.offset + segment.length;
+        ++index;
+        continue;
+      }
+      const size_t hit_index = static_cast<const uint8_t *>( hit ) - segment.data;
+      uint64_t candidate = segment.offset + hit_index;
+      if ( hit_index + 1 < segment.length ) {
+        if ( segment.data[hit_index + 1] == 0x42 )
+          return candidate;
+      } else if ( index + 1 < segments_.size() && segments_[index + 1].data[0] == 0x42 ) {
+        return candidate;
+      }
+      begin = candidate + 1;
+      if ( hit_index + 1 == segment.length )
+        ++index;
+    }
+    return end;
+  }
+
+private:
+  struct Segment {
+    uint64_t offset;
+    const uint8_t *data;
+    size_t length;
+    uint64_t timestamp_ns;
+  };
+
+  size_t _segmentIndex( uint64_t offset ) const
+  {
+    auto it = std::upper_bound(
+        segments_.begin(), segments_.end(), offset,
+        []( uint64_t value, const Segment &segment ) { return value < segment.offset; } );
+    return it - segments_.begin() - 1;
+  }
+
+  std::vector<Segment> segments_;
+  uint64_t size_ = 0;
+};
+
+//! Location of a CRC-valid frame in a CaptureStream.
+struct FrameInfo {
+  //! Stream offset of the start marker.
+  uint64_t offset = 0;
+  uint64_t timestamp_ns = 0;
+  int16_t id = 0;
+  uint16_t payload_size = 0;
+  //! Bytes of the sequence counter behind the payload, see CrossTalker::setSequenceNumbers.
+  uint8_t sequence_bytes = 0;
+
+  //! Stream offset of the first byte after the frame.
+  uint64_t end() const { return offset + 8 + payload_size + sequence_bytes; }
+};
+
+template<typename... Ts>
+struct DecodedObject {
+  FrameInfo frame;
+  std::variant<Ts...> object;
+};
+
+struct OfflineDecoderOptions {
+  //! Size of the chunks the stream is split into. Frames are assigned to the chunk they start in.
+  size_t chunk_size = 4 << 20;
+  //! Number of worker threads. 0 uses one per hardware thread.
+  unsigned threads = 0;
+  //! Headers announcing a larger payload are treated as noise without checking the CRC.
+  uint16_t max_payload_size = 0xFFFF;
+};
+
+struct OfflineDecoderStatistics {
+  //! CRC-valid frames found in the stream.
+  size_t frames = 0;
+  size_t decoded = 0;
+  //! Valid frames with an id that is not in the list of decoded types.
+  size_t unknown_ids = 0;
+  //! Valid frames whose payload did not match the size of the type with their id.
+  size_t size_mismatches = 0;
+  //! Bytes outside of valid frames, e.g., text output or corrupted frames.
+  uint64_t skipped_bytes = 0;
+};
+
+/*!
+ * Decodes large captures using all cores.
+ * The stream is split into chunks that are scanned in parallel. Each chunk resynchronizes at the
+ * first start marker followed by a valid header and CRC, and frames are owned by the chunk they
+ * start in, even if they extend into the next one. When the chunk results are stitched in order,
+ * frames found inside a frame straddling the chunk boundary are discarded, so the result is the
+ * same as scanning the stream sequentially.
+ * Unlike the CrossTalker, a marker with an invalid CRC only skips the marker, not the announced
+ * frame length, since there is no need to bound the work on a microcontroller.
+ */
+class OfflineDecoder
+{
+public:
+  explicit OfflineDecoder( const OfflineDecoderOptions &options = {} ) : options_( options )
+  {
+    if ( options_.chunk_size == 0 )
+      options_.chunk_size = 1;
+    if ( options_.threads == 0 )
+      options_.threads = std::max( 1u, std::thread::hardware_concurrency() );
+  }
+
+  //! Returns all valid frames in the stream in stream order.
+  std::vector<FrameInfo> findFrames( const CaptureStream &stream )
+  {
+    statistics_ = {};
+    const size_t chunk_count = ( stream.size() + options_.chunk_size - 1 ) / options_.chunk_size;
+    std::vector<std::vector<FrameInfo>> chunks( chunk_count );
+    _parallelFor( chunk_count, [&]( size_t i ) {
+      const uint64_t begin = i * options_.chunk_size;
+      const uint64_t end = std::min<uint64_t>( begin + options_.chunk_size, stream.size() );
+      chunks[i] = _scan( stream, begin, end );
+    } );
+
+    std::vector<FrameInfo> frames;
+    uint64_t covered_until = 0; // End of the last accepted frame
+    for ( size_t i = 0; i < chunk_count; ++i ) {
+      const std::vector<FrameInfo> &chunk = chunks[i];
+      auto it = std::lower_bound(
+          chunk.begin(), chunk.end(), covered_until,
+          []( const FrameInfo &frame, uint64_t offset ) { return frame.offset < offset; } );
+      if ( it == chunk.begin() || std::prev( it )->end() <= covered_until ) {
+        // The chunk was in sync with the sequential scan at covered_until
+        frames.insert( frames.end(), it, chunk.end() );
+      } else {
+        // The chunk found a frame overlapping the end of the previous frame, rescan until both agree
+        const uint64_t chunk_end = std::min<uint64_t>( ( i + 1 ) * options_.chunk_size, stream.size() );
+        std::vector<uint8_t> scratch;
+        uint64_t position = covered_until;
+        while ( position < chunk_end ) {
+          FrameInfo frame;
+          position = _nextFrame( stream, position, chunk_end, frame, scratch );
+          if ( position >= chunk_end )
+            break;
+          while ( it != chunk.end() && it->offset < frame.offset ) ++it;
+          if ( it != chunk.end() && it->offset == frame.offset ) {
+            frames.insert( frames.end(), it, chunk.end() );
+            break;
+          }
+          frames.push_back( frame );
+          position = frame.end();
+        }
+      }
+      if ( !frames.empty() )
+        covered_until = std::max( covered_until, frames.back().end() );
+    }
+
+    statistics_.frames = frames.size();
+    statistics_.skipped_bytes = stream.size();
+    for ( const auto &frame : frames ) statistics_.skipped_bytes -= frame.end() - frame.offset;
+    return frames;
+  }
+
+  /*!
+   * Finds all valid frames and decodes the ones with an id of one of the given types in parallel.
+   * Frames with other ids or a payload that does not match the type are counted and skipped.
+   */
+  template<typename... Ts>
+  std::vector<DecodedObject<Ts...>> decode( const CaptureStream &stream )
+  {
+    std::vector<FrameInfo> frames = findFrames( stream );
+    // Split into at most one range per chunk to keep the per-range overhead low
+    const size_t frames_per_range = std::max<size_t>(
+        1024, ( frames.size() + 4 * options_.threads - 1 ) / ( 4 * options_.threads ) );
+    const size_t range_count = ( frames.size() + frames_per_range - 1 ) / frames_per_range;
+    std::vector<std::vector<DecodedObject<Ts...>>> ranges( range_count );
+    std::vector<OfflineDecoderStatistics> range_statistics( range_count );
+    _parallelFor( range_count, [&]( size_t i ) {
+      const size_t begin = i * frames_per_range;
+      const size_t end = std::min( begin + frames_per_range, frames.size() );
+      std::vector<uint8_t> scratch;
+      ranges[i].reserve( end - begin );
+      for ( size_t j = begin; j < end; ++j ) {
+        const FrameInfo &frame = frames[j];
+        const uint8_t *payload = stream.contiguous( frame.offset + 6, frame.payload_size );
+        if ( payload == nullptr ) {
+          scratch.resize( frame.payload_size );
+          stream.copy( frame.offset + 6, frame.payload_size, scratch.data() );
+          payload = scratch.data();
+        }
+        bool known = ( _tryDecode<Ts>( frame, payload, ranges[i], range_statistics[i] ) || ... );
+        if ( !known )
+          ++range_statistics[i].unknown_ids;
+      }
+    } );
+
+    std::vector<DecodedObject<Ts...>> result;
+    result.reserve( frames.size() );
+    for ( size_t i = 0; i < range_count; ++i ) {
+      std::move( ranges[i].begin(), ranges[i].end(), std::back_inserter( result ) );
+      statistics_.decoded += range_statistics[i].decoded;
+      statistics_.unknown_ids += range_statistics[i].unknown_ids;
+      statistics_.size_mismatches += range_statistics[i].size_mismatches;
+    }
+    return result;
+  }
+
+  //! Statistics of the last findFrames() or decode() call.
+  const OfflineDecoderStatistics &statistics() const { return statistics_; }
+
+  //! Returns true and fills frame if a frame with a valid header and CRC starts at offset.
+  static bool validateFrame( const CaptureStream &stream, uint64_t offset, FrameInfo &frame,
+                             std::vector<uint8_t> &scratch, uint16_t max_payload_size = 0xFFFF )
+  {
+    uint8_t header[6];
+    if ( !stream.copy( offset, sizeof( header ), header ) || header[0] != 0x02 || header[1] != 0x42 )
+      return false;
+    uint16_t size_field = 0;
+    util::deserialize( header + 4, 2, size_field );
+    const uint16_t content_size = detail::frameContentSize( size_field );
+    if ( content_size > max_payload_size || offset + 8 + content_size > stream.size() )
+      return false;
+    const size_t size = 8 + content_size;
+    const uint8_t *data = stream.contiguous( offset, size );
+    if ( data == nullptr ) {
+      scratch.resize( size );
+      stream.copy( offset, size, scratch.data() );
+      data = scratch.data();
+    }
+    uint16_t crc = 0;
+    util::deserialize( data + 6 + content_size, 2, crc );
+    if ( crc != util::compute_crc16( data, 6 + content_size ) )
+      return false;
+    frame.offset = offset;
+    frame.timestamp_ns = stream.timestampNs( offset );
+    util::deserialize( header + 2, 2, frame.id );
+    frame.sequence_bytes = detail::frameSequenceBytes( size_field );
+    frame.payload_size = content_size - frame.sequence_bytes;
+    return true;
+  }
+
+private:
+  //! Returns the offset of the next valid frame starting in [begin, end) or end if there is none.
+  uint64_t _nextFrame( const CaptureStream &stream, uint64_t begin, uint64_t end, FrameInfo &frame,
+                       std::vector<uint8_t> &scratch ) const
+  {
+    while ( ( begin = stream.findMarker( begin, end ) ) < end ) {
+      if ( validateFrame( stream, begin, frame, scratch, options_.max_payload_size ) )
+        return begin;
+      ++begin;
+    }
+    return end;
+  }
+
+  std::vector<FrameInfo> _scan( const CaptureStream &stream, uint64_t begin, uint64_t end ) const
+  {
+    std::vector<FrameInfo> frames;
+    std::vector<uint8_t> scratch;
+    FrameInfo frame;
+    while ( ( begin = _nextFrame( stream, begin, end, frame, scratch ) ) < end ) {
+      frames.push_back( frame );
+      begin = frame.end();
+    }
+    return frames;
+  }
+
+  template<typename T, typename... Ts>
+  static bool _tryDecode( const FrameInfo &frame, const uint8_t *payload,
+                          std::vector<DecodedObject<Ts...>> &out, OfflineDecoderStatistics &statistics )
+  {
+    if ( frame.id != object_id<T>() )
+      return false;
+    T obj;
+    if ( util::deserialize( payload, frame.payload_size, obj ) != frame.payload_size ) {
+      ++statistics.size_mismatches;
+      return true;
+    }
+    out.push_back( { frame, std::move( obj ) } );
+    ++statistics.decoded;
+    return true;
+  }
+
+  void _parallelFor( size_t count, const std::function<void( size_t )> &fn ) const
+  {
+    const size_t thread_count = std::min<size_t>( options_.threads, count );
+    if ( thread_count <= 1 ) {
+      for ( size_t i = 0; i < count; ++i ) fn( i );
+      return;
+    }
+    std::atomic<size_t> next{ 0 };
+    std::vector<std::thread> threads;
+    threads.reserve( thread_count );
+    for ( size_t t = 0; t < thread_count; ++t ) {
+      threads.emplace_back( [&]() {
+        for ( size_t i; ( i = next.fetch_add( 1 ) ) < count; ) fn( i );
+      } );
+    }
+    for ( auto &thread : threads ) thread.join();
+  }
+
+  OfflineDecoderOptions options_;
+  OfflineDecoderStatistics statistics_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_OFFLINE_DECODER_HPP
@@ -0,0 +1,69 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_HOST_RPC_FUTURE_HPP
+#define CROSSTALK_HOST_RPC_FUTURE_HPP
+
+#ifndef CROSSTALK_RPC_HPP
+  #error "Include crosstalk.hpp or crosstalk/rpc.hpp before including host/rpc_future.hpp"
+#endif // CROSSTALK_RPC_HPP
+
+#include <future>
+#include <memory>
+
+namespace crosstalk
+{
+
+template<typename Response>
+struct RpcReply {
+  RpcStatus status = RpcStatus::NotSent;
+  //! Default constructed unless status is Success.
+  Response response{};
+};
+
+/*!
+ * Calls a remote procedure and returns a future for the reply. If the request can not be sent, the
+ * future is ready immediately with RpcStatus::NotSent.
+ * The future is completed by client.readResponse, client.poll or client.cancelAll, so they have to
+ * be called by the thread that receives the data, e.g., the loop processing the serial data.
+ * Destroying the client with outstanding calls breaks their promises.
+ */
+template<typename Request, typename Response, size_t MAX_PENDING, size_t MAX_RESPONSE_SIZE, size_t CALLBACK_SIZE,
+         int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+std::future<RpcReply<Response>>
+callAsync( RpcClient<MAX_PENDING, MAX_RESPONSE_SIZE, CALLBACK_SIZE> &client,
+           CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker, const Request &request,
+           uint32_t timeout_ms, uint32_t now_ms )
+{
+  auto promise = std::make_shared<std::promise<RpcReply<Response>>>();
+  std::future<RpcReply<Response>> future = promise->get_future();
+  const WriteResult result = client.template call<Request, Response>(
+      crosstalker, request, timeout_ms, now_ms, [promise]( RpcStatus status, const Response &response ) {
+        promise->set_value( RpcReply<Response>{ status, response } );
+      } );
+  if ( result != WriteResult::Success )
+    promise->set_value( RpcReply<Response>{} );
+  return future;
+}
+} // namespace crosstalk
+
+#endif // CROSSTALK_HOST_RPC_FUTURE_HPP
@@ -0,0 +1,114 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_LOG_HPP
+#define CROSSTALK_LOG_HPP
+
+#include "crosstalker.hpp"
+#include <cstring>
+#include <tuple>
+
+namespace crosstalk
+{
+
+/*!
+ * Base of a log message declaration in the shared header. The device only sends the id and the
+ * binary arguments, the host formats the message using the FORMAT string, where each {} is
+ * replaced by the next argument. Supported arguments are scalars and const char * strings.
+ * @code
+ * struct LogObjectResult : crosstalk::LogFormat<2, const char *, bool> {
+ *   static constexpr const char *FORMAT = "{}: {}";
+ * };
+ * @endcode
+ */
+template<uint16_t ID, typename... Args>
+struct LogFormat {
+  static constexpr uint16_t LOG_ID = ID;
+  using Arguments = std::tuple<Args...>;
+};
+
+namespace detail
+{
+template<typename T>
+size_t logArgumentSize( const T & )
+{
+  static_assert( std::is_scalar_v<T> && !std::is_pointer_v<T>,
+                 "Log arguments have to be scalars or const char *." );
+  return sizeof( T );
+}
+
+inline size_t logArgumentSize( const char *str )
+{
+  return sizeof( uint16_t ) + std::min<size_t>( std::strlen( str ), 0xFFFF );
+}
+
+template<typename T>
+size_t serializeLogArgument( const T &value, uint8_t *data )
+{
+  return util::serialize( value, data );
+}
+
+inline size_t serializeLogArgument( const char *str, uint8_t *data )
+{
+  const uint16_t length = std::min<size_t>( std::strlen( str ), 0xFFFF );
+  size_t offset = util::serialize( length, data );
+  std::memcpy( data + offset, str, length );
+  return offset + length;
+}
+
+template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE, typename Tuple, size_t... Is>
+WriteResult sendLog( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                     uint16_t log_id, const Tuple &arguments, std::index_sequence<Is...> )
+{
+  const size_t size = sizeof( uint16_t ) + ( size_t( 0 ) + ... + logArgumentSize( std::get<Is>( arguments ) ) );
+  return crosstalker.sendFrame( static_cast<int16_t>( InternalObjectId::Log ), size,
+                                [&arguments, log_id]( uint8_t *payload ) {
+                                  size_t offset = util::serialize( log_id, payload );
+                                  ( ( offset += serializeLogArgument( std::get<Is>( arguments ),
+                                                                      payload + offset ) ),
+                                    ... );
+                                  (void)offset;
+                                } );
+}
+} // namespace detail
+
+/*!
+ * Sends a log message as a frame with the id InternalObjectId::Log instead of formatting it on the
+ * device. The arguments are converted to the argument types of the Format.
+ * @code
+ * crosstalk::sendLog<LogObjectResult>( crosstalker, "TestObjectSimple", true );
+ * @endcode
+ */
+template<typename Format, int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE,
+         typename... Args>
+WriteResult sendLog( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                     const Args &...args )
+{
+  static_assert( sizeof...( Args ) == std::tuple_size_v<typename Format::Arguments>,
+                 "Number of arguments does not match the log format." );
+  const auto arguments = typename Format::Arguments( args... );
+  return detail::sendLog( crosstalker, Format::LOG_ID, arguments,
+                          std::make_index_sequence<sizeof...( Args )>{} );
+}
+} // namespace crosstalk
+
+#endif // CROSSTALK_LOG_HPP
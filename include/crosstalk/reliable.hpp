@@ -0,0 +1,417 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_RELIABLE_HPP
+#define CROSSTALK_RELIABLE_HPP
+
+#include "crosstalker.hpp"
+#include <cstdlib>
+#include <cstring>
+
+namespace crosstalk
+{
+
+//! Counters of the reliable channel.
+struct ReliableStatistics {
+  //! Frames sent again because they were not acknowledged in time.
+  uint32_t retransmitted_frames = 0;
+  //! Received frames that were received before, e.g., because the acknowledgement was lost.
+  uint32_t duplicate_frames = 0;
+  //! Received frames that arrived before an earlier frame and were buffered.
+  uint32_t out_of_order_frames = 0;
+  //! Received frames that were beyond the receive window because the application did not read.
+  uint32_t dropped_frames = 0;
+};
+
+namespace detail
+{
+//! Session, sequence number, window start and object id in front of the payload of a Reliable frame.
+constexpr size_t RELIABLE_HEADER_SIZE = 7;
+//! Session, next expected sequence number and selective acknowledgement bits.
+constexpr size_t RELIABLE_ACK_SIZE = 7;
+
+//! Signed distance from b to a of wrapping sequence numbers.
+inline int16_t sequenceDistance( uint16_t a, uint16_t b ) { return static_cast<int16_t>( a - b ); }
+
+template<size_t WINDOW_SIZE>
+constexpr bool isValidReliableWindow()
+{
+  // The sequence numbers have to wrap around at a slot boundary and the selective
+  // acknowledgement bits have to cover the whole window
+  return WINDOW_SIZE > 0 && WINDOW_SIZE <= 32 && ( WINDOW_SIZE & ( WINDOW_SIZE - 1 ) ) == 0;
+}
+
+template<size_t MAX_PAYLOAD_SIZE>
+struct ReliableSlot {
+  std::array<uint8_t, MAX_PAYLOAD_SIZE> data;
+  uint16_t size = 0;
+  uint16_t sequence = 0;
+  int16_t id = 0;
+  uint32_t sent_ms = 0;
+  bool acked = false;
+  bool retransmitted = false;
+  bool received = false;
+};
+} // namespace detail
+
+/*!
+ * Sending side of the reliable channel. Objects are sent as InternalObjectId::Reliable frames with
+ * a sequence number and kept in a fixed window until the receiver acknowledges them. Frames that
+ * are not acknowledged within the retransmission timeout are sent again. The timeout is adapted to
+ * the measured round-trip time (RFC 6298) and doubled on every timeout.
+ * Objects sent with sendObject are not affected, so best-effort telemetry keeps flowing while
+ * reliable frames are retransmitted.
+ * @code
+ * crosstalk::ReliableSender<8> reliable;
+ * reliable.send( crosstalker, config, millis() );
+ * ...
+ * crosstalker.processSerialData();
+ * if ( crosstalker.getObjectId() == static_cast<int16_t>( crosstalk::InternalObjectId::ReliableAck ) )
+ *   reliable.readAck( crosstalker, millis() );
+ * reliable.poll( crosstalker, millis() );
+ * @endcode
+ * @tparam WINDOW_SIZE Maximum number of unacknowledged frames. A power of two of at most 32.
+ * @tparam MAX_PAYLOAD_SIZE Maximum serialized size of the sent objects.
+ */
+template<size_t WINDOW_SIZE = 8, size_t MAX_PAYLOAD_SIZE = 64>
+class ReliableSender
+{
+  static_assert( detail::isValidReliableWindow<WINDOW_SIZE>(),
+                 "WINDOW_SIZE must be a power of two of at most 32." );
+
+public:
+  /*!
+   * @param session Identifies this sender to the receiver, which starts over if the session changes.
+   *   Should be different after a restart, e.g., a random number or a boot counter.
+   * @param initial_rto_ms Retransmission timeout until the round-trip time was measured.
+   */
+  explicit ReliableSender( uint8_t session = 0, uint32_t initial_rto_ms = 250, uint32_t min_rto_ms = 10,
+                           uint32_t max_rto_ms = 5000 )
+      : session_( session ), rto_ms_( initial_rto_ms ), min_rto_ms_( min_rto_ms ), max_rto_ms_( max_rto_ms )
+  {
+  }
+
+  /*!
+   * Sends the object and keeps it until it is acknowledged. If writing to the serial connection
+   * fails, the object is still kept and sent again after the timeout.
+   * @return WindowFull if WINDOW_SIZE frames are not acknowledged yet.
+   */
+  template<typename T, int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  WriteResult send( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                    const T &obj, uint32_t now_ms )
+  {
+    static_assert( refl::is_reflectable<T>(), "Type must be reflectable." );
+    constexpr int16_t id = object_id<T>();
+    static_assert( id >= 0, "Object ID must be greater or equal to 0. Negative ids are reserved." );
+    const size_t payload_size = util::compute_size( obj );
+    if ( payload_size > MAX_PAYLOAD_SIZE ||
+         payload_size + detail::RELIABLE_HEADER_SIZE + 8 > SERIALIZATION_BUFFER_SIZE )
+      return WriteResult::ObjectTooLarge;
+    if ( inFlight() == WINDOW_SIZE )
+      return WriteResult::WindowFull;
+    Slot &slot = slots_[next_sequence_ % WINDOW_SIZE];
+    slot.sequence = next_sequence_++;
+    slot.id = id;
+    slot.size = payload_size;
+    slot.acked = false;
+    slot.retransmitted = false;
+    util::serialize<T>( obj, slot.data.data() );
+    _transmit( crosstalker, slot, now_ms );
+    return WriteResult::Success;
+  }
+
+  /*!
+   * Sends the frames again that were not acknowledged within the retransmission timeout.
+   * Should be called regularly.
+   * @return The number of retransmitted frames.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  size_t poll( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker, uint32_t now_ms )
+  {
+    size_t count = 0;
+    for ( uint16_t sequence = base_; sequence != next_sequence_; ++sequence ) {
+      Slot &slot = slots_[sequence % WINDOW_SIZE];
+      if ( slot.acked || now_ms - slot.sent_ms < rto_ms_ )
+        continue;
+      slot.retransmitted = true;
+      _transmit( crosstalker, slot, now_ms );
+      ++count;
+    }
+    if ( count > 0 ) {
+      // Back off until the next round-trip time sample
+      rto_ms_ = std::min( rto_ms_ * 2, max_rto_ms_ );
+      statistics_.retransmitted_frames += count;
+    }
+    return count;
+  }
+
+  /*!
+   * Reads the current frame as an acknowledgement and releases the acknowledged frames.
+   * @return ObjectIdMismatch if the current frame is not an acknowledgement.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  ReadResult readAck( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                      uint32_t now_ms )
+  {
+    if ( crosstalker.hasObject() &&
+         crosstalker.getObjectId() != static_cast<int16_t>( InternalObjectId::ReliableAck ) )
+      return ReadResult::ObjectIdMismatch;
+    uint8_t session = 0;
+    uint16_t next = 0;
+    uint32_t selective = 0;
+    ReadResult result = crosstalker.readFrame( [&]( int16_t, const uint8_t *payload, size_t size ) -> size_t {
+      if ( size < detail::RELIABLE_ACK_SIZE )
+        return 0;
+      size_t offset = util::deserialize( payload, size, session );
+      offset += util::deserialize( payload + offset, size - offset, next );
+      offset += util::deserialize( payload + offset, size - offset, selective );
+      return offset;
+    } );
+    if ( result != ReadResult::Success )
+      return result;
+    // Acknowledgements of a previous session or of frames that were not sent are ignored
+    if ( session != session_ || detail::sequenceDistance( next, next_sequence_ ) > 0 )
+      return ReadResult::Success;
+    for ( uint16_t sequence = base_; sequence != next_sequence_; ++sequence ) {
+      Slot &slot = slots_[sequence % WINDOW_SIZE];
+      const int16_t offset = detail::sequenceDistance( sequence, next );
+      const bool acked = offset < 0 || ( offset > 0 && ( ( selective >> ( offset - 1 ) ) & 1 ) != 0 );
+      if ( !acked || slot.acked )
+        continue;
+      slot.acked = true;
+      // Retransmitted frames are ambiguous, the acknowledgement may be for any transmission
+      if ( !slot.retransmitted )
+        _updateRto( now_ms - slot.sent_ms );
+    }
+    while ( base_ != next_sequence_ && slots_[base_ % WINDOW_SIZE].acked ) ++base_;
+    return ReadResult::Success;
+  }
+
+  //! The number of sent frames that are not acknowledged yet.
+  size_t inFlight() const { return static_cast<uint16_t>( next_sequence_ - base_ ); }
+
+  //! The current retransmission timeout.
+  uint32_t rto() const { return rto_ms_; }
+
+  //! The smoothed round-trip time or 0 if it was not measured yet.
+  uint32_t smoothedRtt() const { return srtt8_ / 8; }
+
+  const ReliableStatistics &statistics() const { return statistics_; }
+
+  void resetStatistics() { statistics_ = {}; }
+
+private:
+  using Slot = detail::ReliableSlot<MAX_PAYLOAD_SIZE>;
+
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  void _transmit( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                  Slot &slot, uint32_t now_ms )
+  {
+    slot.sent_ms = now_ms;
+    crosstalker.sendFrame( static_cast<int16_t>( InternalObjectId::Reliable ),
+                           detail::RELIABLE_HEADER_SIZE + slot.size, [this, &slot]( uint8_t *payload ) {
+                             size_t offset = util::serialize( session_, payload );
+                             offset += util::serialize( slot.sequence, payload + offset );
+                             offset += util::serialize( base_, payload + offset );
+                             offset += util::serialize( slot.id, payload + offset );
+                             std::memcpy( payload + offset, slot.data.data(), slot.size );
+                           } );
+  }
+
+  void _updateRto( uint32_t rtt_ms )
+  {
+    // Scaled by 8 and 4 as in Jacobson's algorithm to keep the precision with integers
+    if ( srtt8_ == 0 ) {
+      srtt8_ = std::max<uint32_t>( rtt_ms, 1 ) * 8;
+      rttvar4_ = rtt_ms * 2;
+    } else {
+      const int32_t error = static_cast<int32_t>( rtt_ms ) - static_cast<int32_t>( srtt8_ / 8 );
+      srtt8_ = std::max<int32_t>( static_cast<int32_t>( srtt8_ ) + error, 8 );
+      rttvar4_ = rttvar4_ - rttvar4_ / 4 + std::abs( error );
+    }
+    rto_ms_ = std::clamp<uint32_t>( srtt8_ / 8 + std::max<uint32_t>( rttvar4_, 1 ), min_rto_ms_, max_rto_ms_ );
+  }
+
+  std::array<Slot, WINDOW_SIZE> slots_;
+  uint8_t session_;
+  uint16_t base_ = 0;
+  uint16_t next_sequence_ = 0;
+  uint32_t rto_ms_;
+  uint32_t min_rto_ms_;
+  uint32_t max_rto_ms_;
+  uint32_t srtt8_ = 0;
+  uint32_t rttvar4_ = 0;
+  ReliableStatistics statistics_;
+};
+
+/*!
+ * Receiving side of the reliable channel. Buffers the received frames in a fixed window, passes
+ * them to the application in order and without duplicates, and acknowledges them.
+ * @code
+ * crosstalker.processSerialData();
+ * while ( crosstalker.hasObject() ) {
+ *   if ( crosstalker.getObjectId() == static_cast<int16_t>( crosstalk::InternalObjectId::Reliable ) )
+ *     reliable.receive( crosstalker );
+ *   ...
+ * }
+ * while ( reliable.hasObject() ) reliable.readObject( config );
+ * @endcode
+ * @tparam WINDOW_SIZE Should be at least the window size of the sender.
+ */
+template<size_t WINDOW_SIZE = 8, size_t MAX_PAYLOAD_SIZE = 64>
+class ReliableReceiver
+{
+  static_assert( detail::isValidReliableWindow<WINDOW_SIZE>(),
+                 "WINDOW_SIZE must be a power of two of at most 32." );
+
+public:
+  /*!
+   * Reads the current frame as a frame of the reliable channel and sends an acknowledgement.
+   * @return ObjectIdMismatch if the current frame is not a frame of the reliable channel.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  ReadResult receive( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker )
+  {
+    if ( crosstalker.hasObject() &&
+         crosstalker.getObjectId() != static_cast<int16_t>( InternalObjectId::Reliable ) )
+      return ReadResult::ObjectIdMismatch;
+    ReadResult result = crosstalker.readFrame(
+        [this]( int16_t, const uint8_t *payload, size_t size ) { return _store( payload, size ); } );
+    if ( result != ReadResult::Success )
+      return result;
+    // Duplicates are acknowledged as well since the previous acknowledgement may have been lost
+    sendAck( crosstalker );
+    return ReadResult::Success;
+  }
+
+  //! Sends an acknowledgement of the received frames. Called by receive.
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  WriteResult sendAck( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker )
+  {
+    if ( !synced_ )
+      return WriteResult::Success;
+    uint32_t selective = 0;
+    for ( size_t i = 1; i < WINDOW_SIZE; ++i ) {
+      const uint16_t sequence = next_expected_ + i;
+      const Slot &slot = slots_[sequence % WINDOW_SIZE];
+      if ( detail::sequenceDistance( sequence, read_sequence_ ) < static_cast<int16_t>( WINDOW_SIZE ) &&
+           slot.received && slot.sequence == sequence )
+        selective |= uint32_t( 1 ) << ( i - 1 );
+    }
+    return crosstalker.sendFrame( static_cast<int16_t>( InternalObjectId::ReliableAck ),
+                                  detail::RELIABLE_ACK_SIZE, [this, selective]( uint8_t *payload ) {
+                                    size_t offset = util::serialize( session_, payload );
+                                    offset += util::serialize( next_expected_, payload + offset );
+                                    util::serialize( selective, payload + offset );
+                                  } );
+  }
+
+  //! Returns true if the next object in order was received.
+  bool hasObject() const { return read_sequence_ != next_expected_; }
+
+  //! Returns the id of the next object in order or -1 if it was not received yet.
+  int16_t getObjectId() const { return hasObject() ? slots_[read_sequence_ % WINDOW_SIZE].id : -1; }
+
+  template<typename T>
+  ReadResult readObject( T &obj )
+  {
+    if ( !hasObject() )
+      return ReadResult::NoObjectAvailable;
+    if ( getObjectId() != object_id<T>() )
+      return ReadResult::ObjectIdMismatch;
+    Slot &slot = slots_[read_sequence_ % WINDOW_SIZE];
+    const size_t size = util::deserialize<T>( slot.data.data(), slot.size, obj );
+    const bool complete = size == slot.size;
+    skipObject();
+    return complete ? ReadResult::Success : ReadResult::ObjectSizeMismatch;
+  }
+
+  ReadResult skipObject()
+  {
+    if ( !hasObject() )
+      return ReadResult::NoObjectAvailable;
+    slots_[read_sequence_ % WINDOW_SIZE].received = false;
+    ++read_sequence_;
+    return ReadResult::Success;
+  }
+
+  const ReliableStatistics &statistics() const { return statistics_; }
+
+  void resetStatistics() { statistics_ = {}; }
+
+private:
+  using Slot = detail::ReliableSlot<MAX_PAYLOAD_SIZE>;
+
+  size_t _store( const uint8_t *payload, size_t size )
+  {
+    if ( size < detail::RELIABLE_HEADER_SIZE )
+      return 0;
+    uint8_t session = 0;
+    uint16_t sequence = 0;
+    uint16_t base = 0;
+    int16_t id = 0;
+    size_t offset = util::deserialize( payload, size, session );
+    offset += util::deserialize( payload + offset, size - offset, sequence );
+    offset += util::deserialize( payload + offset, size - offset, base );
+    offset += util::deserialize( payload + offset, size - offset, id );
+    if ( !synced_ || session != session_ ) {
+      // A new sender or a restarted receiver, start at the window of the sender
+      for ( Slot &slot : slots_ ) slot.received = false;
+      session_ = session;
+      read_sequence_ = base;
+      next_expected_ = base;
+      synced_ = true;
+    }
+    const int16_t distance = detail::sequenceDistance( sequence, read_sequence_ );
+    Slot &slot = slots_[sequence % WINDOW_SIZE];
+    if ( distance < 0 || ( slot.received && slot.sequence == sequence ) ) {
+      ++statistics_.duplicate_frames;
+      return size;
+    }
+    if ( distance >= static_cast<int16_t>( WINDOW_SIZE ) || size - offset > MAX_PAYLOAD_SIZE ) {
+      ++statistics_.dropped_frames;
+      return size;
+    }
+    if ( sequence != next_expected_ )
+      ++statistics_.out_of_order_frames;
+    slot.sequence = sequence;
+    slot.id = id;
+    slot.size = size - offset;
+    std::memcpy( slot.data.data(), payload + offset, slot.size );
+    slot.received = true;
+    while ( detail::sequenceDistance( next_expected_, read_sequence_ ) < static_cast<int16_t>( WINDOW_SIZE ) &&
+            slots_[next_expected_ % WINDOW_SIZE].received )
+      ++next_expected_;
+    return size;
+  }
+
+  std::array<Slot, WINDOW_SIZE> slots_;
+  uint8_t session_ = 0;
+  bool synced_ = false;
+  // Next sequence number to pass to the application and first one that was not received
+  uint16_t read_sequence_ = 0;
+  uint16_t next_expected_ = 0;
+  ReliableStatistics statistics_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_RELIABLE_HPP
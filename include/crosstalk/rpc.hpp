@@ -0,0 +1,413 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_RPC_HPP
+#define CROSSTALK_RPC_HPP
+
+#include "crosstalker.hpp"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace crosstalk
+{
+
+enum class RpcStatus : uint8_t {
+  Success = 0,
+  //! No response was received within the timeout.
+  Timeout = 1,
+  //! The server has no handler for the request type.
+  UnknownMethod = 2,
+  //! The server could not deserialize the request.
+  InvalidRequest = 3,
+  //! The response did not match the expected type or could not be deserialized.
+  InvalidResponse = 4,
+  //! The response is larger than the response buffer of the server.
+  ResponseTooLarge = 5,
+  //! The request could not be sent. Only used for calls that can not return the WriteResult.
+  NotSent = 6,
+  //! The call was cancelled with RpcClient::cancelAll.
+  Cancelled = 7,
+};
+
+inline std::string to_string( RpcStatus status )
+{
+  switch ( status ) {
+  case RpcStatus::Success:
+    return "Success";
+  case RpcStatus::Timeout:
+    return "Timeout";
+  case RpcStatus::UnknownMethod:
+    return "UnknownMethod";
+  case RpcStatus::InvalidRequest:
+    return "InvalidRequest";
+  case RpcStatus::InvalidResponse:
+    return "InvalidResponse";
+  case RpcStatus::ResponseTooLarge:
+    return "ResponseTooLarge";
+  case RpcStatus::NotSent:
+    return "NotSent";
+  case RpcStatus::Cancelled:
+    return "Cancelled";
+  }
+  return "UnknownRpcStatus";
+}
+
+namespace detail
+{
+//! Call id and request object id in front of the payload of a RpcRequest frame.
+constexpr size_t RPC_REQUEST_HEADER_SIZE = 4;
+//! Call id, status and response object id in front of the payload of a RpcResponse frame.
+constexpr size_t RPC_RESPONSE_HEADER_SIZE = 5;
+
+template<typename Handler>
+struct RpcHandlerTraits;
+
+template<typename Request_, typename Response_>
+struct RpcHandlerTraits<Response_ ( * )( const Request_ & )> {
+  using Request = Request_;
+  using Response = Response_;
+};
+
+template<auto... HANDLERS>
+constexpr bool hasUniqueRpcRequests()
+{
+  constexpr int16_t ids[] = { object_id<typename RpcHandlerTraits<decltype( HANDLERS )>::Request>()..., 0 };
+  for ( size_t i = 0; i < sizeof...( HANDLERS ); ++i ) {
+    for ( size_t j = i + 1; j < sizeof...( HANDLERS ); ++j ) {
+      if ( ids[i] == ids[j] )
+        return false;
+    }
+  }
+  return true;
+}
+} // namespace detail
+
+/*!
+ * Serves remote procedure calls with a handler table that is fixed at compile time. Each handler
+ * is a function `Response handler( const Request &request )` and is selected by the object id of
+ * its request type, so every request type can only have one handler.
+ * Requests are answered in the order they are received with a RpcResponse frame that carries the
+ * call id of the request, hence, the client can have several calls in flight.
+ * @code
+ * SensorReading readSensor( const ReadSensor &request );
+ * LedState setLed( const SetLed &request );
+ * crosstalk::RpcServer<64, &readSensor, &setLed> rpc;
+ * crosstalker.processSerialData();
+ * if ( crosstalker.getObjectId() == static_cast<int16_t>( crosstalk::InternalObjectId::RpcRequest ) )
+ *   rpc.handle( crosstalker );
+ * @endcode
+ * @tparam MAX_RESPONSE_SIZE Maximum serialized size of the responses.
+ * @tparam HANDLERS Pointers to the handler functions.
+ */
+template<size_t MAX_RESPONSE_SIZE, auto... HANDLERS>
+class RpcServer
+{
+  static_assert( sizeof...( HANDLERS ) > 0, "At least one handler is required." );
+  static_assert( detail::hasUniqueRpcRequests<HANDLERS...>(), "Every request type can only have one handler." );
+
+public:
+  //! Returns true if a handler for the request object id is registered.
+  static constexpr bool hasHandler( int16_t request_id )
+  {
+    return ( ( object_id<typename detail::RpcHandlerTraits<decltype( HANDLERS )>::Request>() == request_id ) ||
+             ... );
+  }
+
+  /*!
+   * Reads the next RpcRequest frame, calls the handler for the request and sends the response.
+   * Requests without a handler are answered with RpcStatus::UnknownMethod.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  ReadResult handle( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker )
+  {
+    if ( crosstalker.hasObject() &&
+         crosstalker.getObjectId() != static_cast<int16_t>( InternalObjectId::RpcRequest ) )
+      return ReadResult::ObjectIdMismatch;
+    uint16_t call_id = 0;
+    Reply reply;
+    ReadResult result = crosstalker.readFrame( [&]( int16_t, const uint8_t *payload, size_t size ) -> size_t {
+      if ( size < detail::RPC_REQUEST_HEADER_SIZE )
+        return 0;
+      int16_t request_id = 0;
+      size_t offset = util::deserialize( payload, size, call_id );
+      offset += util::deserialize( payload + offset, size - offset, request_id );
+      ( _call<HANDLERS>( request_id, payload + offset, size - offset, reply ) || ... );
+      return size;
+    } );
+    if ( result != ReadResult::Success )
+      return result;
+    // The response is sent after the request frame was read since it may share the serialization buffer
+    crosstalker.sendFrame( static_cast<int16_t>( InternalObjectId::RpcResponse ),
+                           detail::RPC_RESPONSE_HEADER_SIZE + reply.size, [&]( uint8_t *payload ) {
+                             size_t offset = util::serialize( call_id, payload );
+                             offset += util::serialize( static_cast<uint8_t>( reply.status ), payload + offset );
+                             offset += util::serialize( reply.response_id, payload + offset );
+                             std::memcpy( payload + offset, response_.data(), reply.size );
+                           } );
+    return ReadResult::Success;
+  }
+
+private:
+  struct Reply {
+    RpcStatus status = RpcStatus::UnknownMethod;
+    int16_t response_id = -1;
+    size_t size = 0;
+  };
+
+  template<auto HANDLER>
+  bool _call( int16_t request_id, const uint8_t *payload, size_t size, Reply &reply )
+  {
+    using Request = typename detail::RpcHandlerTraits<decltype( HANDLER )>::Request;
+    using Response = typename detail::RpcHandlerTraits<decltype( HANDLER )>::Response;
+    static_assert( object_id<Request>() >= 0 && object_id<Response>() >= 0,
+                   "Object IDs must be greater or equal to 0. Negative ids are reserved." );
+    if ( request_id != object_id<Request>() )
+      return false;
+    Request request{};
+    if ( util::deserialize<Request>( payload, size, request ) != size ) {
+      reply.status = RpcStatus::InvalidRequest;
+      return true;
+    }
+    const Response response = HANDLER( request );
+    const size_t response_size = util::compute_size( response );
+    if ( response_size > MAX_RESPONSE_SIZE ) {
+      reply.status = RpcStatus::ResponseTooLarge;
+      return true;
+    }
+    util::serialize<Response>( response, response_.data() );
+    reply.status = RpcStatus::Success;
+    reply.response_id = object_id<Response>();
+    reply.size = response_size;
+    return true;
+  }
+
+  std::array<uint8_t, MAX_RESPONSE_SIZE> response_;
+};
+
+/*!
+ * Calls remote procedures of a RpcServer. Every call gets a call id that is sent with the request
+ * and returned with the response, so several calls can be in flight at once and their round trips
+ * overlap. Outstanding calls are kept in a fixed table with MAX_PENDING entries and their
+ * callbacks are stored in place, so nothing is allocated on the heap.
+ * Callbacks are called with the status and the response, which is default constructed if the call
+ * failed, from readResponse, poll or cancelAll. They may start new calls.
+ * @code
+ * crosstalk::RpcClient<4> rpc;
+ * rpc.call<ReadSensor, SensorReading>( crosstalker, ReadSensor{ 2 }, 100, millis(),
+ *     [&]( crosstalk::RpcStatus status, const SensorReading &reading ) { ... } );
+ * ...
+ * crosstalker.processSerialData();
+ * if ( crosstalker.getObjectId() == static_cast<int16_t>( crosstalk::InternalObjectId::RpcResponse ) )
+ *   rpc.readResponse( crosstalker );
+ * rpc.poll( millis() );
+ * @endcode
+ * @tparam MAX_PENDING Maximum number of calls in flight.
+ * @tparam MAX_RESPONSE_SIZE Maximum serialized size of the responses.
+ * @tparam CALLBACK_SIZE Maximum size of a callback including its captures.
+ */
+template<size_t MAX_PENDING = 8, size_t MAX_RESPONSE_SIZE = 64, size_t CALLBACK_SIZE = 4 * sizeof( void * )>
+class RpcClient
+{
+  static_assert( MAX_PENDING > 0, "MAX_PENDING must be positive." );
+
+public:
+  RpcClient() = default;
+
+  RpcClient( const RpcClient & ) = delete;
+
+  RpcClient &operator=( const RpcClient & ) = delete;
+
+  //! Destroys the callbacks of outstanding calls without calling them.
+  ~RpcClient()
+  {
+    for ( Pending &pending : pending_ ) {
+      if ( pending.active )
+        pending.destroy( pending );
+    }
+  }
+
+  /*!
+   * Sends the request and calls callback( RpcStatus status, const Response &response ) once the
+   * response was read, the timeout expired or the call was cancelled.
+   * The callback is not called if sending fails.
+   * @return WindowFull if MAX_PENDING calls are in flight.
+   */
+  template<typename Request, typename Response, typename Callback, int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE,
+           int TEXT_BUFFER_SIZE>
+  WriteResult call( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker,
+                    const Request &request, uint32_t timeout_ms, uint32_t now_ms, Callback &&callback )
+  {
+    using StoredCallback = std::decay_t<Callback>;
+    static_assert( sizeof( StoredCallback ) <= CALLBACK_SIZE, "The callback is larger than CALLBACK_SIZE." );
+    static_assert( alignof( StoredCallback ) <= alignof( std::max_align_t ), "The callback is over-aligned." );
+    static_assert( refl::is_reflectable<Request>() && refl::is_reflectable<Response>(),
+                   "Request and response types must be reflectable." );
+    constexpr int16_t request_id = object_id<Request>();
+    static_assert( request_id >= 0 && object_id<Response>() >= 0,
+                   "Object IDs must be greater or equal to 0. Negative ids are reserved." );
+    Pending *pending = nullptr;
+    for ( Pending &entry : pending_ ) {
+      if ( entry.active )
+        continue;
+      pending = &entry;
+      break;
+    }
+    if ( pending == nullptr )
+      return WriteResult::WindowFull;
+    const uint16_t call_id = next_call_id_;
+    const WriteResult result = crosstalker.sendFrame(
+        static_cast<int16_t>( InternalObjectId::RpcRequest ),
+        detail::RPC_REQUEST_HEADER_SIZE + util::compute_size( request ), [&]( uint8_t *payload ) {
+          size_t offset = util::serialize( call_id, payload );
+          offset += util::serialize( request_id, payload + offset );
+          util::serialize<Request>( request, payload + offset );
+        } );
+    if ( result != WriteResult::Success )
+      return result;
+    ++next_call_id_;
+    new ( pending->storage ) StoredCallback( std::forward<Callback>( callback ) );
+    pending->active = true;
+    pending->call_id = call_id;
+    pending->response_id = object_id<Response>();
+    pending->sent_ms = now_ms;
+    pending->timeout_ms = timeout_ms;
+    pending->complete = &RpcClient::_complete<Response, StoredCallback>;
+    pending->destroy = &RpcClient::_destroy<StoredCallback>;
+    return WriteResult::Success;
+  }
+
+  /*!
+   * Reads the next RpcResponse frame and completes the matching call. Responses to calls that
+   * already timed out are ignored.
+   */
+  template<int BUFFER_SIZE, int SERIALIZATION_BUFFER_SIZE, int TEXT_BUFFER_SIZE>
+  ReadResult readResponse( CrossTalker<BUFFER_SIZE, SERIALIZATION_BUFFER_SIZE, TEXT_BUFFER_SIZE> &crosstalker )
+  {
+    if ( crosstalker.hasObject() &&
+         crosstalker.getObjectId() != static_cast<int16_t>( InternalObjectId::RpcResponse ) )
+      return ReadResult::ObjectIdMismatch;
+    uint16_t call_id = 0;
+    uint8_t status = 0;
+    int16_t response_id = -1;
+    size_t response_size = 0;
+    bool fits = true;
+    ReadResult result = crosstalker.readFrame( [&]( int16_t, const uint8_t *payload, size_t size ) -> size_t {
+      if ( size < detail::RPC_RESPONSE_HEADER_SIZE )
+        return 0;
+      size_t offset = util::deserialize( payload, size, call_id );
+      offset += util::deserialize( payload + offset, size - offset, status );
+      offset += util::deserialize( payload + offset, size - offset, response_id );
+      response_size = size - offset;
+      fits = response_size <= MAX_RESPONSE_SIZE;
+      if ( fits )
+        std::memcpy( response_.data(), payload + offset, response_size );
+      return size;
+    } );
+    if ( result != ReadResult::Success )
+      return result;
+    for ( Pending &pending : pending_ ) {
+      if ( !pending.active || pending.call_id != call_id )
+        continue;
+      RpcStatus rpc_status = static_cast<RpcStatus>( status );
+      if ( rpc_status == RpcStatus::Success && ( !fits || response_id != pending.response_id ) )
+        rpc_status = RpcStatus::InvalidResponse;
+      pending.complete( pending, rpc_status, response_.data(), response_size );
+      break;
+    }
+    return ReadResult::Success;
+  }
+
+  //! Completes the calls whose timeout expired with RpcStatus::Timeout. Returns their number.
+  size_t poll( uint32_t now_ms )
+  {
+    size_t expired = 0;
+    for ( Pending &pending : pending_ ) {
+      if ( !pending.active || now_ms - pending.sent_ms < pending.timeout_ms )
+        continue;
+      pending.complete( pending, RpcStatus::Timeout, nullptr, 0 );
+      ++expired;
+    }
+    return expired;
+  }
+
+  //! Completes all outstanding calls with RpcStatus::Cancelled, e.g., after the device restarted.
+  void cancelAll()
+  {
+    for ( Pending &pending : pending_ ) {
+      if ( pending.active )
+        pending.complete( pending, RpcStatus::Cancelled, nullptr, 0 );
+    }
+  }
+
+  //! The number of calls in flight.
+  size_t pending() const
+  {
+    size_t count = 0;
+    for ( const Pending &pending : pending_ ) count += pending.active ? 1 : 0;
+    return count;
+  }
+
+private:
+  struct Pending {
+    alignas( std::max_align_t ) unsigned char storage[CALLBACK_SIZE];
+    void ( *complete )( Pending &, RpcStatus, const uint8_t *, size_t ) = nullptr;
+    void ( *destroy )( Pending & ) = nullptr;
+    uint32_t sent_ms = 0;
+    uint32_t timeout_ms = 0;
+    uint16_t call_id = 0;
+    int16_t response_id = -1;
+    bool active = false;
+  };
+
+  template<typename Response, typename StoredCallback>
+  static void _complete( Pending &pending, RpcStatus status, const uint8_t *payload, size_t size )
+  {
+    Response response{};
+    if ( status == RpcStatus::Success && util::deserialize<Response>( payload, size, response ) != size ) {
+      status = RpcStatus::InvalidResponse;
+      response = Response{};
+    }
+    // Free the entry before calling, so the callback can start new calls
+    StoredCallback &stored = *std::launder( reinterpret_cast<StoredCallback *>( pending.storage ) );
+    StoredCallback callback( std::move( stored ) );
+    stored.~StoredCallback();
+    pending.active = false;
+    callback( status, static_cast<const Response &>( response ) );
+  }
+
+  template<typename StoredCallback>
+  static void _destroy( Pending &pending )
+  {
+    std::launder( reinterpret_cast<StoredCallback *>( pending.storage ) )->~StoredCallback();
+    pending.active = false;
+  }
+
+  std::array<Pending, MAX_PENDING> pending_;
+  std::array<uint8_t, MAX_RESPONSE_SIZE> response_;
+  uint16_t next_call_id_ = 0;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_RPC_HPP
@@ -23,6 +23,7 @@
 #ifndef CROSSTALK_SERIAL_ABSTRACTION_HPP
 #define CROSSTALK_SERIAL_ABSTRACTION_HPP
 
+#include <cstddef>
 #include <cstdint>
 
 namespace crosstalk
@@ -40,6 +41,28 @@ public:
   virtual int read( uint8_t *data, size_t length ) = 0;
 
   virtual bool write( const uint8_t *data, size_t length ) = 0;
+
+  /*!
+   * Transports that preserve message boundaries, e.g., SOCK_SEQPACKET sockets, UDP or USB bulk
+   * transfers, return true. Packets then contain one or more frames without start markers, which
+   * are sent with sendPacket and received with receivePacket, and the CrossTalker does not scan the
+   * received data for start markers. For these transports, available() returns the size of the
+   * next packet.
+   */
+  virtual bool isPacketTransport() const { return false; }
+
+  //! Largest packet the transport can send or 0 if it is only limited by the serialization buffer.
+  virtual size_t maxPacketSize() const { return 0; }
+
+  //! Sends the data as one packet. Only used if isPacketTransport() returns true.
+  virtual bool sendPacket( const uint8_t *data, size_t length ) { return write( data, length ); }
+
+  /*!
+   * Receives the next packet. Only used if isPacketTransport() returns true.
+   * @return The size of the packet, 0 if no packet is available or -1 if the packet was larger
+   *   than length and has been discarded.
+   */
+  virtual int receivePacket( uint8_t *data, size_t length ) { return read( data, length ); }
 };
 } // namespace crosstalk
 
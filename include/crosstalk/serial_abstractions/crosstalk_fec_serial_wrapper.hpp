@@ -0,0 +1,440 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_FEC_SERIAL_WRAPPER_HPP
+#define CROSSTALK_FEC_SERIAL_WRAPPER_HPP
+
+#ifndef CROSSTALK_SERIAL_ABSTRACTION_HPP
+  #error "Include crosstalk.hpp or crosstalk/serial_abstraction.hpp before including crosstalk_fec_serial_wrapper.hpp"
+#endif // CROSSTALK_SERIAL_ABSTRACTION_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+
+namespace crosstalk
+{
+namespace detail
+{
+struct GaloisFieldTables {
+  // Twice the period, so the sum of two logarithms can be used without reduction
+  uint8_t exp[512];
+  uint8_t log[256];
+};
+
+//! Tables for GF(2^8) with the primitive polynomial x^8 + x^4 + x^3 + x^2 + 1.
+constexpr GaloisFieldTables makeGaloisFieldTables()
+{
+  GaloisFieldTables tables{};
+  int value = 1;
+  for ( int i = 0; i < 255; ++i ) {
+    tables.exp[i] = static_cast<uint8_t>( value );
+    tables.log[value] = static_cast<uint8_t>( i );
+    value <<= 1;
+    if ( value & 0x100 )
+      value ^= 0x11D;
+  }
+  for ( int i = 255; i < 512; ++i ) tables.exp[i] = tables.exp[i - 255];
+  return tables;
+}
+
+//! Arithmetic in GF(2^8) used by the Reed-Solomon code.
+struct GaloisField256 {
+  static constexpr GaloisFieldTables tables = makeGaloisFieldTables();
+
+  static constexpr uint8_t mul( uint8_t a, uint8_t b )
+  {
+    if ( a == 0 || b == 0 )
+      return 0;
+    return tables.exp[tables.log[a] + tables.log[b]];
+  }
+
+  //! b must not be zero.
+  static constexpr uint8_t div( uint8_t a, uint8_t b )
+  {
+    if ( a == 0 )
+      return 0;
+    return tables.exp[tables.log[a] + 255 - tables.log[b]];
+  }
+
+  //! alpha^power for power >= 0.
+  static constexpr uint8_t alphaPow( int power ) { return tables.exp[power % 255]; }
+};
+
+//! Generator polynomial (x - alpha^0) ... (x - alpha^(PARITY_SIZE - 1)), coefficients in descending order.
+template<int PARITY_SIZE>
+constexpr std::array<uint8_t, PARITY_SIZE + 1> makeReedSolomonGenerator()
+{
+  std::array<uint8_t, PARITY_SIZE + 1> generator{};
+  generator[0] = 1;
+  for ( int i = 0; i < PARITY_SIZE; ++i ) {
+    const uint8_t root = GaloisField256::alphaPow( i );
+    for ( int j = i + 1; j >= 1; --j ) generator[j] ^= GaloisField256::mul( root, generator[j - 1] );
+  }
+  return generator;
+}
+
+/*!
+ * Systematic Reed-Solomon code over GF(2^8) with PARITY_SIZE parity bytes that corrects up to
+ * PARITY_SIZE / 2 erroneous bytes. Shorter codewords than 255 bytes are shortened codes, i.e., the
+ * missing leading data bytes are zero.
+ */
+template<int PARITY_SIZE>
+class ReedSolomon
+{
+  using GF = GaloisField256;
+
+public:
+  static constexpr int MAX_CORRECTABLE = PARITY_SIZE / 2;
+
+  //! Computes the PARITY_SIZE parity bytes for the data.
+  static void encode( const uint8_t *data, size_t size, uint8_t *parity )
+  {
+    std::memset( parity, 0, PARITY_SIZE );
+    for ( size_t i = 0; i < size; ++i ) {
+      const uint8_t feedback = data[i] ^ parity[0];
+      for ( int j = 0; j < PARITY_SIZE - 1; ++j ) parity[j] = parity[j + 1] ^ GF::mul( feedback, generator_[j + 1] );
+      parity[PARITY_SIZE - 1] = GF::mul( feedback, generator_[PARITY_SIZE] );
+    }
+  }
+
+  /*!
+   * Corrects the codeword consisting of the data followed by the parity bytes in place.
+   * @return The number of corrected bytes or -1 if there are too many errors. The codeword is
+   *   left unchanged in that case.
+   */
+  static int decode( uint8_t *codeword, size_t size )
+  {
+    uint8_t syndromes[PARITY_SIZE];
+    bool has_errors = false;
+    for ( int j = 0; j < PARITY_SIZE; ++j ) {
+      uint8_t value = 0;
+      const uint8_t root = GF::alphaPow( j );
+      for ( size_t i = 0; i < size; ++i ) value = GF::mul( value, root ) ^ codeword[i];
+      syndromes[j] = value;
+      has_errors |= value != 0;
+    }
+    if ( !has_errors )
+      return 0;
+
+    // Berlekamp-Massey to find the error locator polynomial, coefficients in ascending order
+    uint8_t locator[PARITY_SIZE + 1] = { 1 };
+    uint8_t previous[PARITY_SIZE + 1] = { 1 };
+    int errors = 0;
+    int shift = 1;
+    uint8_t previous_discrepancy = 1;
+    for ( int n = 0; n < PARITY_SIZE; ++n ) {
+      uint8_t discrepancy = syndromes[n];
+      for ( int i = 1; i <= errors; ++i ) discrepancy ^= GF::mul( locator[i], syndromes[n - i] );
+      if ( discrepancy == 0 ) {
+        ++shift;
+        continue;
+      }
+      const uint8_t scale = GF::div( discrepancy, previous_discrepancy );
+      if ( 2 * errors <= n ) {
+        uint8_t copy[PARITY_SIZE + 1];
+        std::memcpy( copy, locator, sizeof( locator ) );
+        for ( int i = 0; i + shift <= PARITY_SIZE; ++i ) locator[i + shift] ^= GF::mul( scale, previous[i] );
+        std::memcpy( previous, copy, sizeof( previous ) );
+        errors = n + 1 - errors;
+        previous_discrepancy = discrepancy;
+        shift = 1;
+      } else {
+        for ( int i = 0; i + shift <= PARITY_SIZE; ++i ) locator[i + shift] ^= GF::mul( scale, previous[i] );
+        ++shift;
+      }
+    }
+    if ( errors > MAX_CORRECTABLE )
+      return -1;
+
+    // Chien search for the roots, byte i corresponds to the power size - 1 - i
+    size_t positions[MAX_CORRECTABLE];
+    int found = 0;
+    for ( size_t i = 0; i < size; ++i ) {
+      const int power = static_cast<int>( size - 1 - i );
+      const uint8_t inverse = GF::alphaPow( 255 - power % 255 );
+      uint8_t value = 0;
+      for ( int k = errors; k >= 0; --k ) value = GF::mul( value, inverse ) ^ locator[k];
+      if ( value != 0 )
+        continue;
+      if ( found == errors )
+        return -1;
+      positions[found++] = i;
+    }
+    if ( found != errors )
+      return -1;
+
+    // Forney for the error values using the evaluator S(x) * locator(x) mod x^PARITY_SIZE
+    uint8_t evaluator[PARITY_SIZE] = {};
+    for ( int k = 0; k < PARITY_SIZE; ++k ) {
+      for ( int i = 0; i <= std::min( k, errors ); ++i ) evaluator[k] ^= GF::mul( locator[i], syndromes[k - i] );
+    }
+    uint8_t values[MAX_CORRECTABLE];
+    for ( int e = 0; e < found; ++e ) {
+      const int power = static_cast<int>( size - 1 - positions[e] );
+      const uint8_t inverse = GF::alphaPow( 255 - power % 255 );
+      uint8_t numerator = 0;
+      for ( int k = PARITY_SIZE - 1; k >= 0; --k ) numerator = GF::mul( numerator, inverse ) ^ evaluator[k];
+      // Formal derivative, only odd powers remain in characteristic 2
+      uint8_t denominator = 0;
+      for ( int k = errors - ( errors % 2 == 0 ? 1 : 0 ); k >= 1; k -= 2 )
+        denominator = GF::mul( denominator, GF::mul( inverse, inverse ) ) ^ locator[k];
+      if ( denominator == 0 )
+        return -1;
+      values[e] = GF::mul( GF::alphaPow( power ), GF::div( numerator, denominator ) );
+    }
+    for ( int e = 0; e < found; ++e ) codeword[positions[e]] ^= values[e];
+    return found;
+  }
+
+private:
+  static constexpr std::array<uint8_t, PARITY_SIZE + 1> generator_ = makeReedSolomonGenerator<PARITY_SIZE>();
+};
+
+//! Extended Hamming (8,4) code of a nibble. Any two codewords differ in at least four bits.
+constexpr uint8_t hammingEncode( uint8_t nibble )
+{
+  const int d0 = nibble & 1, d1 = ( nibble >> 1 ) & 1, d2 = ( nibble >> 2 ) & 1, d3 = ( nibble >> 3 ) & 1;
+  int code = ( d0 ^ d1 ^ d3 ) | ( d0 ^ d2 ^ d3 ) << 1 | d0 << 2 | ( d1 ^ d2 ^ d3 ) << 3 | d1 << 4 | d2 << 5 | d3 << 6;
+  int parity = 0;
+  for ( int bit = 0; bit < 7; ++bit ) parity ^= ( code >> bit ) & 1;
+  return static_cast<uint8_t>( code | parity << 7 );
+}
+
+constexpr int bitCount( uint8_t value )
+{
+  int count = 0;
+  for ( ; value != 0; value &= value - 1 ) ++count;
+  return count;
+}
+
+//! Returns the nibble or -1 if more than one bit is wrong.
+inline int hammingDecode( uint8_t code )
+{
+  for ( uint8_t nibble = 0; nibble < 16; ++nibble ) {
+    if ( bitCount( code ^ hammingEncode( nibble ) ) <= 1 )
+      return nibble;
+  }
+  return -1;
+}
+} // namespace detail
+
+struct FecStatistics {
+  //! Blocks that were received without errors or were corrected.
+  uint32_t decoded_blocks = 0;
+  //! Blocks in which errors were corrected.
+  uint32_t corrected_blocks = 0;
+  //! Bytes corrected in these blocks.
+  uint32_t corrected_bytes = 0;
+  //! Blocks with more errors than the parity or the header can correct. Their data is dropped.
+  uint32_t failed_blocks = 0;
+  //! Bytes skipped while searching for the start of the next block, e.g., after a failed block.
+  uint32_t skipped_bytes = 0;
+};
+
+/*!
+ * Forward error correction between the CrossTalker and another serial abstraction for noisy byte
+ * streams, e.g., radio UART links. Written data is split into blocks of up to BLOCK_SIZE bytes
+ * that are sent with a sync byte, the Hamming coded block length and PARITY_SIZE Reed-Solomon
+ * parity bytes. The receiver corrects up to PARITY_SIZE / 2 erroneous bytes per block before the
+ * data reaches the CRC check of the CrossTalker. Uncorrectable blocks are dropped and the receiver
+ * searches for the next sync byte.
+ *
+ * Both sides have to use the same BLOCK_SIZE and PARITY_SIZE. Every write is sent as at least one
+ * block, so the overhead is smallest if data is written in chunks of about BLOCK_SIZE bytes.
+ * Writes of up to MAX_WRITE_SIZE bytes are encoded into an internal buffer and passed to the
+ * wrapped serial in one write. Nothing is allocated on the heap.
+ */
+template<int BLOCK_SIZE = 32, int PARITY_SIZE = 8, int MAX_WRITE_SIZE = 256>
+class FecSerialWrapper : public SerialAbstraction
+{
+  static_assert( PARITY_SIZE >= 2 && PARITY_SIZE % 2 == 0, "PARITY_SIZE must be an even number >= 2." );
+  static_assert( BLOCK_SIZE > 0 && BLOCK_SIZE + PARITY_SIZE <= 255,
+                 "A block including its parity can not exceed 255 bytes." );
+  static_assert( MAX_WRITE_SIZE > 0, "MAX_WRITE_SIZE must be positive." );
+
+public:
+  static constexpr uint8_t SYNC_BYTE = 0xA7;
+  //! Sync byte and the two Hamming coded nibbles of the block length.
+  static constexpr int HEADER_SIZE = 3;
+  static constexpr int MAX_ENCODED_BLOCK_SIZE = HEADER_SIZE + BLOCK_SIZE + PARITY_SIZE;
+
+  //! Number of bytes on the wire for length bytes of data written at once.
+  static constexpr size_t encodedSize( size_t length )
+  {
+    return length + ( length + BLOCK_SIZE - 1 ) / BLOCK_SIZE * ( HEADER_SIZE + PARITY_SIZE );
+  }
+
+  explicit FecSerialWrapper( std::unique_ptr<SerialAbstraction> serial ) : serial_( std::move( serial ) ) { }
+
+  //! Decodes the received blocks and returns the number of decoded bytes that can be read.
+  int available() const override
+  {
+    if ( rx_.decoded_index == rx_.decoded_size )
+      _decodeBlock();
+    return rx_.decoded_size - rx_.decoded_index;
+  }
+
+  int read( uint8_t *data, size_t length ) override
+  {
+    size_t count = 0;
+    while ( count < length ) {
+      if ( rx_.decoded_index == rx_.decoded_size && !_decodeBlock() )
+        break;
+      const size_t chunk = std::min<size_t>( length - count, rx_.decoded_size - rx_.decoded_index );
+      std::memcpy( data + count, rx_.decoded.data() + rx_.decoded_index, chunk );
+      rx_.decoded_index += chunk;
+      count += chunk;
+    }
+    return static_cast<int>( count );
+  }
+
+  bool write( const uint8_t *data, size_t length ) override
+  {
+    while ( length > 0 ) {
+      const size_t chunk = std::min<size_t>( length, MAX_WRITE_SIZE );
+      size_t size = 0;
+      for ( size_t offset = 0; offset < chunk; offset += BLOCK_SIZE ) {
+        const size_t block_size = std::min<size_t>( chunk - offset, BLOCK_SIZE );
+        uint8_t *block = tx_buffer_.data() + size;
+        block[0] = SYNC_BYTE;
+        block[1] = detail::hammingEncode( block_size >> 4 );
+        block[2] = detail::hammingEncode( block_size & 0x0F );
+        std::memcpy( block + HEADER_SIZE, data + offset, block_size );
+        detail::ReedSolomon<PARITY_SIZE>::encode( data + offset, block_size, block + HEADER_SIZE + block_size );
+        size += HEADER_SIZE + block_size + PARITY_SIZE;
+      }
+      if ( !serial_->write( tx_buffer_.data(), size ) )
+        return false;
+      data += chunk;
+      length -= chunk;
+    }
+    return true;
+  }
+
+  const FecStatistics &statistics() const { return rx_.statistics; }
+
+  void resetStatistics() { rx_.statistics = FecStatistics{}; }
+
+private:
+  //! Decodes the next block from the wrapped serial. Returns false if no complete block was received yet.
+  bool _decodeBlock() const
+  {
+    rx_.decoded_index = rx_.decoded_size = 0;
+    while ( true ) {
+      if ( rx_.raw_size < HEADER_SIZE ) {
+        if ( !_fill( HEADER_SIZE ) )
+          return false;
+        continue;
+      }
+      const int block_size = _blockSize();
+      if ( block_size < 0 ) {
+        if ( !rx_.searching )
+          ++rx_.statistics.failed_blocks;
+        _consume( 1, true );
+        continue;
+      }
+      const int encoded_size = HEADER_SIZE + block_size + PARITY_SIZE;
+      if ( rx_.raw_size < encoded_size ) {
+        if ( !_fill( encoded_size ) )
+          return false;
+        continue;
+      }
+      const int corrected =
+          detail::ReedSolomon<PARITY_SIZE>::decode( rx_.raw.data() + HEADER_SIZE, block_size + PARITY_SIZE );
+      if ( corrected < 0 ) {
+        // While searching for a block, sync bytes in the data are not counted as failed blocks
+        if ( !rx_.searching )
+          ++rx_.statistics.failed_blocks;
+        _consume( 1, true );
+        continue;
+      }
+      ++rx_.statistics.decoded_blocks;
+      if ( corrected > 0 ) {
+        ++rx_.statistics.corrected_blocks;
+        rx_.statistics.corrected_bytes += corrected;
+      }
+      std::memcpy( rx_.decoded.data(), rx_.raw.data() + HEADER_SIZE, block_size );
+      rx_.decoded_size = block_size;
+      rx_.searching = false;
+      _consume( encoded_size, false );
+      return true;
+    }
+  }
+
+  //! Reads from the wrapped serial until size raw bytes are buffered. Returns false if not enough data is available.
+  bool _fill( int size ) const
+  {
+    while ( rx_.raw_size < size ) {
+      if ( serial_->available() <= 0 )
+        return false;
+      const int count = serial_->read( rx_.raw.data() + rx_.raw_size, size - rx_.raw_size );
+      if ( count <= 0 )
+        return false;
+      rx_.raw_size += count;
+    }
+    return true;
+  }
+
+  //! The size of the block starting at the first raw byte or -1 if there is no valid block header.
+  int _blockSize() const
+  {
+    // Tolerate a bit error in the sync byte, the header and the parity reject false matches
+    if ( detail::bitCount( rx_.raw[0] ^ SYNC_BYTE ) > 1 )
+      return -1;
+    const int high = detail::hammingDecode( rx_.raw[1] );
+    const int low = detail::hammingDecode( rx_.raw[2] );
+    if ( high < 0 || low < 0 )
+      return -1;
+    const int size = high << 4 | low;
+    return size == 0 || size > BLOCK_SIZE ? -1 : size;
+  }
+
+  void _consume( int count, bool skipped ) const
+  {
+    if ( skipped ) {
+      rx_.statistics.skipped_bytes += count;
+      rx_.searching = true;
+    }
+    rx_.raw_size -= count;
+    std::memmove( rx_.raw.data(), rx_.raw.data() + count, rx_.raw_size );
+  }
+
+  // Decoding happens in available(), hence, the receive state is mutable
+  struct ReceiveState {
+    std::array<uint8_t, MAX_ENCODED_BLOCK_SIZE> raw;
+    int raw_size = 0;
+    std::array<uint8_t, BLOCK_SIZE> decoded;
+    int decoded_size = 0;
+    int decoded_index = 0;
+    bool searching = true;
+    FecStatistics statistics;
+  };
+
+  std::unique_ptr<SerialAbstraction> serial_;
+  std::array<uint8_t, encodedSize( MAX_WRITE_SIZE )> tx_buffer_;
+  mutable ReceiveState rx_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_FEC_SERIAL_WRAPPER_HPP
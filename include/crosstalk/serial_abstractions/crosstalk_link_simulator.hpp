@@ -0,0 +1,291 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CROSSTALK_LINK_SIMULATOR_HPP
+#define CROSSTALK_LINK_SIMULATOR_HPP
+
+#ifndef CROSSTALK_SERIAL_ABSTRACTION_HPP
+  #error "Include crosstalk.hpp or crosstalk/serial_abstraction.hpp before including crosstalk_link_simulator.hpp"
+#endif // CROSSTALK_SERIAL_ABSTRACTION_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+
+namespace crosstalk
+{
+
+struct LinkSimulatorConfig {
+  //! Symbol rate of the simulated UART in baud.
+  uint32_t baud_rate = 115200;
+  //! Bits on the wire per byte including start and stop bits, e.g., 10 for 8N1.
+  uint8_t bits_per_byte = 10;
+  //! Size of the sender's TX buffer. This is what availableForWrite() reports when idle.
+  size_t tx_buffer_size = 256;
+  //! Size of the receiver's RX buffer. Bytes arriving while it is full are lost.
+  size_t rx_buffer_size = 4096;
+  //! Constant latency added to every byte after it left the wire.
+  std::chrono::nanoseconds latency{ 0 };
+  //! Probability for every transmitted bit to be flipped.
+  double bit_error_rate = 0.0;
+  //! Probability for every transmitted byte to be lost.
+  double byte_drop_rate = 0.0;
+  //! Probability for a noise burst to start at every transmitted byte.
+  double burst_rate = 0.0;
+  //! Number of bytes replaced by random noise during a burst.
+  size_t burst_length = 16;
+  //! Seed for the error injection to make runs reproducible.
+  uint32_t seed = 42;
+};
+
+/*!
+ * Simulates a full-duplex UART link between two endpoints A and B.
+ * Bytes are paced at the configured baud rate, can be delayed, corrupted or dropped.
+ * The time is either virtual and only moves forward if advance() is called, or real time.
+ * The simulator has to outlive the endpoints created with createEndpoint().
+ * All methods are thread-safe.
+ */
+class LinkSimulator
+{
+public:
+  enum class Side : uint8_t { A = 0, B = 1 };
+
+  enum class ClockMode : uint8_t { Virtual, Real };
+
+  struct Counters {
+    size_t bytes_written = 0;
+    size_t bytes_delivered = 0;
+    size_t bits_flipped = 0;
+    size_t bytes_dropped = 0;
+    size_t bytes_in_bursts = 0;
+    size_t bytes_lost_rx_overflow = 0;
+    size_t writes_rejected = 0;
+  };
+
+  class Endpoint : public SerialAbstraction
+  {
+  public:
+    Endpoint( LinkSimulator &simulator, Side side ) : simulator_( simulator ), side_( side ) { }
+
+    int available() const override { return simulator_.available( side_ ); }
+
+    int read( uint8_t *data, size_t length ) override
+    {
+      return simulator_.read( side_, data, length );
+    }
+
+    //! Like the Arduino serial wrappers, only writes if the whole data fits into the TX buffer.
+    bool write( const uint8_t *data, size_t length ) override
+    {
+      return simulator_.write( side_, data, length );
+    }
+
+    int availableForWrite() const { return simulator_.availableForWrite( side_ ); }
+
+  private:
+    LinkSimulator &simulator_;
+    Side side_;
+  };
+
+  explicit LinkSimulator( const LinkSimulatorConfig &config = {},
+                          ClockMode clock_mode = ClockMode::Virtual )
+      : config_( config ), clock_mode_( clock_mode ), start_( std::chrono::steady_clock::now() ),
+        rng_( config.seed )
+  {
+    byte_time_ = std::chrono::nanoseconds( 1000000000ULL * config_.bits_per_byte / config_.baud_rate );
+    if ( config_.bit_error_rate > 0 )
+      bits_until_error_ = std::geometric_distribution<uint64_t>( config_.bit_error_rate )( rng_ );
+  }
+
+  //! Creates the serial abstraction for the given side of the link.
+  std::unique_ptr<Endpoint> createEndpoint( Side side )
+  {
+    return std::make_unique<Endpoint>( *this, side );
+  }
+
+  //! Advances the virtual clock. Has no effect in real time mode.
+  void advance( std::chrono::nanoseconds duration )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    virtual_time_ += duration;
+  }
+
+  //! The current time of the simulation.
+  std::chrono::nanoseconds now() const
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    return _now();
+  }
+
+  //! The time it takes to transmit one byte.
+  std::chrono::nanoseconds byteTime() const { return byte_time_; }
+
+  const LinkSimulatorConfig &config() const { return config_; }
+
+  Counters counters() const
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    return counters_;
+  }
+
+  int available( Side side )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    Channel &channel = _receiving( side );
+    _update( channel );
+    return static_cast<int>( channel.rx_buffer.size() );
+  }
+
+  int read( Side side, uint8_t *data, size_t length )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    Channel &channel = _receiving( side );
+    _update( channel );
+    length = std::min( length, channel.rx_buffer.size() );
+    std::copy_n( channel.rx_buffer.begin(), length, data );
+    channel.rx_buffer.erase( channel.rx_buffer.begin(), channel.rx_buffer.begin() + length );
+    return static_cast<int>( length );
+  }
+
+  bool write( Side side, const uint8_t *data, size_t length )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    Channel &channel = _sending( side );
+    _update( channel );
+    if ( channel.tx_queue.size() + length > config_.tx_buffer_size ) {
+      ++counters_.writes_rejected;
+      return false;
+    }
+    if ( channel.tx_queue.empty() )
+      channel.wire_free_at = std::max( channel.wire_free_at, _now() );
+    channel.tx_queue.insert( channel.tx_queue.end(), data, data + length );
+    counters_.bytes_written += length;
+    return true;
+  }
+
+  int availableForWrite( Side side )
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    Channel &channel = _sending( side );
+    _update( channel );
+    return static_cast<int>( config_.tx_buffer_size - channel.tx_queue.size() );
+  }
+
+private:
+  struct InFlightByte {
+    std::chrono::nanoseconds arrival;
+    uint8_t value;
+  };
+
+  struct Channel {
+    std::deque<uint8_t> tx_queue;
+    std::deque<InFlightByte> in_flight;
+    std::deque<uint8_t> rx_buffer;
+    std::chrono::nanoseconds wire_free_at{ 0 };
+    size_t burst_remaining = 0;
+  };
+
+  std::chrono::nanoseconds _now() const
+  {
+    if ( clock_mode_ == ClockMode::Virtual )
+      return virtual_time_;
+    return std::chrono::steady_clock::now() - start_;
+  }
+
+  //! Channel that transports the data sent by the given side.
+  Channel &_sending( Side side ) { return channels_[static_cast<int>( side )]; }
+
+  //! Channel that transports the data received by the given side.
+  Channel &_receiving( Side side ) { return channels_[1 - static_cast<int>( side )]; }
+
+  void _update( Channel &channel )
+  {
+    const std::chrono::nanoseconds now = _now();
+    while ( !channel.tx_queue.empty() && channel.wire_free_at + byte_time_ <= now ) {
+      channel.wire_free_at += byte_time_;
+      uint8_t value = channel.tx_queue.front();
+      channel.tx_queue.pop_front();
+      if ( _applyErrors( channel, value ) )
+        channel.in_flight.push_back( { channel.wire_free_at + config_.latency, value } );
+    }
+    while ( !channel.in_flight.empty() && channel.in_flight.front().arrival <= now ) {
+      if ( channel.rx_buffer.size() < config_.rx_buffer_size ) {
+        channel.rx_buffer.push_back( channel.in_flight.front().value );
+        ++counters_.bytes_delivered;
+      } else {
+        ++counters_.bytes_lost_rx_overflow;
+      }
+      channel.in_flight.pop_front();
+    }
+  }
+
+  //! Applies the configured errors to the byte. Returns false if the byte was dropped.
+  bool _applyErrors( Channel &channel, uint8_t &value )
+  {
+    if ( config_.byte_drop_rate > 0 && uniform_( rng_ ) < config_.byte_drop_rate ) {
+      ++counters_.bytes_dropped;
+      return false;
+    }
+    if ( channel.burst_remaining == 0 && config_.burst_rate > 0 &&
+         uniform_( rng_ ) < config_.burst_rate ) {
+      channel.burst_remaining = config_.burst_length;
+    }
+    if ( channel.burst_remaining > 0 ) {
+      --channel.burst_remaining;
+      value = static_cast<uint8_t>( rng_() );
+      ++counters_.bytes_in_bursts;
+      return true;
+    }
+    if ( config_.bit_error_rate <= 0 )
+      return true;
+    // Sample the distance to the next bit error instead of rolling a die for every bit
+    for ( int bit = 0; bit < 8; ++bit ) {
+      if ( bits_until_error_ == 0 ) {
+        bits_until_error_ = std::geometric_distribution<uint64_t>( config_.bit_error_rate )( rng_ );
+        value ^= static_cast<uint8_t>( 1U << bit );
+        ++counters_.bits_flipped;
+        continue;
+      }
+      --bits_until_error_;
+    }
+    return true;
+  }
+
+  LinkSimulatorConfig config_;
+  ClockMode clock_mode_;
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::nanoseconds virtual_time_{ 0 };
+  std::chrono::nanoseconds byte_time_;
+  std::array<Channel, 2> channels_;
+  Counters counters_;
+  std::mt19937 rng_;
+  std::uniform_real_distribution<double> uniform_{ 0.0, 1.0 };
+  uint64_t bits_until_error_ = 0;
+  mutable std::mutex mutex_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_LINK_SIMULATOR_HPP
@@ -0,0 +1,270 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Stefan Fabian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef CROSSTALK_UNIX_SOCKET_SERIAL_WRAPPER_HPP
+#define CROSSTALK_UNIX_SOCKET_SERIAL_WRAPPER_HPP
+
+#ifndef CROSSTALK_SERIAL_ABSTRACTION_HPP
+  #error "Include crosstalk.hpp or crosstalk/serial_abstraction.hpp before including crosstalk_unix_socket_serial_wrapper.hpp"
+#endif // CROSSTALK_SERIAL_ABSTRACTION_HPP
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <poll.h>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace crosstalk
+{
+
+enum class UnixSocketMode : uint8_t {
+  //! SOCK_STREAM, behaves like a serial connection.
+  Stream,
+  //! SOCK_SEQPACKET, packets hold one or more frames without start markers.
+  Packet,
+};
+
+/*!
+ * Serial abstraction for connected Unix domain sockets, e.g., for local bridges and tests.
+ * In UnixSocketMode::Packet, the socket is a packet transport. The CrossTalker sends its frames
+ * without start markers in packets and splits received packets into frames without scanning for
+ * start markers, so generic data can not be sent over a packet socket.
+ * The socket is owned and closed on destruction.
+ */
+class UnixSocketSerialWrapper : public crosstalk::SerialAbstraction
+{
+public:
+  //! Takes ownership of a connected SOCK_STREAM or SOCK_SEQPACKET socket.
+  explicit UnixSocketSerialWrapper( int fd ) : fd_( fd )
+  {
+    int type = SOCK_STREAM;
+    socklen_t length = sizeof( type );
+    if ( getsockopt( fd_, SOL_SOCKET, SO_TYPE, &type, &length ) == 0 && type == SOCK_SEQPACKET )
+      mode_ = UnixSocketMode::Packet;
+  }
+
+  ~UnixSocketSerialWrapper() override
+  {
+    if ( fd_ >= 0 )
+      ::close( fd_ );
+  }
+
+  UnixSocketSerialWrapper( const UnixSocketSerialWrapper & ) = delete;
+  UnixSocketSerialWrapper &operator=( const UnixSocketSerialWrapper & ) = delete;
+
+  //! Connects to a socket bound to path. Returns nullptr on failure.
+  static std::unique_ptr<UnixSocketSerialWrapper> connect( const std::string &path,
+                                                           UnixSocketMode mode = UnixSocketMode::Stream )
+  {
+    sockaddr_un address{};
+    if ( !makeAddress( path, address ) )
+      return nullptr;
+    int fd = socket( AF_UNIX, socketType( mode ) | SOCK_CLOEXEC, 0 );
+    if ( fd < 0 )
+      return nullptr;
+    if ( ::connect( fd, reinterpret_cast<const sockaddr *>( &address ), sizeof( address ) ) != 0 ) {
+      ::close( fd );
+      return nullptr;
+    }
+    return std::make_unique<UnixSocketSerialWrapper>( fd );
+  }
+
+  //! Creates two connected sockets, e.g., to bridge two CrossTalkers in one process.
+  static bool pair( UnixSocketMode mode, std::unique_ptr<UnixSocketSerialWrapper> &first,
+                    std::unique_ptr<UnixSocketSerialWrapper> &second )
+  {
+    int fds[2];
+    if ( socketpair( AF_UNIX, socketType( mode ) | SOCK_CLOEXEC, 0, fds ) != 0 )
+      return false;
+    first = std::make_unique<UnixSocketSerialWrapper>( fds[0] );
+    second = std::make_unique<UnixSocketSerialWrapper>( fds[1] );
+    return true;
+  }
+
+  //! In packet mode, the size of the next non-empty packet. Empty packets are discarded.
+  int available() const override
+  {
+    if ( mode_ == UnixSocketMode::Packet ) {
+      // FIONREAD returns the size of all queued packets, peeking returns the size of the next one
+      uint8_t byte;
+      while ( true ) {
+        ssize_t size = recv( fd_, &byte, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT );
+        if ( size < 0 && errno == EINTR )
+          continue;
+        if ( size != 0 )
+          return size < 0 ? 0 : static_cast<int>( size );
+        // An empty packet would block the packets behind it since a size of 0 means that nothing
+        // is available. After the peer closed the socket, recv also returns 0 at the end of the
+        // stream, hence, only one empty packet is discarded per call then.
+        pollfd pfd = { fd_, POLLIN | POLLRDHUP, 0 };
+        const bool closed = poll( &pfd, 1, 0 ) > 0 && ( pfd.revents & ( POLLHUP | POLLRDHUP ) ) != 0;
+        recv( fd_, &byte, 0, MSG_DONTWAIT );
+        if ( closed )
+          return 0;
+      }
+    }
+    int count = 0;
+    if ( ioctl( fd_, FIONREAD, &count ) != 0 )
+      return 0;
+    return count;
+  }
+
+  //! In packet mode, receives at most one packet and discards the part that does not fit.
+  int read( uint8_t *data, size_t length ) override
+  {
+    ssize_t count;
+    do {
+      count = recv( fd_, data, length, MSG_DONTWAIT );
+    } while ( count < 0 && errno == EINTR );
+    return count < 0 ? 0 : static_cast<int>( count );
+  }
+
+  /*!
+   * Writes all data. In packet mode, the data is sent as one packet and sendPacket is equivalent.
+   * Waits until the socket is writable since partial writes would corrupt objects.
+   */
+  bool write( const uint8_t *data, size_t length ) override
+  {
+    while ( length > 0 ) {
+      ssize_t count = send( fd_, data, length, MSG_NOSIGNAL );
+      if ( count < 0 ) {
+        if ( errno == EINTR )
+          continue;
+        if ( errno != EAGAIN && errno != EWOULDBLOCK )
+          return false;
+        pollfd pfd = { fd_, POLLOUT, 0 };
+        if ( poll( &pfd, 1, -1 ) < 0 && errno != EINTR )
+          return false;
+        continue;
+      }
+      data += count;
+      length -= count;
+    }
+    return true;
+  }
+
+  bool isPacketTransport() const override { return mode_ == UnixSocketMode::Packet; }
+
+  int receivePacket( uint8_t *data, size_t length ) override
+  {
+    ssize_t count;
+    do {
+      // With MSG_TRUNC the real size of the packet is returned even if it did not fit
+      count = recv( fd_, data, length, MSG_DONTWAIT | MSG_TRUNC );
+    } while ( count < 0 && errno == EINTR );
+    if ( count < 0 )
+      return 0;
+    return static_cast<size_t>( count ) > length ? -1 : static_cast<int>( count );
+  }
+
+  UnixSocketMode mode() const { return mode_; }
+
+  int fd() const { return fd_; }
+
+  static int socketType( UnixSocketMode mode )
+  {
+    return mode == UnixSocketMode::Packet ? SOCK_SEQPACKET : SOCK_STREAM;
+  }
+
+  static bool makeAddress( const std::string &path, sockaddr_un &address )
+  {
+    if ( path.empty() || path.size() >= sizeof( address.sun_path ) )
+      return false;
+    address.sun_family = AF_UNIX;
+    std::memcpy( address.sun_path, path.c_str(), path.size() + 1 );
+    return true;
+  }
+
+private:
+  int fd_;
+  UnixSocketMode mode_ = UnixSocketMode::Stream;
+};
+
+/*!
+ * Listening Unix domain socket that accepts connections as UnixSocketSerialWrappers.
+ * An existing socket file at the path is replaced and the file is removed on destruction.
+ */
+class UnixSocketServer
+{
+public:
+  UnixSocketServer( const std::string &path, UnixSocketMode mode = UnixSocketMode::Stream )
+  {
+    sockaddr_un address{};
+    if ( !UnixSocketSerialWrapper::makeAddress( path, address ) )
+      return;
+    fd_ = socket( AF_UNIX, UnixSocketSerialWrapper::socketType( mode ) | SOCK_CLOEXEC, 0 );
+    if ( fd_ < 0 )
+      return;
+    ::unlink( path.c_str() );
+    if ( bind( fd_, reinterpret_cast<const sockaddr *>( &address ), sizeof( address ) ) != 0 ||
+         listen( fd_, 8 ) != 0 ) {
+      ::close( fd_ );
+      fd_ = -1;
+      return;
+    }
+    path_ = path;
+  }
+
+  ~UnixSocketServer()
+  {
+    if ( fd_ < 0 )
+      return;
+    ::close( fd_ );
+    ::unlink( path_.c_str() );
+  }
+
+  UnixSocketServer( const UnixSocketServer & ) = delete;
+  UnixSocketServer &operator=( const UnixSocketServer & ) = delete;
+
+  bool isOpen() const { return fd_ >= 0; }
+
+  /*!
+   * Waits up to timeout_ms for a connection, -1 waits forever.
+   * @return The connection or nullptr on timeout or error.
+   */
+  std::unique_ptr<UnixSocketSerialWrapper> accept( int timeout_ms = -1 )
+  {
+    if ( fd_ < 0 )
+      return nullptr;
+    pollfd pfd = { fd_, POLLIN, 0 };
+    if ( poll( &pfd, 1, timeout_ms ) <= 0 )
+      return nullptr;
+    int fd = ::accept4( fd_, nullptr, nullptr, SOCK_CLOEXEC );
+    if ( fd < 0 )
+      return nullptr;
+    return std::make_unique<UnixSocketSerialWrapper>( fd );
+  }
+
+  int fd() const { return fd_; }
+
+private:
+  int fd_ = -1;
+  std::string path_;
+};
+} // namespace crosstalk
+
+#endif // CROSSTALK_UNIX_SOCKET_SERIAL_WRAPPER_HPP
@@ -0,0 +1,168 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_fd_serial_wrapper.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_unix_socket_serial_wrapper.hpp"
+#include "test_objects.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <pty.h>
+#include <thread>
+
+using namespace std::chrono;
+
+//! Counts the syscalls issued through the wrapped serial abstraction.
+class CountingSerialWrapper : public crosstalk::SerialAbstraction
+{
+public:
+  explicit CountingSerialWrapper( std::unique_ptr<crosstalk::SerialAbstraction> serial )
+      : serial_( std::move( serial ) )
+  {
+  }
+
+  int available() const override
+  {
+    ++available_calls;
+    return serial_->available();
+  }
+
+  int read( uint8_t *data, size_t length ) override
+  {
+    ++read_calls;
+    return serial_->read( data, length );
+  }
+
+  bool write( const uint8_t *data, size_t length ) override { return serial_->write( data, length ); }
+
+  bool isPacketTransport() const override { return serial_->isPacketTransport(); }
+
+  int receivePacket( uint8_t *data, size_t length ) override
+  {
+    ++read_calls;
+    return serial_->receivePacket( data, length );
+  }
+
+  mutable size_t available_calls = 0;
+  size_t read_calls = 0;
+
+private:
+  std::unique_ptr<crosstalk::SerialAbstraction> serial_;
+};
+
+void benchmarkThroughput( const char *name, std::unique_ptr<crosstalk::SerialAbstraction> device_serial,
+                          std::unique_ptr<crosstalk::SerialAbstraction> host_serial, int count,
+                          bool packet_batching = false )
+{
+  const CommStatus status{ 1378,
+                           -98.0f,
+                           -85.0f,
+                           0.0f,
+                           CommQuality::NONE,
+                           CommQuality::MEDIUM_QUALITY,
+                           CommQuality::HIGH_QUALITY,
+                           CommState::DISCONNECTED,
+                           CommState::CONNECTED,
+                           CommState::CONNECTED };
+  auto start = steady_clock::now();
+  std::thread device( [&]() {
+    crosstalk::CrossTalker<512, 256> crosstalker( std::move( device_serial ) );
+    crosstalker.setPacketBatching( packet_batching );
+    for ( int i = 0; i < count; ++i ) crosstalker.sendObject( status );
+    crosstalker.flushPackets();
+  } );
+  auto serial = std::make_unique<CountingSerialWrapper>( std::move( host_serial ) );
+  CountingSerialWrapper &counter = *serial;
+  crosstalk::CrossTalker<4096, 256> host( std::move( serial ) );
+  int received = 0;
+  int failed = 0;
+  while ( received + failed < count ) {
+    host.processSerialData( false );
+    while ( host.hasObject() ) {
+      CommStatus obj;
+      auto result = host.readObject( obj );
+      if ( result == crosstalk::ReadResult::NotEnoughData )
+        break;
+      ++( result == crosstalk::ReadResult::Success ? received : failed );
+    }
+  }
+  device.join();
+  double seconds = duration<double>( steady_clock::now() - start ).count();
+  size_t frame_size = 8 + crosstalk::util::compute_size( status );
+  std::printf( "%s throughput: %d frames (%zu B each) in %.3f s: %.0f frames/s, %.1f MB/s, "
+               "%.3f read() and %.3f available() calls per frame, %d failed\n",
+               name, received, frame_size, seconds, received / seconds,
+               received * frame_size / seconds / 1e6, double( counter.read_calls ) / received,
+               double( counter.available_calls ) / received, failed );
+}
+
+void benchmarkLatency( const char *name, std::unique_ptr<crosstalk::SerialAbstraction> device_serial,
+                       std::unique_ptr<crosstalk::SerialAbstraction> host_serial, int count )
+{
+  std::atomic<bool> running{ true };
+  std::thread device( [&]() {
+    crosstalk::CrossTalker<512, 256> crosstalker( std::move( device_serial ) );
+    TestObjectSimple obj;
+    while ( running ) {
+      crosstalker.processSerialData();
+      if ( crosstalker.readObject( obj ) == crosstalk::ReadResult::Success )
+        crosstalker.sendObject( obj );
+      else
+        std::this_thread::yield();
+    }
+  } );
+  crosstalk::CrossTalker<512, 256> host( std::move( host_serial ) );
+  std::vector<double> round_trips;
+  round_trips.reserve( count );
+  TestObjectSimple obj;
+  for ( int i = 0; i < count; ++i ) {
+    auto start = steady_clock::now();
+    host.sendObject( TestObjectSimple{ i, 1.0f } );
+    while ( true ) {
+      host.processSerialData();
+      if ( host.readObject( obj ) == crosstalk::ReadResult::Success )
+        break;
+      std::this_thread::yield(); // Let the device thread run if both share a core
+    }
+    round_trips.push_back( duration<double, std::micro>( steady_clock::now() - start ).count() );
+  }
+  running = false;
+  device.join();
+  std::sort( round_trips.begin(), round_trips.end() );
+  std::printf( "%s latency: %d round trips, min %.1f us, median %.1f us, p99 %.1f us, max %.1f us\n",
+               name, count, round_trips.front(), round_trips[count / 2], round_trips[count * 99 / 100],
+               round_trips.back() );
+}
+
+int main()
+{
+  int master;
+  int slave;
+  if ( openpty( &master, &slave, nullptr, nullptr, nullptr ) != 0 ) {
+    std::perror( "openpty" );
+    return 1;
+  }
+  crosstalk::makeRawTty( slave );
+  auto fd = []( int fd ) { return std::make_unique<crosstalk::FileDescriptorSerialWrapper>( fd ); };
+  benchmarkThroughput( "pty", fd( slave ), fd( master ), 200000 );
+  benchmarkLatency( "pty", fd( slave ), fd( master ), 5000 );
+  close( master );
+  close( slave );
+
+  // Packet sockets deliver frames without start markers, so the receiver does not scan for markers
+  for ( auto mode : { crosstalk::UnixSocketMode::Stream, crosstalk::UnixSocketMode::Packet } ) {
+    const char *name = mode == crosstalk::UnixSocketMode::Stream ? "unix stream" : "unix seqpacket";
+    std::unique_ptr<crosstalk::UnixSocketSerialWrapper> device, host;
+    if ( !crosstalk::UnixSocketSerialWrapper::pair( mode, device, host ) ) {
+      std::perror( "socketpair" );
+      return 1;
+    }
+    benchmarkThroughput( name, std::move( device ), std::move( host ), 200000 );
+    crosstalk::UnixSocketSerialWrapper::pair( mode, device, host );
+    benchmarkLatency( name, std::move( device ), std::move( host ), 5000 );
+  }
+  // Several frames per packet, up to the serialization buffer size of the device
+  std::unique_ptr<crosstalk::UnixSocketSerialWrapper> device, host;
+  crosstalk::UnixSocketSerialWrapper::pair( crosstalk::UnixSocketMode::Packet, device, host );
+  benchmarkThroughput( "unix seqpacket batched", std::move( device ), std::move( host ), 200000, true );
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_fec_serial_wrapper.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_link_simulator.hpp"
+#include "test_objects.hpp"
+#include <cstdio>
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+using Side = crosstalk::LinkSimulator::Side;
+
+struct GoodputResult {
+  size_t frames_sent = 0;
+  size_t frames_received = 0;
+  size_t frames_failed = 0;
+  size_t bytes_received = 0;
+};
+
+/*!
+ * Sends CommStatus objects interleaved with text as fast as the TX buffer allows and
+ * measures how many arrive intact over the given simulated duration.
+ * With fec, both sides use the FecSerialWrapper with its default block and parity size.
+ */
+GoodputResult runGoodput( const crosstalk::LinkSimulatorConfig &config,
+                          nanoseconds simulated_duration, nanoseconds loop_period, bool fec )
+{
+  crosstalk::LinkSimulator link( config );
+  std::unique_ptr<crosstalk::SerialAbstraction> device_serial = link.createEndpoint( Side::A );
+  std::unique_ptr<crosstalk::SerialAbstraction> host_serial = link.createEndpoint( Side::B );
+  if ( fec ) {
+    device_serial = std::make_unique<crosstalk::FecSerialWrapper<>>( std::move( device_serial ) );
+    host_serial = std::make_unique<crosstalk::FecSerialWrapper<>>( std::move( host_serial ) );
+  }
+  crosstalk::SerialAbstraction &device_text = *device_serial;
+  crosstalk::CrossTalker<512, 256> device( std::move( device_serial ) );
+  crosstalk::CrossTalker<512, 256> host( std::move( host_serial ) );
+  const CommStatus status{ 1378,
+                           -98.0f,
+                           -85.0f,
+                           0.0f,
+                           CommQuality::NONE,
+                           CommQuality::MEDIUM_QUALITY,
+                           CommQuality::HIGH_QUALITY,
+                           CommState::DISCONNECTED,
+                           CommState::CONNECTED,
+                           CommState::CONNECTED };
+  const size_t frame_size = 8 + crosstalk::util::compute_size( status );
+  const uint8_t text[] = "SUCCESS";
+
+  GoodputResult result;
+  for ( nanoseconds t{ 0 }; t < simulated_duration; t += loop_period ) {
+    while ( device.sendObject( status ) == crosstalk::WriteResult::Success ) {
+      ++result.frames_sent;
+      device_text.write( text, sizeof( text ) - 1 );
+    }
+    link.advance( loop_period );
+    host.processSerialData();
+    while ( true ) {
+      host.skip();
+      if ( !host.hasObject() )
+        break;
+      CommStatus obj;
+      crosstalk::ReadResult read_result = host.readObject( obj );
+      if ( read_result == crosstalk::ReadResult::NotEnoughData )
+        break;
+      if ( read_result == crosstalk::ReadResult::Success ) {
+        ++result.frames_received;
+        result.bytes_received += frame_size;
+        continue;
+      }
+      ++result.frames_failed;
+      if ( read_result == crosstalk::ReadResult::ObjectIdMismatch &&
+           host.skipObject() == crosstalk::ReadResult::NotEnoughData )
+        break;
+    }
+  }
+  return result;
+}
+
+int main()
+{
+  const nanoseconds simulated = 2s;
+  std::printf( "%10s %10s %10s %4s %10s %10s %10s %12s %8s %10s\n", "baud", "ber", "burst", "fec", "sent",
+               "received", "failed", "goodput B/s", "util %", "wall ms" );
+  for ( uint32_t baud_rate : { 115200U, 2000000U } ) {
+    for ( double ber : { 0.0, 1e-6, 1e-5, 1e-4, 1e-3, 3e-3 } ) {
+      for ( double burst_rate : { 0.0, 1e-4 } ) {
+        for ( bool fec : { false, true } ) {
+          crosstalk::LinkSimulatorConfig config;
+          config.baud_rate = baud_rate;
+          config.bit_error_rate = ber;
+          config.burst_rate = burst_rate;
+          // Let the device loop run at 1 kHz and the buffer cover at least one loop iteration
+          config.tx_buffer_size = std::max<size_t>( 256, baud_rate / 10 / 1000 * 2 );
+          auto start = steady_clock::now();
+          GoodputResult result = runGoodput( config, simulated, 1ms, fec );
+          auto wall = duration_cast<milliseconds>( steady_clock::now() - start ).count();
+          double seconds = duration<double>( simulated ).count();
+          double goodput = result.bytes_received / seconds;
+          double capacity = static_cast<double>( baud_rate ) / config.bits_per_byte;
+          std::printf( "%10u %10.0e %10.0e %4s %10zu %10zu %10zu %12.0f %8.1f %10ld\n", baud_rate, ber,
+                       burst_rate, fec ? "on" : "off", result.frames_sent, result.frames_received,
+                       result.frames_failed, goodput, 100.0 * goodput / capacity, static_cast<long>( wall ) );
+        }
+      }
+    }
+  }
+  return 0;
+}
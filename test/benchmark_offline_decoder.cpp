@@ -0,0 +1,82 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/host/column_store.hpp"
+#include "crosstalk/host/offline_decoder.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std::chrono;
+
+//! Usage: benchmark_offline_decoder [stream size in MB]
+int main( int argc, char **argv )
+{
+  const size_t size = ( argc > 1 ? std::atol( argv[1] ) : 64 ) << 20;
+  std::vector<uint8_t> data;
+  data.reserve( size + 1024 );
+  std::vector<uint8_t> unused;
+  crosstalk::CrossTalker<1024> sender( std::make_unique<TestSerialAbstraction>( data, unused ) );
+  for ( int i = 0; data.size() < size; ++i ) {
+    sender.sendObject( CommStatus{ uint64_t( i ), -90.0f, -80.0f, 0.0f } );
+    sender.sendObject( TestObjectWithString{ i, "Status message " + std::to_string( i ) } );
+    sender.sendObject( TestObjectSimple{ i, 0.5f * i } );
+    if ( i % 16 == 0 ) {
+      const char text[] = "[INFO] Periodic text output of the firmware\n";
+      data.insert( data.end(), text, text + sizeof( text ) - 1 );
+    }
+  }
+  std::printf( "stream: %.1f MB\n", data.size() / 1e6 );
+
+  crosstalk::CaptureStream stream( data.data(), data.size() );
+  std::vector<unsigned> thread_counts = { 1, 2, 4, 8 };
+  if ( std::thread::hardware_concurrency() > 8 )
+    thread_counts.push_back( std::thread::hardware_concurrency() );
+  double single_thread_seconds = 0;
+  for ( unsigned threads : thread_counts ) {
+    crosstalk::OfflineDecoderOptions options;
+    options.threads = threads;
+    crosstalk::OfflineDecoder decoder( options );
+    auto start = steady_clock::now();
+    auto objects = decoder.decode<CommStatus, TestObjectWithString, TestObjectSimple>( stream );
+    double seconds = duration<double>( steady_clock::now() - start ).count();
+    if ( threads == 1 )
+      single_thread_seconds = seconds;
+    std::printf( "%2u threads: %zu objects in %.3f s, %.1f MB/s, speedup %.2f, %llu bytes skipped\n",
+                 threads, objects.size(), seconds, data.size() / seconds / 1e6,
+                 single_thread_seconds / seconds,
+                 static_cast<unsigned long long>( decoder.statistics().skipped_bytes ) );
+  }
+
+  // Per-field arrays of one type: decoding into objects and transposing vs. decoding into columns
+  crosstalk::OfflineDecoder decoder;
+  std::vector<crosstalk::FrameInfo> frames = decoder.findFrames( stream );
+  auto start = steady_clock::now();
+  std::vector<CommStatus> objects;
+  for ( const auto &frame : frames ) {
+    if ( frame.id != crosstalk::object_id<CommStatus>() )
+      continue;
+    crosstalk::util::deserialize( stream.contiguous( frame.offset + 6, frame.payload_size ),
+                                  frame.payload_size, objects.emplace_back() );
+  }
+  crosstalk::ColumnStore<CommStatus>::Columns transposed;
+  for ( const auto &obj : objects ) {
+    std::get<0>( transposed ).push_back( obj.last_received_message_age_ms );
+    std::get<1>( transposed ).push_back( obj.ble_rssi );
+    std::get<2>( transposed ).push_back( obj.radio_rssi );
+    std::get<3>( transposed ).push_back( obj.esp_now_rssi );
+    std::get<4>( transposed ).push_back( obj.ble_quality );
+    std::get<5>( transposed ).push_back( obj.radio_quality );
+    std::get<6>( transposed ).push_back( obj.esp_now_quality );
+    std::get<7>( transposed ).push_back( obj.ble_state );
+    std::get<8>( transposed ).push_back( obj.esp_now_state );
+    std::get<9>( transposed ).push_back( obj.radio_state );
+  }
+  double aos_seconds = duration<double>( steady_clock::now() - start ).count();
+  start = steady_clock::now();
+  auto columns = crosstalk::readObjects<CommStatus>( stream, frames );
+  double soa_seconds = duration<double>( steady_clock::now() - start ).count();
+  std::printf( "CommStatus columns: %zu objects, objects + transpose %.1f ms, column store %.1f ms\n",
+               columns.size(), aos_seconds * 1e3, soa_seconds * 1e3 );
+  return 0;
+}
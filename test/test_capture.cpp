@@ -0,0 +1,298 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/host/capture.hpp"
+#include "crosstalk/host/capture_replay.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include "gtest/gtest.h"
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <iterator>
+
+static std::string tempPath( const std::string &name )
+{
+  return ::testing::TempDir() + "crosstalk_" + name;
+}
+
+static std::vector<uint8_t> readFile( const std::string &path )
+{
+  std::ifstream file( path, std::ios::binary );
+  return { std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() };
+}
+
+//! Concatenates the data of all records in the given direction.
+static std::vector<uint8_t> extractStream( const std::vector<uint8_t> &file,
+                                           crosstalk::CaptureDirection direction )
+{
+  std::vector<uint8_t> result;
+  crosstalk::CaptureFileHeader file_header;
+  EXPECT_TRUE( file_header.decode( file.data(), file.size() ) );
+  size_t offset = crosstalk::CaptureFileHeader::SIZE;
+  crosstalk::CaptureRecordHeader header;
+  while ( header.decode( file.data() + offset, file.size() - offset ) ) {
+    offset += crosstalk::CaptureRecordHeader::SIZE;
+    EXPECT_LE( offset + header.length, file.size() );
+    if ( header.direction == direction )
+      result.insert( result.end(), file.begin() + offset, file.begin() + offset + header.length );
+    offset += header.length;
+  }
+  EXPECT_EQ( offset, file.size() );
+  return result;
+}
+
+TEST( CaptureTest, teeSerial )
+{
+  const std::string path = tempPath( "tee.ctcap" );
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device(
+      std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CaptureWriter writer( path );
+  ASSERT_TRUE( writer.isOpen() );
+  crosstalk::CrossTalker<256> host( std::make_unique<crosstalk::CaptureSerialWrapper>(
+      std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ), writer, true ) );
+
+  std::vector<uint8_t> sent_to_host;
+  for ( int i = 0; i < 100; ++i ) {
+    ASSERT_EQ( device.sendObject( TestObjectWithString{ i, "Capture" } ),
+               crosstalk::WriteResult::Success );
+    host_buffer.insert( host_buffer.end(), { 'L', 'O', 'G' } );
+    sent_to_host.insert( sent_to_host.end(), host_buffer.begin(), host_buffer.end() );
+    host.processSerialData();
+    host.skip();
+    TestObjectWithString obj;
+    ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+    host.skip();
+  }
+  std::vector<uint8_t> sent_to_device;
+  ASSERT_EQ( host.sendObject( TestObjectSimple{ 1, 2.0f } ), crosstalk::WriteResult::Success );
+  sent_to_device = device_buffer;
+  writer.flush();
+  EXPECT_EQ( writer.droppedBytes(), 0 );
+
+  std::vector<uint8_t> file = readFile( path );
+  EXPECT_EQ( writer.writtenBytes(), file.size() );
+  EXPECT_EQ( extractStream( file, crosstalk::CaptureDirection::Read ), sent_to_host );
+  EXPECT_EQ( extractStream( file, crosstalk::CaptureDirection::Write ), sent_to_device );
+}
+
+//! In-memory packet transport with a maximum packet size of 64 bytes.
+class TestPacketTransport : public crosstalk::SerialAbstraction
+{
+public:
+  TestPacketTransport( std::deque<std::vector<uint8_t>> &in, std::deque<std::vector<uint8_t>> &out )
+      : in_( in ), out_( out )
+  {
+  }
+
+  int available() const override { return in_.empty() ? 0 : static_cast<int>( in_.front().size() ); }
+
+  int read( uint8_t *data, size_t length ) override { return receivePacket( data, length ); }
+
+  bool write( const uint8_t *data, size_t length ) override { return sendPacket( data, length ); }
+
+  bool isPacketTransport() const override { return true; }
+
+  size_t maxPacketSize() const override { return 64; }
+
+  bool sendPacket( const uint8_t *data, size_t length ) override
+  {
+    out_.emplace_back( data, data + length );
+    return true;
+  }
+
+  int receivePacket( uint8_t *data, size_t length ) override
+  {
+    if ( in_.empty() )
+      return 0;
+    std::vector<uint8_t> packet = std::move( in_.front() );
+    in_.pop_front();
+    if ( packet.size() > length )
+      return -1;
+    std::memcpy( data, packet.data(), packet.size() );
+    return static_cast<int>( packet.size() );
+  }
+
+private:
+  std::deque<std::vector<uint8_t>> &in_;
+  std::deque<std::vector<uint8_t>> &out_;
+};
+
+TEST( CaptureTest, packetTransport )
+{
+  const std::string path = tempPath( "packets.ctcap" );
+  std::deque<std::vector<uint8_t>> to_device, to_host;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestPacketTransport>( to_device, to_host ) );
+  crosstalk::CaptureWriter writer( path );
+  ASSERT_TRUE( writer.isOpen() );
+  crosstalk::CrossTalker<256> host( std::make_unique<crosstalk::CaptureSerialWrapper>(
+      std::make_unique<TestPacketTransport>( to_host, to_device ), writer, true ) );
+  // The same frames sent over a stream transport for reference
+  std::vector<uint8_t> stream_to_host, stream_to_device, unused;
+  crosstalk::CrossTalker<256> device_reference(
+      std::make_unique<TestSerialAbstraction>( stream_to_host, unused ) );
+  crosstalk::CrossTalker<256> host_reference(
+      std::make_unique<TestSerialAbstraction>( stream_to_device, unused ) );
+
+  // Several frames per packet
+  device.setPacketBatching( true );
+  for ( int i = 0; i < 10; ++i ) {
+    device.sendObject( TestObjectSimple{ i, 1.0f } );
+    device_reference.sendObject( TestObjectSimple{ i, 1.0f } );
+  }
+  device.sendObject( TestObjectWithString{ 10, "Capture" } );
+  device_reference.sendObject( TestObjectWithString{ 10, "Capture" } );
+  ASSERT_TRUE( device.flushPackets() );
+  EXPECT_LT( to_host.size(), 11 );
+  host.processSerialData();
+  int received = 0;
+  TestObjectSimple simple;
+  while ( host.readObject( simple ) == crosstalk::ReadResult::Success ) ++received;
+  TestObjectWithString with_string;
+  ASSERT_EQ( host.readObject( with_string ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( received, 10 );
+  ASSERT_EQ( host.sendObject( TestObjectSimple{ 1, 2.0f } ), crosstalk::WriteResult::Success );
+  host_reference.sendObject( TestObjectSimple{ 1, 2.0f } );
+  writer.flush();
+
+  std::vector<uint8_t> file = readFile( path );
+  EXPECT_EQ( extractStream( file, crosstalk::CaptureDirection::Read ), stream_to_host );
+  EXPECT_EQ( extractStream( file, crosstalk::CaptureDirection::Write ), stream_to_device );
+}
+
+TEST( CaptureTest, ringFiles )
+{
+  const std::string path = tempPath( "ring.ctcap" );
+  crosstalk::CaptureOptions options;
+  options.max_file_size = 256;
+  options.max_files = 3;
+  options.coalesce_window = std::chrono::nanoseconds( 0 );
+  crosstalk::CaptureWriter writer( path, options );
+  ASSERT_TRUE( writer.isOpen() );
+  std::vector<uint8_t> chunk( 40 );
+  for ( uint8_t i = 0; i < 50; ++i ) {
+    std::fill( chunk.begin(), chunk.end(), i );
+    writer.append( crosstalk::CaptureDirection::Read, chunk.data(), chunk.size() );
+    if ( i % 10 == 0 )
+      writer.flush();
+  }
+  writer.flush();
+
+  // 50 records of 56 bytes with 4 records per file need 13 files, only the last 3 are kept.
+  uint32_t newest_sequence = 0;
+  std::vector<uint8_t> last_stream;
+  for ( uint32_t i = 0; i < options.max_files; ++i ) {
+    std::vector<uint8_t> file = readFile( path + "." + std::to_string( i ) );
+    ASSERT_LE( file.size(), options.max_file_size );
+    crosstalk::CaptureFileHeader header;
+    ASSERT_TRUE( header.decode( file.data(), file.size() ) );
+    EXPECT_EQ( header.sequence % options.max_files, i );
+    EXPECT_GE( header.sequence, 10 );
+    if ( header.sequence >= newest_sequence ) {
+      newest_sequence = header.sequence;
+      last_stream = extractStream( file, crosstalk::CaptureDirection::Read );
+    }
+  }
+  EXPECT_EQ( newest_sequence, 12 );
+  ASSERT_EQ( last_stream.size(), 2 * chunk.size() );
+  EXPECT_EQ( last_stream.back(), 49 );
+}
+
+TEST( CaptureTest, dropsInsteadOfBlocking )
+{
+  crosstalk::CaptureOptions options;
+  options.buffer_size = 64;
+  crosstalk::CaptureWriter writer( tempPath( "drop.ctcap" ), options );
+  std::vector<uint8_t> chunk( 100, 0xAB );
+  writer.append( crosstalk::CaptureDirection::Read, chunk.data(), chunk.size() );
+  EXPECT_EQ( writer.droppedBytes(), 100 );
+}
+
+//! Writes a capture with the given records directly, without the timing of the CaptureWriter.
+static void writeCapture( const std::string &path, const std::vector<crosstalk::CaptureRecord> &records )
+{
+  std::ofstream file( path, std::ios::binary );
+  uint8_t header[crosstalk::CaptureFileHeader::SIZE];
+  crosstalk::CaptureFileHeader{}.encode( header );
+  file.write( reinterpret_cast<const char *>( header ), sizeof( header ) );
+  for ( const auto &record : records ) {
+    uint8_t record_header[crosstalk::CaptureRecordHeader::SIZE];
+    crosstalk::CaptureRecordHeader{ record.timestamp_ns, record.length, record.direction }.encode(
+        record_header );
+    file.write( reinterpret_cast<const char *>( record_header ), sizeof( record_header ) );
+    file.write( reinterpret_cast<const char *>( record.data ), record.length );
+  }
+}
+
+TEST( CaptureTest, replay )
+{
+  const std::string path = tempPath( "replay.ctcap" );
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device(
+      std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  {
+    crosstalk::CaptureWriter writer( path );
+    crosstalk::CrossTalker<256> host( std::make_unique<crosstalk::CaptureSerialWrapper>(
+        std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ), writer ) );
+    for ( int i = 0; i < 1000; ++i ) {
+      ASSERT_EQ( device.sendObject( TestObjectWithString{ i, "Replay" } ),
+                 crosstalk::WriteResult::Success );
+      host.processSerialData();
+    }
+  }
+
+  crosstalk::CaptureFile file( path );
+  ASSERT_TRUE( file.isOpen() );
+  auto serial = std::make_unique<crosstalk::ReplaySerialWrapper>( file );
+  crosstalk::ReplaySerialWrapper &replay = *serial;
+  crosstalk::CrossTalker<256> host( std::move( serial ) );
+  int received = 0;
+  while ( !replay.finished() || host.hasObject() ) {
+    host.processSerialData( false );
+    TestObjectWithString obj;
+    ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+    ASSERT_EQ( obj.uuid, received );
+    ++received;
+  }
+  EXPECT_EQ( received, 1000 );
+  EXPECT_EQ( replay.replayedBytes(), 1000 * ( 8 + 4 + 2 + 6 ) );
+}
+
+TEST( CaptureTest, timedReplay )
+{
+  using namespace std::chrono_literals;
+  const std::string path = tempPath( "timed.ctcap" );
+  const uint8_t first[] = { 'A', 'B' };
+  const uint8_t sent[] = { 'X' };
+  const uint8_t second[] = { 'C' };
+  writeCapture( path, { { 1000000000, crosstalk::CaptureDirection::Read, first, 2 },
+                        { 1010000000, crosstalk::CaptureDirection::Write, sent, 1 },
+                        { 1050000000, crosstalk::CaptureDirection::Read, second, 1 } } );
+  crosstalk::CaptureFile file( path );
+  ASSERT_TRUE( file.isOpen() );
+  crosstalk::ReplaySerialWrapper replay( file, crosstalk::ReplayMode::Timed );
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ( replay.available(), 2 );
+  uint8_t data[4];
+  ASSERT_EQ( replay.read( data, sizeof( data ) ), 2 );
+  EXPECT_EQ( data[1], 'B' );
+  EXPECT_EQ( replay.available(), 0 );
+  while ( replay.available() == 0 && std::chrono::steady_clock::now() - start < 1s )
+    std::this_thread::sleep_for( 1ms );
+  EXPECT_GE( std::chrono::steady_clock::now() - start, 50ms );
+  ASSERT_EQ( replay.read( data, sizeof( data ) ), 1 );
+  EXPECT_EQ( data[0], 'C' );
+  EXPECT_TRUE( replay.finished() );
+
+  crosstalk::ReplaySerialWrapper writes( file, crosstalk::ReplayMode::MaxSpeed, 1.0,
+                                         crosstalk::CaptureDirection::Write );
+  ASSERT_EQ( writes.read( data, sizeof( data ) ), 1 );
+  EXPECT_EQ( data[0], 'X' );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
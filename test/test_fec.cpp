@@ -0,0 +1,153 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_fec_serial_wrapper.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_link_simulator.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include "gtest/gtest.h"
+#include <numeric>
+#include <random>
+
+using namespace std::chrono_literals;
+using Side = crosstalk::LinkSimulator::Side;
+
+TEST( FecTest, reedSolomon )
+{
+  using RS = crosstalk::detail::ReedSolomon<8>;
+  std::mt19937 rng( 1 );
+  int failed_uncorrectable = 0;
+  int uncorrectable = 0;
+  for ( int iteration = 0; iteration < 2000; ++iteration ) {
+    const size_t size = 1 + iteration % 40;
+    std::vector<uint8_t> codeword( size + 8 );
+    for ( size_t i = 0; i < size; ++i ) codeword[i] = static_cast<uint8_t>( rng() );
+    RS::encode( codeword.data(), size, codeword.data() + size );
+    ASSERT_EQ( RS::decode( codeword.data(), codeword.size() ), 0 );
+    const std::vector<uint8_t> original = codeword;
+    // Corrupt up to eight distinct bytes, at most four can be corrected
+    const int errors = std::min<int>( 1 + iteration % 8, codeword.size() );
+    std::vector<size_t> positions( codeword.size() );
+    std::iota( positions.begin(), positions.end(), 0 );
+    std::shuffle( positions.begin(), positions.end(), rng );
+    for ( int e = 0; e < errors; ++e ) codeword[positions[e]] ^= static_cast<uint8_t>( 1 + rng() % 255 );
+    const std::vector<uint8_t> corrupted = codeword;
+    const int corrected = RS::decode( codeword.data(), codeword.size() );
+    if ( errors <= 4 ) {
+      ASSERT_EQ( corrected, errors );
+      ASSERT_EQ( codeword, original );
+      continue;
+    }
+    ++uncorrectable;
+    if ( corrected < 0 ) {
+      ++failed_uncorrectable;
+      EXPECT_EQ( codeword, corrupted );
+    }
+  }
+  // Too many errors are almost always detected instead of being miscorrected
+  EXPECT_GT( failed_uncorrectable, uncorrectable * 95 / 100 );
+}
+
+TEST( FecTest, hamming )
+{
+  for ( uint8_t nibble = 0; nibble < 16; ++nibble ) {
+    const uint8_t code = crosstalk::detail::hammingEncode( nibble );
+    EXPECT_EQ( crosstalk::detail::hammingDecode( code ), nibble );
+    for ( int bit = 0; bit < 8; ++bit ) {
+      EXPECT_EQ( crosstalk::detail::hammingDecode( code ^ ( 1 << bit ) ), nibble );
+      for ( int other = bit + 1; other < 8; ++other )
+        EXPECT_EQ( crosstalk::detail::hammingDecode( code ^ ( 1 << bit ) ^ ( 1 << other ) ), -1 );
+    }
+  }
+}
+
+TEST( FecTest, wrapper )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  using Fec = crosstalk::FecSerialWrapper<16, 4, 64>;
+  Fec device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  auto host_fec = std::make_unique<Fec>( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  Fec &host = *host_fec;
+  crosstalk::CrossTalker<256> host_crosstalker( std::move( host_fec ) );
+
+  std::vector<uint8_t> data( 100 );
+  for ( size_t i = 0; i < data.size(); ++i ) data[i] = static_cast<uint8_t>( i * 7 );
+  ASSERT_TRUE( device.write( data.data(), data.size() ) );
+  EXPECT_EQ( host_buffer.size(), Fec::encodedSize( 64 ) + Fec::encodedSize( 36 ) );
+  EXPECT_EQ( host_buffer.size(), 100 + 7 * ( Fec::HEADER_SIZE + 4 ) );
+  // Two corrupted bytes per block are corrected, including the sync byte and the length
+  for ( size_t offset = 0; offset < host_buffer.size(); offset += Fec::HEADER_SIZE + 16 + 4 ) {
+    host_buffer[offset] ^= 0x01;
+    host_buffer[offset + 2] ^= 0x10;
+    if ( offset + 10 < host_buffer.size() )
+      host_buffer[offset + 10] ^= 0xFF;
+  }
+  // Garbage in front of the first block is skipped
+  host_buffer.insert( host_buffer.begin(), { Fec::SYNC_BYTE, 0x00, 0xFF, 0x42 } );
+  std::vector<uint8_t> received( 200 );
+  ASSERT_EQ( host.available(), 16 );
+  ASSERT_EQ( host.read( received.data(), 10 ), 10 );
+  ASSERT_EQ( host.read( received.data() + 10, received.size() - 10 ), 90 );
+  received.resize( 100 );
+  EXPECT_EQ( received, data );
+  EXPECT_EQ( host.statistics().decoded_blocks, 7 );
+  EXPECT_EQ( host.statistics().corrected_blocks, 7 );
+  EXPECT_EQ( host.statistics().skipped_bytes, 4 );
+  EXPECT_EQ( host.statistics().failed_blocks, 0 );
+
+  // A block with too many errors is dropped and the next block is found again
+  auto device_fec = std::make_unique<Fec>( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> sender( std::move( device_fec ) );
+  host_buffer.clear();
+  sender.sendObject( TestObjectWithString{ 1, "first object that spans several blocks" } );
+  for ( int i = 5; i < 10; ++i ) host_buffer[i] ^= 0x5A;
+  sender.sendObject( TestObjectSimple{ 2, 2.5f } );
+  host_crosstalker.processSerialData();
+  TestObjectSimple obj;
+  ASSERT_EQ( host_crosstalker.extractObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 2 );
+  EXPECT_EQ( host.statistics().failed_blocks, 1 );
+  EXPECT_EQ( host.available(), 0 );
+}
+
+TEST( FecTest, noisyLink )
+{
+  for ( bool fec : { false, true } ) {
+    crosstalk::LinkSimulatorConfig config;
+    config.baud_rate = 2000000;
+    config.bit_error_rate = 1e-3;
+    crosstalk::LinkSimulator link( config );
+    std::unique_ptr<crosstalk::SerialAbstraction> device_serial = link.createEndpoint( Side::A );
+    std::unique_ptr<crosstalk::SerialAbstraction> host_serial = link.createEndpoint( Side::B );
+    if ( fec ) {
+      device_serial = std::make_unique<crosstalk::FecSerialWrapper<>>( std::move( device_serial ) );
+      host_serial = std::make_unique<crosstalk::FecSerialWrapper<>>( std::move( host_serial ) );
+    }
+    crosstalk::CrossTalker<256> device( std::move( device_serial ) );
+    crosstalk::CrossTalker<256> host( std::move( host_serial ) );
+    int sent = 0;
+    int received = 0;
+    for ( int i = 0; i < 5000; ++i ) {
+      if ( device.sendObject( TestObjectSimple{ i, 3.14f } ) == crosstalk::WriteResult::Success )
+        ++sent;
+      link.advance( 200us );
+      host.processSerialData();
+      TestObjectSimple obj;
+      while ( host.extractObject( obj ) == crosstalk::ReadResult::Success ) ++received;
+      host.skip();
+    }
+    EXPECT_GT( sent, 4000 );
+    if ( fec ) {
+      // About 1.2 bit errors per block of 33 bytes on the wire, all are corrected
+      EXPECT_GE( received, sent - 2 );
+    } else {
+      // About 12 % of the 16 byte frames are hit by a bit error
+      EXPECT_LT( received, sent * 95 / 100 );
+    }
+  }
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
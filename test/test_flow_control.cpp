@@ -0,0 +1,198 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/flow_control.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include "gtest/gtest.h"
+
+static constexpr int16_t CREDIT_ID = static_cast<int16_t>( crosstalk::InternalObjectId::Credit );
+
+template<typename CrossTalker, typename FlowControl>
+void readCredits( CrossTalker &crosstalker, FlowControl &flow_control )
+{
+  crosstalker.processSerialData();
+  while ( crosstalker.hasObject() ) {
+    ASSERT_EQ( crosstalker.getObjectId(), CREDIT_ID );
+    ASSERT_EQ( flow_control.readCredit( crosstalker ), crosstalk::ReadResult::Success );
+  }
+}
+
+TEST( FlowControlTest, backpressure )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<1024> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<128> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  crosstalk::FlowControl<1024, CommStatus> flow_control;
+  crosstalk::CreditReporter reporter;
+  std::vector<int> ids;
+  uint64_t last_status = 0;
+  int statuses = 0;
+  auto receive = [&]() {
+    host.processSerialData();
+    while ( host.hasObject() ) {
+      if ( host.getObjectId() == crosstalk::object_id<CommStatus>() ) {
+        CommStatus status;
+        ASSERT_EQ( host.readObject( status ), crosstalk::ReadResult::Success );
+        EXPECT_GT( status.last_received_message_age_ms, last_status );
+        last_status = status.last_received_message_age_ms;
+        ++statuses;
+        continue;
+      }
+      TestObjectSimple simple;
+      ASSERT_EQ( host.readObject( simple ), crosstalk::ReadResult::Success );
+      ids.push_back( simple.id );
+    }
+    ASSERT_EQ( reporter.report( host ), crosstalk::WriteResult::Success );
+  };
+  // Without credit everything is held
+  EXPECT_EQ( flow_control.send( device, TestObjectSimple{ 0, 0.0f } ), crosstalk::WriteResult::Success );
+  EXPECT_TRUE( host_buffer.empty() );
+  EXPECT_EQ( flow_control.heldFrames(), 1 );
+  // The device produces more than the host can buffer in each iteration
+  for ( int i = 1; i <= 100; ++i ) {
+    if ( i < 100 )
+      flow_control.send( device, TestObjectSimple{ i, 0.0f } );
+    if ( i % 5 == 0 )
+      flow_control.send( device, CommStatus{ uint64_t( i ), 0.0f, 0.0f, 0.0f } );
+    if ( i % 8 == 0 ) {
+      receive();
+      readCredits( device, flow_control );
+      EXPECT_LE( static_cast<int>( host_buffer.size() ), 128 );
+    }
+  }
+  while ( flow_control.heldFrames() > 0 ) {
+    receive();
+    readCredits( device, flow_control );
+  }
+  receive();
+  std::vector<int> expected( 100 );
+  for ( int i = 0; i < 100; ++i ) expected[i] = i;
+  EXPECT_EQ( ids, expected );
+  // Older statuses were replaced by newer ones while held
+  EXPECT_EQ( last_status, 100 );
+  EXPECT_LT( statuses, 20 );
+  EXPECT_EQ( flow_control.statistics().conflated_frames, 20 - statuses );
+  EXPECT_EQ( flow_control.statistics().rejected_frames, 0 );
+  EXPECT_EQ( host.statistics().dropped_bytes, 0 );
+  EXPECT_EQ( host.statistics().dropped_frames, 0 );
+}
+
+TEST( FlowControlTest, frameWindow )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  // Each held TestObjectSimple takes 12 bytes
+  crosstalk::FlowControl<64> flow_control;
+  crosstalk::CreditReporter reporter( 2 );
+  for ( int i = 0; i < 5; ++i )
+    EXPECT_EQ( flow_control.send( device, TestObjectSimple{ i, 0.0f } ), crosstalk::WriteResult::Success );
+  EXPECT_EQ( flow_control.send( device, TestObjectSimple{ 5, 0.0f } ), crosstalk::WriteResult::NoCredit );
+  EXPECT_EQ( flow_control.statistics().rejected_frames, 1 );
+  EXPECT_EQ( flow_control.heldBytes(), 60 );
+
+  int next_id = 0;
+  for ( int round = 0; round < 3; ++round ) {
+    reporter.report( host );
+    readCredits( device, flow_control );
+    host.processSerialData();
+    int count = 0;
+    TestObjectSimple simple;
+    while ( host.readObject( simple ) == crosstalk::ReadResult::Success ) {
+      EXPECT_EQ( simple.id, next_id++ );
+      ++count;
+    }
+    EXPECT_EQ( count, round < 2 ? 2 : 1 );
+    // Nothing more is sent until the frames are consumed
+    reporter.report( host );
+    readCredits( device, flow_control );
+    EXPECT_TRUE( host_buffer.empty() );
+    reporter.consumed( count );
+  }
+  EXPECT_EQ( flow_control.heldFrames(), 0 );
+}
+
+TEST( FlowControlTest, lostData )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<128> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  crosstalk::FlowControl<256> flow_control;
+  crosstalk::CreditReporter reporter;
+  reporter.report( host );
+  readCredits( device, flow_control );
+  EXPECT_EQ( flow_control.credit(), 128 );
+  for ( int i = 0; i < 10; ++i ) flow_control.send( device, TestObjectSimple{ i, 0.0f } );
+  EXPECT_EQ( flow_control.credit(), 0 );
+  EXPECT_EQ( flow_control.heldFrames(), 2 );
+  host_buffer.clear(); // Lost on the link
+
+  // Two idle reports without progress in between write off what was sent before the first
+  reporter.report( host );
+  readCredits( device, flow_control );
+  EXPECT_EQ( flow_control.heldFrames(), 2 );
+  reporter.report( host );
+  readCredits( device, flow_control );
+  EXPECT_EQ( flow_control.statistics().lost_bytes, 128 );
+  EXPECT_EQ( flow_control.heldFrames(), 0 );
+  host.processSerialData();
+  TestObjectSimple simple;
+  ASSERT_EQ( host.readObject( simple ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( simple.id, 8 );
+
+  // A restarted sender starts counting from zero again
+  crosstalk::FlowControl<256> restarted;
+  ASSERT_EQ( host.readObject( simple ), crosstalk::ReadResult::Success );
+  reporter.report( host );
+  readCredits( device, restarted );
+  EXPECT_EQ( restarted.credit(), 128 );
+}
+
+TEST( FlowControlTest, sequenceNumbers )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<1024> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<128> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  device.setSequenceNumbers( crosstalk::SequenceNumbers::TwoBytes );
+  EXPECT_EQ( device.frameSize( crosstalk::object_id<TestObjectSimple>(), 8 ), 18 );
+  EXPECT_EQ( device.frameSize( CREDIT_ID, crosstalk::CreditReport::SIZE ), 23 );
+  // The host buffer is empty, so 7 frames of 18 bytes can be sent right away
+  crosstalk::FlowControl<1024> flow_control( 128 );
+  crosstalk::CreditReporter reporter;
+  for ( int i = 0; i < 10; ++i ) flow_control.send( device, TestObjectSimple{ i, 0.0f } );
+  EXPECT_EQ( host_buffer.size(), 7 * 18 );
+  EXPECT_EQ( flow_control.credit(), 2 );
+  EXPECT_EQ( flow_control.heldFrames(), 3 );
+
+  // The device produces faster than the host reads and sends between the report and reading it
+  std::vector<int> ids;
+  int next = 10;
+  for ( int i = 0; i < 60 || flow_control.heldFrames() > 0; ++i ) {
+    ASSERT_LE( static_cast<int>( host_buffer.size() ), host.freeSpace() );
+    host.processSerialData();
+    TestObjectSimple simple;
+    for ( int k = 0; k < 2 && host.readObject( simple ) == crosstalk::ReadResult::Success; ++k )
+      ids.push_back( simple.id );
+    ASSERT_EQ( reporter.report( host ), crosstalk::WriteResult::Success );
+    for ( int k = 0; k < 3 && i < 60; ++k ) flow_control.send( device, TestObjectSimple{ next++, 0.0f } );
+    readCredits( device, flow_control );
+    ASSERT_LT( i, 1000 );
+  }
+  TestObjectSimple simple;
+  host.processSerialData();
+  while ( host.readObject( simple ) == crosstalk::ReadResult::Success ) ids.push_back( simple.id );
+  ASSERT_EQ( static_cast<int>( ids.size() ), next );
+  for ( int i = 0; i < next; ++i ) EXPECT_EQ( ids[i], i );
+  EXPECT_EQ( host.statistics().dropped_bytes, 0 );
+  EXPECT_EQ( host.statistics().dropped_frames, 0 );
+  EXPECT_EQ( host.statistics().lost_frames, 0 );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/host/latest_value_cache.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include "gtest/gtest.h"
+#include <thread>
+
+TEST( LatestValueCacheTest, receivePath )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  crosstalk::LatestValueCache<CommStatus, TestObjectSimple> cache;
+  static_assert( decltype( cache )::contains( crosstalk::object_id<CommStatus>() ) );
+  static_assert( !decltype( cache )::contains( crosstalk::object_id<TestObjectWithString>() ) );
+
+  CommStatus status;
+  uint64_t version = 42;
+  EXPECT_FALSE( cache.load( status, &version ) );
+  EXPECT_EQ( version, 0 );
+
+  for ( int i = 1; i <= 3; ++i ) device.sendObject( CommStatus{ uint64_t( i ), -1.0f * i, 0.0f, 0.0f } );
+  device.sendObject( TestObjectWithString{ 1, "not cached" } );
+  device.sendObject( TestObjectSimple{ 7, 0.5f } );
+  host.processSerialData();
+  int mismatches = 0;
+  while ( host.hasObject() ) {
+    crosstalk::ReadResult result = cache.read( host );
+    if ( result == crosstalk::ReadResult::ObjectIdMismatch ) {
+      ++mismatches;
+      host.skipObject();
+      continue;
+    }
+    ASSERT_EQ( result, crosstalk::ReadResult::Success );
+  }
+  EXPECT_EQ( mismatches, 1 );
+  ASSERT_TRUE( cache.load( status, &version ) );
+  EXPECT_EQ( status.last_received_message_age_ms, 3 );
+  EXPECT_EQ( status.ble_rssi, -3.0f );
+  EXPECT_EQ( version, 3 );
+  EXPECT_EQ( cache.version<TestObjectSimple>(), 1 );
+  TestObjectSimple simple;
+  ASSERT_TRUE( cache.load( simple ) );
+  EXPECT_EQ( simple.id, 7 );
+}
+
+TEST( LatestValueCacheTest, concurrentReaders )
+{
+  crosstalk::LatestValue<CommStatus> value;
+  constexpr uint64_t COUNT = 200000;
+  std::atomic<bool> done{ false };
+  std::atomic<int> torn_reads{ 0 };
+  auto reader = [&]() {
+    uint64_t last_version = 0;
+    CommStatus status;
+    while ( !done.load() ) {
+      uint64_t version = 0;
+      if ( !value.load( status, &version ) )
+        continue;
+      // All fields are written from the same counter, a torn read would mix two values
+      const float expected = static_cast<float>( status.last_received_message_age_ms % 1000 );
+      if ( status.ble_rssi != expected || status.radio_rssi != expected || status.esp_now_rssi != expected )
+        ++torn_reads;
+      EXPECT_GE( version, last_version );
+      EXPECT_EQ( version, status.last_received_message_age_ms );
+      last_version = version;
+    }
+  };
+  std::thread first( reader );
+  std::thread second( reader );
+  for ( uint64_t i = 1; i <= COUNT; ++i ) {
+    const float v = static_cast<float>( i % 1000 );
+    value.store( CommStatus{ i, v, v, v } );
+  }
+  done = true;
+  first.join();
+  second.join();
+  EXPECT_EQ( torn_reads.load(), 0 );
+  EXPECT_EQ( value.version(), COUNT );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
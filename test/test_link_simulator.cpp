@@ -0,0 +1,124 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_link_simulator.hpp"
+#include "test_objects.hpp"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+using Side = crosstalk::LinkSimulator::Side;
+
+TEST( LinkSimulatorTest, pacing )
+{
+  crosstalk::LinkSimulatorConfig config;
+  config.baud_rate = 115200;
+  config.tx_buffer_size = 16;
+  config.latency = 1ms;
+  crosstalk::LinkSimulator link( config );
+  auto device = link.createEndpoint( Side::A );
+  auto host = link.createEndpoint( Side::B );
+  const auto byte_time = link.byteTime();
+  EXPECT_EQ( byte_time, 86805ns );
+
+  const uint8_t data[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  EXPECT_EQ( device->availableForWrite(), 16 );
+  ASSERT_TRUE( device->write( data, sizeof( data ) ) );
+  EXPECT_EQ( device->availableForWrite(), 6 );
+  EXPECT_FALSE( device->write( data, sizeof( data ) ) );
+  EXPECT_EQ( link.counters().writes_rejected, 1 );
+
+  link.advance( 4 * byte_time );
+  EXPECT_EQ( device->availableForWrite(), 10 );
+  EXPECT_EQ( host->available(), 0 ); // Still in flight
+  link.advance( 1ms );
+  EXPECT_EQ( host->available(), 4 );
+  link.advance( 6 * byte_time );
+  ASSERT_EQ( host->available(), 10 );
+  uint8_t received[10];
+  ASSERT_EQ( host->read( received, sizeof( received ) ), 10 );
+  EXPECT_EQ( std::memcmp( data, received, sizeof( data ) ), 0 );
+  EXPECT_EQ( host->available(), 0 );
+  EXPECT_EQ( device->available(), 0 );
+
+  // Other direction is independent
+  ASSERT_TRUE( host->write( data, 1 ) );
+  link.advance( byte_time + 1ms );
+  EXPECT_EQ( device->available(), 1 );
+}
+
+TEST( LinkSimulatorTest, errorInjection )
+{
+  crosstalk::LinkSimulatorConfig config;
+  config.tx_buffer_size = 1024;
+  config.byte_drop_rate = 1.0;
+  crosstalk::LinkSimulator dropping_link( config );
+  auto sender = dropping_link.createEndpoint( Side::A );
+  std::vector<uint8_t> data( 1000, 0x55 );
+  ASSERT_TRUE( sender->write( data.data(), data.size() ) );
+  dropping_link.advance( 1s );
+  EXPECT_EQ( dropping_link.createEndpoint( Side::B )->available(), 0 );
+  EXPECT_EQ( dropping_link.counters().bytes_dropped, 1000 );
+
+  config.byte_drop_rate = 0;
+  config.bit_error_rate = 1e-2;
+  crosstalk::LinkSimulator noisy_link( config );
+  sender = noisy_link.createEndpoint( Side::A );
+  auto receiver = noisy_link.createEndpoint( Side::B );
+  ASSERT_TRUE( sender->write( data.data(), data.size() ) );
+  noisy_link.advance( 1s );
+  ASSERT_EQ( receiver->available(), 1000 );
+  std::vector<uint8_t> received( 1000 );
+  receiver->read( received.data(), received.size() );
+  size_t flipped_bits = 0;
+  for ( size_t i = 0; i < data.size(); ++i ) {
+    flipped_bits += __builtin_popcount( data[i] ^ received[i] );
+  }
+  EXPECT_EQ( flipped_bits, noisy_link.counters().bits_flipped );
+  EXPECT_GT( flipped_bits, 40 );
+  EXPECT_LT( flipped_bits, 120 );
+}
+
+TEST( LinkSimulatorTest, crosstalkerResync )
+{
+  crosstalk::LinkSimulatorConfig config;
+  config.baud_rate = 2000000;
+  config.burst_rate = 1e-3;
+  crosstalk::LinkSimulator link( config );
+  crosstalk::CrossTalker<256> device( link.createEndpoint( Side::A ) );
+  crosstalk::CrossTalker<256> host( link.createEndpoint( Side::B ) );
+
+  int sent = 0;
+  int received = 0;
+  int errors = 0;
+  for ( int i = 0; i < 10000; ++i ) {
+    if ( device.sendObject( TestObjectSimple{ i, 3.14f } ) == crosstalk::WriteResult::Success )
+      ++sent;
+    link.advance( 50us );
+    host.processSerialData();
+    host.skip();
+    while ( host.hasObject() ) {
+      TestObjectSimple obj = {};
+      auto result = host.readObject( obj );
+      if ( result == crosstalk::ReadResult::NotEnoughData )
+        break;
+      if ( result == crosstalk::ReadResult::Success )
+        ++received;
+      else
+        ++errors;
+      // Corrupted id
+      if ( result == crosstalk::ReadResult::ObjectIdMismatch &&
+           host.skipObject() == crosstalk::ReadResult::NotEnoughData )
+        break;
+      host.skip();
+    }
+  }
+  EXPECT_GT( sent, 1000 );
+  EXPECT_GT( errors, 0 );
+  // Every frame hit by a burst is lost but the receiver never stalls
+  EXPECT_GT( received, sent * 8 / 10 );
+  EXPECT_LE( received, sent );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
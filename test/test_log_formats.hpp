@@ -0,0 +1,20 @@
+//
+// Log formats used by the host tests. The test firmware does not send log messages.
+//
+
+#ifndef SERIALLIBRARY_TEST_LOG_FORMATS_HPP
+#define SERIALLIBRARY_TEST_LOG_FORMATS_HPP
+
+struct LogTestStarted : crosstalk::LogFormat<1> {
+  static constexpr const char *FORMAT = "Test started!";
+};
+
+struct LogObjectResult : crosstalk::LogFormat<2, const char *, bool> {
+  static constexpr const char *FORMAT = "{}: {}";
+};
+
+struct LogSensorReading : crosstalk::LogFormat<3, uint8_t, float, int32_t, CommState> {
+  static constexpr const char *FORMAT = "Sensor {} read {} V after {} us in state {}";
+};
+
+#endif // SERIALLIBRARY_TEST_LOG_FORMATS_HPP
@@ -0,0 +1,225 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/host/message_bus.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+// Counts heap allocations to verify that pooled reads do not allocate once warmed up
+static std::atomic<size_t> allocations{ 0 };
+
+[[gnu::noinline]] void *operator new( size_t size )
+{
+  ++allocations;
+  if ( void *ptr = std::malloc( size ) )
+    return ptr;
+  throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete( void *ptr ) noexcept { std::free( ptr ); }
+
+[[gnu::noinline]] void operator delete( void *ptr, size_t ) noexcept { std::free( ptr ); }
+
+TEST( ObjectPoolTest, recycling )
+{
+  auto *pool = new crosstalk::ObjectPool<TestObjectWithString>();
+  pool->reserve( 2 );
+  EXPECT_EQ( pool->freeCount(), 2 );
+  crosstalk::PooledPtr<TestObjectWithString> first = pool->acquire();
+  first->name = "a long enough string to not fit into the small string buffer";
+  const char *data = first->name.data();
+  crosstalk::PooledPtr<const TestObjectWithString> shared = first;
+  EXPECT_EQ( first.useCount(), 2 );
+  EXPECT_EQ( pool->inUseCount(), 1 );
+  first.reset();
+  EXPECT_EQ( pool->freeCount(), 1 );
+  shared.reset();
+  EXPECT_EQ( pool->freeCount(), 2 );
+  EXPECT_EQ( pool->inUseCount(), 0 );
+
+  // Released objects are reused as they are, including their capacity
+  crosstalk::PooledPtr<TestObjectWithString> second = pool->acquire();
+  EXPECT_EQ( second->name.data(), data );
+
+  // Handles can outlive the pool and be released on another thread
+  delete pool;
+  std::thread( [handle = std::move( second )]() mutable { handle.reset(); } ).join();
+}
+
+TEST( ObjectPoolTest, pooledRead )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<2048> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<2048> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  auto make = []( uint16_t id ) {
+    TestWithClassVectorAndArray obj;
+    obj.id = id;
+    for ( int i = 0; i < 3; ++i ) {
+      obj.objects.push_back( { "uuid of an object that is long enough to allocate " + std::to_string( i ),
+                               { "first name that is long enough to allocate", "second" },
+                               { std::vector<int>{ 1, 2, 3 }, std::vector<int>( 20, i ), {} } } );
+      obj.object_array[i] = { i, "array entry with a name long enough to allocate" };
+    }
+    return obj;
+  };
+  // Serializing on the device side allocates, hence, everything is sent before counting allocations
+  for ( int i = 0; i < 20; ++i )
+    ASSERT_EQ( device.sendObject( make( i ) ), crosstalk::WriteResult::Success );
+  crosstalk::ObjectPool<TestWithClassVectorAndArray> pool;
+  // Handlers keep the last two objects across iterations
+  std::array<crosstalk::PooledPtr<TestWithClassVectorAndArray>, 2> kept;
+  size_t allocations_after_warmup = 0;
+  for ( int i = 0; i < 20; ++i ) {
+    if ( i == 5 )
+      allocations_after_warmup = allocations.load();
+    host.processSerialData( false );
+    crosstalk::PooledPtr<TestWithClassVectorAndArray> obj;
+    ASSERT_EQ( crosstalk::readObject( host, pool, obj ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( obj->id, i );
+    EXPECT_EQ( obj->objects[2].vectors[1].size(), 20 );
+    kept[i % 2] = std::move( obj );
+  }
+  EXPECT_EQ( allocations.load(), allocations_after_warmup );
+  EXPECT_EQ( pool.inUseCount(), 2 );
+  TestObjectSimple simple;
+  device.sendObject( TestObjectSimple{ 1, 1.0f } );
+  host.processSerialData();
+  crosstalk::PooledPtr<TestWithClassVectorAndArray> obj;
+  EXPECT_EQ( crosstalk::readObject( host, pool, obj ), crosstalk::ReadResult::ObjectIdMismatch );
+  EXPECT_FALSE( obj );
+  EXPECT_EQ( host.readObject( simple ), crosstalk::ReadResult::Success );
+}
+
+TEST( MessageBusTest, fanOut )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  crosstalk::MessageBus bus;
+  std::vector<crosstalk::PooledPtr<const TestObjectWithString>> first, second;
+  const auto first_id = bus.subscribe<TestObjectWithString>(
+      [&first]( const crosstalk::PooledPtr<const TestObjectWithString> &obj ) { first.push_back( obj ); } );
+  bus.subscribe<TestObjectWithString>(
+      [&second]( const crosstalk::PooledPtr<const TestObjectWithString> &obj ) { second.push_back( obj ); } );
+  std::vector<float> values;
+  bus.subscribe<TestObjectSimple>(
+      [&values]( const crosstalk::PooledPtr<const TestObjectSimple> &obj ) { values.push_back( obj->value ); } );
+  EXPECT_NE( first_id, 0 );
+  EXPECT_TRUE( bus.hasSubscribers( crosstalk::object_id<TestObjectSimple>() ) );
+  EXPECT_FALSE( bus.hasSubscribers( crosstalk::object_id<CommStatus>() ) );
+
+  device.sendObject( TestObjectWithString{ 1, "one" } );
+  device.sendObject( CommStatus{} );
+  device.sendObject( TestObjectSimple{ 2, 2.5f } );
+  device.sendObject( TestObjectWithString{ 3, "three" } );
+  host.processSerialData();
+  int unhandled = 0;
+  while ( host.hasObject() ) {
+    crosstalk::ReadResult result = bus.dispatch( host );
+    if ( result == crosstalk::ReadResult::ObjectIdMismatch ) {
+      ++unhandled;
+      host.skipObject();
+      continue;
+    }
+    ASSERT_EQ( result, crosstalk::ReadResult::Success );
+  }
+  EXPECT_EQ( unhandled, 1 );
+  EXPECT_EQ( values, std::vector<float>{ 2.5f } );
+  ASSERT_EQ( first.size(), 2 );
+  ASSERT_EQ( second.size(), 2 );
+  // Both subscribers share the same object
+  EXPECT_EQ( first[0].get(), second[0].get() );
+  EXPECT_EQ( first[1]->name, "three" );
+
+  // Unsubscribing, also from within a callback
+  EXPECT_TRUE( bus.unsubscribe( first_id ) );
+  EXPECT_FALSE( bus.unsubscribe( first_id ) );
+  crosstalk::MessageBus::SubscriptionId self = 0;
+  int calls = 0;
+  self = bus.subscribe<TestObjectSimple>( [&]( const crosstalk::PooledPtr<const TestObjectSimple> & ) {
+    ++calls;
+    bus.unsubscribe( self );
+  } );
+  bus.publish( TestObjectSimple{ 4, 4.0f } );
+  bus.publish( TestObjectSimple{ 5, 5.0f } );
+  EXPECT_EQ( calls, 1 );
+  EXPECT_EQ( values, ( std::vector<float>{ 2.5f, 4.0f, 5.0f } ) );
+}
+
+TEST( MessageBusTest, nestedPublish )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  crosstalk::MessageBus bus;
+  std::vector<int> first, second;
+  bus.subscribe<TestObjectSimple>( [&]( const crosstalk::PooledPtr<const TestObjectSimple> &obj ) {
+    first.push_back( obj->id );
+    if ( obj->id < 2 )
+      bus.publish( TestObjectSimple{ obj->id + 1, 0.0f } );
+  } );
+  crosstalk::MessageBus::SubscriptionId self = 0;
+  self = bus.subscribe<TestObjectSimple>( [&]( const crosstalk::PooledPtr<const TestObjectSimple> &obj ) {
+    second.push_back( obj->id );
+    bus.unsubscribe( self );
+  } );
+  // The innermost publish reaches both subscribers, the outer ones skip the removed subscriber
+  bus.publish( TestObjectSimple{ 0, 0.0f } );
+  EXPECT_EQ( first, ( std::vector<int>{ 0, 1, 2 } ) );
+  EXPECT_EQ( second, std::vector<int>{ 2 } );
+  bus.publish( TestObjectSimple{ 2, 0.0f } );
+  EXPECT_EQ( first, ( std::vector<int>{ 0, 1, 2, 2 } ) );
+  EXPECT_EQ( second, std::vector<int>{ 2 } );
+
+  // Dispatching from within a callback
+  std::vector<int> received;
+  bus.subscribe<TestObjectWithString>( [&]( const crosstalk::PooledPtr<const TestObjectWithString> &obj ) {
+    received.push_back( obj->uuid );
+    if ( host.hasObject() ) {
+      EXPECT_EQ( bus.dispatch( host ), crosstalk::ReadResult::Success );
+    }
+  } );
+  for ( int i = 0; i < 3; ++i ) device.sendObject( TestObjectWithString{ i, "nested" } );
+  host.processSerialData();
+  ASSERT_EQ( bus.dispatch( host ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( received, ( std::vector<int>{ 0, 1, 2 } ) );
+  EXPECT_FALSE( host.hasObject() );
+}
+
+TEST( MessageBusTest, sequenceHandler )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  device.setSequenceNumbers( crosstalk::SequenceNumbers::TwoBytes );
+  crosstalk::MessageBus bus;
+  std::vector<std::pair<int, uint16_t>> events;
+  bus.subscribe<TestObjectSimple>( [&events]( const crosstalk::PooledPtr<const TestObjectSimple> &obj ) {
+    events.emplace_back( obj->id, 0 );
+  } );
+  bus.setSequenceHandler( [&events]( const crosstalk::SequenceInfo &info ) {
+    events.emplace_back( -1, info.lost_frames );
+  } );
+  for ( int i = 0; i < 5; ++i ) {
+    device.sendObject( TestObjectSimple{ i, 0.0f } );
+    // Frames 2 and 3 are lost
+    if ( i == 2 || i == 3 )
+      host_buffer.clear();
+    host.processSerialData();
+    while ( host.hasObject() ) ASSERT_EQ( bus.dispatch( host ), crosstalk::ReadResult::Success );
+  }
+  // The handler is called before the subscribers receive the object after the gap
+  EXPECT_EQ( events, ( std::vector<std::pair<int, uint16_t>>{ { 0, 0 }, { 1, 0 }, { -1, 2 }, { 4, 0 } } ) );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,370 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/host/capture_index.hpp"
+#include "crosstalk/host/column_store.hpp"
+#include "crosstalk/host/offline_decoder.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include "gtest/gtest.h"
+#include <fstream>
+#include <random>
+
+struct GeneratedStream {
+  std::vector<uint8_t> data;
+  //! Offsets of the valid frames in the stream.
+  std::vector<uint64_t> frame_offsets;
+  //! The uuid of TestObjectWithString or id of TestObjectSimple for each decodable frame.
+  std::vector<int> keys;
+  size_t unknown_ids = 0;
+};
+
+/*!
+ * Appends a TestObjectWithString whose name contains the start of a fake frame that ends after it and
+ * hides the real frame that follows. A chunk starting inside the string resynchronizes on the fake.
+ */
+static void appendStraddlingFakeFrame( crosstalk::CrossTalker<1024> &sender, GeneratedStream &stream,
+                                       int key )
+{
+  const std::string fake_header = { 0x02, 0x42, 0x01, 0x00, 20, 0x00 };
+  stream.frame_offsets.push_back( stream.data.size() );
+  stream.keys.push_back( key );
+  sender.sendObject( TestObjectWithString{ key, "ab" + fake_header + "cd" } );
+  // 6 header bytes, "cd" and the outer CRC are in the real frame, the next 16 byte frame follows
+  const size_t fake_offset = stream.data.size() - 10;
+  stream.frame_offsets.push_back( stream.data.size() );
+  stream.keys.push_back( key );
+  sender.sendObject( TestObjectSimple{ key, 3.0f } );
+  uint16_t crc = crosstalk::util::compute_crc16( &stream.data[fake_offset], 26 );
+  stream.data.push_back( crc & 0xFF );
+  stream.data.push_back( crc >> 8 );
+}
+
+static GeneratedStream generateStream( int count, unsigned seed )
+{
+  GeneratedStream stream;
+  std::vector<uint8_t> unused;
+  crosstalk::CrossTalker<1024> sender(
+      std::make_unique<TestSerialAbstraction>( stream.data, unused ) );
+  std::mt19937 rng( seed );
+  for ( int i = 0; i < count; ++i ) {
+    switch ( rng() % 7 ) {
+    case 0: {
+      // Text output, including stray markers
+      std::string text = "LOG " + std::to_string( i ) + "\n";
+      if ( rng() % 2 )
+        text += std::string{ 0x02, 0x42, char( rng() ), char( rng() ), char( rng() ) };
+      stream.data.insert( stream.data.end(), text.begin(), text.end() );
+      break;
+    }
+    case 1: {
+      // Corrupted frame
+      sender.sendObject( TestObjectSimple{ i, 1.0f } );
+      stream.data[stream.data.size() - 3] ^= 0x10;
+      break;
+    }
+    case 2: {
+      // Valid frame with an id the decoder does not know
+      stream.frame_offsets.push_back( stream.data.size() );
+      sender.sendObject( CommStatus{} );
+      ++stream.unknown_ids;
+      break;
+    }
+    case 3:
+      appendStraddlingFakeFrame( sender, stream, i );
+      break;
+    case 4: {
+      // A complete valid frame nested in the string of another one
+      std::vector<uint8_t> nested;
+      crosstalk::CrossTalker<1024> nested_sender(
+          std::make_unique<TestSerialAbstraction>( nested, unused ) );
+      nested_sender.sendObject( TestObjectSimple{ -1, 2.0f } );
+      stream.frame_offsets.push_back( stream.data.size() );
+      stream.keys.push_back( i );
+      sender.sendObject( TestObjectWithString{ i, std::string( nested.begin(), nested.end() ) } );
+      break;
+    }
+    case 5:
+      stream.frame_offsets.push_back( stream.data.size() );
+      stream.keys.push_back( i );
+      sender.sendObject( TestObjectSimple{ i, 0.5f * i } );
+      break;
+    default:
+      stream.frame_offsets.push_back( stream.data.size() );
+      stream.keys.push_back( i );
+      sender.sendObject( TestObjectWithString{ i, std::string( rng() % 100, 'x' ) } );
+      break;
+    }
+  }
+  return stream;
+}
+
+static void expectDecoded( const GeneratedStream &expected,
+                           const std::vector<crosstalk::DecodedObject<TestObjectSimple, TestObjectWithString>> &decoded )
+{
+  ASSERT_EQ( decoded.size(), expected.keys.size() );
+  for ( size_t i = 0; i < decoded.size(); ++i ) {
+    if ( auto *simple = std::get_if<TestObjectSimple>( &decoded[i].object ) )
+      EXPECT_EQ( simple->id, expected.keys[i] );
+    else
+      EXPECT_EQ( std::get<TestObjectWithString>( decoded[i].object ).uuid, expected.keys[i] );
+  }
+}
+
+TEST( OfflineDecoderTest, sequential )
+{
+  GeneratedStream expected = generateStream( 2000, 42 );
+  crosstalk::OfflineDecoderOptions options;
+  options.threads = 1;
+  options.chunk_size = expected.data.size();
+  crosstalk::OfflineDecoder decoder( options );
+  crosstalk::CaptureStream stream( expected.data.data(), expected.data.size() );
+  auto decoded = decoder.decode<TestObjectSimple, TestObjectWithString>( stream );
+  expectDecoded( expected, decoded );
+  ASSERT_EQ( decoder.statistics().frames, expected.frame_offsets.size() );
+  EXPECT_EQ( decoder.statistics().unknown_ids, expected.unknown_ids );
+  EXPECT_EQ( decoder.statistics().size_mismatches, 0 );
+  auto frames = decoder.findFrames( stream );
+  uint64_t frame_bytes = 0;
+  for ( size_t i = 0; i < frames.size(); ++i ) {
+    EXPECT_EQ( frames[i].offset, expected.frame_offsets[i] );
+    frame_bytes += frames[i].end() - frames[i].offset;
+  }
+  EXPECT_EQ( decoder.statistics().skipped_bytes, expected.data.size() - frame_bytes );
+}
+
+TEST( OfflineDecoderTest, chunkBoundaries )
+{
+  // Every chunk size places boundaries at different positions inside frames and fake frames
+  GeneratedStream expected = generateStream( 300, 7 );
+  crosstalk::CaptureStream stream( expected.data.data(), expected.data.size() );
+  for ( size_t chunk_size : { 1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 377, 610 } ) {
+    crosstalk::OfflineDecoderOptions options;
+    options.threads = 3;
+    options.chunk_size = chunk_size;
+    crosstalk::OfflineDecoder decoder( options );
+    auto frames = decoder.findFrames( stream );
+    ASSERT_EQ( frames.size(), expected.frame_offsets.size() ) << "Chunk size: " << chunk_size;
+    for ( size_t i = 0; i < frames.size(); ++i )
+      ASSERT_EQ( frames[i].offset, expected.frame_offsets[i] ) << "Chunk size: " << chunk_size;
+  }
+  for ( size_t chunk_offset = 0; chunk_offset < 64; ++chunk_offset ) {
+    crosstalk::OfflineDecoderOptions options;
+    options.threads = 4;
+    options.chunk_size = 64 + chunk_offset;
+    crosstalk::OfflineDecoder decoder( options );
+    expectDecoded( expected, decoder.decode<TestObjectSimple, TestObjectWithString>( stream ) );
+  }
+}
+
+TEST( OfflineDecoderTest, captureFile )
+{
+  // Records split frames at arbitrary positions and are interleaved with the other direction
+  GeneratedStream expected = generateStream( 1000, 3 );
+  const std::string path = ::testing::TempDir() + "crosstalk_offline.ctcap";
+  {
+    std::ofstream file( path, std::ios::binary );
+    uint8_t header[crosstalk::CaptureFileHeader::SIZE];
+    crosstalk::CaptureFileHeader{}.encode( header );
+    file.write( reinterpret_cast<const char *>( header ), sizeof( header ) );
+    std::mt19937 rng( 1 );
+    const uint8_t written[] = { 0x02, 0x42, 0x01, 0x00 };
+    size_t offset = 0;
+    for ( uint64_t timestamp = 0; offset < expected.data.size(); timestamp += 1000 ) {
+      const auto direction = rng() % 4 == 0 ? crosstalk::CaptureDirection::Write
+                                             : crosstalk::CaptureDirection::Read;
+      uint32_t length = direction == crosstalk::CaptureDirection::Write
+                            ? sizeof( written )
+                            : std::min<size_t>( 1 + rng() % 50, expected.data.size() - offset );
+      uint8_t record_header[crosstalk::CaptureRecordHeader::SIZE];
+      crosstalk::CaptureRecordHeader{ timestamp, length, direction }.encode( record_header );
+      file.write( reinterpret_cast<const char *>( record_header ), sizeof( record_header ) );
+      const uint8_t *data = direction == crosstalk::CaptureDirection::Write ? written
+                                                                            : &expected.data[offset];
+      file.write( reinterpret_cast<const char *>( data ), length );
+      if ( direction == crosstalk::CaptureDirection::Read )
+        offset += length;
+    }
+  }
+  crosstalk::CaptureFile file( path );
+  ASSERT_TRUE( file.isOpen() );
+  crosstalk::CaptureStream stream( file );
+  ASSERT_EQ( stream.size(), expected.data.size() );
+  crosstalk::OfflineDecoderOptions options;
+  options.threads = 2;
+  options.chunk_size = 100;
+  crosstalk::OfflineDecoder decoder( options );
+  auto decoded = decoder.decode<TestObjectSimple, TestObjectWithString>( stream );
+  expectDecoded( expected, decoded );
+  for ( size_t i = 1; i < decoded.size(); ++i )
+    EXPECT_LE( decoded[i - 1].frame.timestamp_ns, decoded[i].frame.timestamp_ns );
+}
+
+TEST( OfflineDecoderTest, captureIndex )
+{
+  // One record per ms, alternating between CommStatus and TestObjectSimple with text in between
+  const std::string path = ::testing::TempDir() + "crosstalk_index.ctcap";
+  {
+    std::ofstream file( path, std::ios::binary );
+    uint8_t header[crosstalk::CaptureFileHeader::SIZE];
+    crosstalk::CaptureFileHeader{}.encode( header );
+    file.write( reinterpret_cast<const char *>( header ), sizeof( header ) );
+    std::vector<uint8_t> record;
+    std::vector<uint8_t> unused;
+    crosstalk::CrossTalker<256> sender( std::make_unique<TestSerialAbstraction>( record, unused ) );
+    for ( int i = 0; i < 100; ++i ) {
+      record.clear();
+      // The second half of the frames carries sequence counters
+      if ( i == 50 )
+        sender.setSequenceNumbers( crosstalk::SequenceNumbers::TwoBytes );
+      if ( i % 2 == 0 )
+        sender.sendObject( CommStatus{ uint64_t( i ) } );
+      else
+        sender.sendObject( TestObjectSimple{ i, 1.0f } );
+      record.insert( record.end(), { 'L', 'O', 'G', '\n' } );
+      uint8_t record_header[crosstalk::CaptureRecordHeader::SIZE];
+      crosstalk::CaptureRecordHeader{ i * 1000000ull, uint32_t( record.size() ),
+                                      crosstalk::CaptureDirection::Read }
+          .encode( record_header );
+      file.write( reinterpret_cast<const char *>( record_header ), sizeof( record_header ) );
+      file.write( reinterpret_cast<const char *>( record.data() ), record.size() );
+    }
+  }
+  crosstalk::CaptureFile file( path );
+  ASSERT_TRUE( file.isOpen() );
+  crosstalk::CaptureStream stream( file );
+  crosstalk::OfflineDecoderOptions options;
+  options.chunk_size = 256;
+  const std::string index_path = crosstalk::CaptureIndex::sidecarPath( path );
+  ASSERT_TRUE( crosstalk::CaptureIndex::build( stream, options ).save( index_path ) );
+
+  crosstalk::CaptureIndex index;
+  ASSERT_TRUE( index.load( index_path ) );
+  ASSERT_EQ( index.size(), 100 );
+  EXPECT_EQ( index.streamSize(), stream.size() );
+  EXPECT_EQ( index.frame( 3 ).timestamp_ns, 3000000 );
+  EXPECT_EQ( index.frame( 3 ).id, 1 );
+  EXPECT_EQ( index.frame( 3 ).sequence_bytes, 0 );
+  EXPECT_EQ( index.frame( 60 ).sequence_bytes, 2 );
+  // Frames are followed by the 4 bytes of text
+  EXPECT_EQ( index.frame( 3 ).end() + 4, index.frame( 4 ).offset );
+  EXPECT_EQ( index.frame( 60 ).end() + 4, index.frame( 61 ).offset );
+
+  auto frames = index.query( crosstalk::object_id<TestObjectSimple>(), 20000000, 40000000 );
+  ASSERT_EQ( frames.size(), 10 );
+  EXPECT_EQ( frames.front().timestamp_ns, 21000000 );
+  EXPECT_EQ( frames.back().timestamp_ns, 39000000 );
+
+  auto statuses = index.read<CommStatus>( stream, 20000000, 40000000 );
+  ASSERT_EQ( statuses.size(), 10 );
+  for ( size_t i = 0; i < statuses.size(); ++i ) {
+    EXPECT_EQ( std::get<CommStatus>( statuses[i].object ).last_received_message_age_ms, 20 + 2 * i );
+    EXPECT_EQ( statuses[i].frame.timestamp_ns, ( 20 + 2 * i ) * 1000000 );
+  }
+  EXPECT_EQ( index.read<TestObjectSimple>( stream ).size(), 50 );
+
+  EXPECT_FALSE( index.load( path ) );
+}
+
+TEST( OfflineDecoderTest, columnStore )
+{
+  static_assert( crosstalk::ColumnStore<CommStatus>::FIXED_LAYOUT );
+  static_assert( crosstalk::ColumnStore<CommStatus>::FIXED_PAYLOAD_SIZE == 26 );
+  static_assert( !crosstalk::ColumnStore<TestObjectWithString>::FIXED_LAYOUT );
+  // Runs of adjacent CommStatus frames interrupted by other frames and text
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> unused;
+  crosstalk::CrossTalker<256> sender( std::make_unique<TestSerialAbstraction>( data, unused ) );
+  std::vector<CommStatus> statuses;
+  std::vector<TestObjectWithString> strings;
+  for ( int i = 0; i < 500; ++i ) {
+    statuses.push_back( CommStatus{ uint64_t( i ), -1.0f * i, 2.0f * i, 0.5f, CommQuality( i % 4 ),
+                                    CommQuality::LOW_QUALITY, CommQuality::NONE,
+                                    CommState( i % 2 ), CommState::ERROR, CommState::CONNECTED } );
+    sender.sendObject( statuses.back() );
+    if ( i % 7 == 0 && i < 200 ) {
+      strings.push_back( TestObjectWithString{ i, std::string( i % 13, 'a' + i % 26 ) } );
+      sender.sendObject( strings.back() );
+    }
+    if ( i % 11 == 0 && i < 200 ) // The rest is one long run
+      data.insert( data.end(), { 'L', 'O', 'G' } );
+  }
+  crosstalk::CaptureStream stream( data.data(), data.size() );
+  crosstalk::OfflineDecoder decoder;
+  std::vector<crosstalk::FrameInfo> frames = decoder.findFrames( stream );
+
+  auto status_columns = crosstalk::readObjects<CommStatus>( stream, frames );
+  ASSERT_EQ( status_columns.size(), statuses.size() );
+  EXPECT_STREQ( status_columns.columnNames()[1], "ble_rssi" );
+  for ( size_t i = 0; i < statuses.size(); ++i ) {
+    EXPECT_EQ( status_columns.column<0>()[i], statuses[i].last_received_message_age_ms );
+    EXPECT_EQ( status_columns.column<1>()[i], statuses[i].ble_rssi );
+    EXPECT_EQ( status_columns.column<2>()[i], statuses[i].radio_rssi );
+    EXPECT_EQ( status_columns.column<4>()[i], statuses[i].ble_quality );
+    EXPECT_EQ( status_columns.column<7>()[i], statuses[i].ble_state );
+    EXPECT_EQ( status_columns.row( i ).esp_now_state, statuses[i].esp_now_state );
+  }
+
+  auto string_columns = crosstalk::readObjects<TestObjectWithString>( stream, frames );
+  ASSERT_EQ( string_columns.size(), strings.size() );
+  for ( size_t i = 0; i < strings.size(); ++i ) {
+    EXPECT_EQ( string_columns.column<0>()[i], strings[i].uuid );
+    EXPECT_EQ( string_columns.column<1>()[i], strings[i].name );
+  }
+
+  // Runs that are split across capture records fall back to decoding frame by frame
+  const std::string path = ::testing::TempDir() + "crosstalk_columns.ctcap";
+  {
+    std::ofstream file( path, std::ios::binary );
+    uint8_t header[crosstalk::CaptureFileHeader::SIZE];
+    crosstalk::CaptureFileHeader{}.encode( header );
+    file.write( reinterpret_cast<const char *>( header ), sizeof( header ) );
+    for ( size_t offset = 0; offset < data.size(); offset += 1000 ) {
+      uint32_t length = std::min<size_t>( 1000, data.size() - offset );
+      uint8_t record_header[crosstalk::CaptureRecordHeader::SIZE];
+      crosstalk::CaptureRecordHeader{ offset, length, crosstalk::CaptureDirection::Read }.encode(
+          record_header );
+      file.write( reinterpret_cast<const char *>( record_header ), sizeof( record_header ) );
+      file.write( reinterpret_cast<const char *>( &data[offset] ), length );
+    }
+  }
+  crosstalk::CaptureFile file( path );
+  crosstalk::CaptureStream split_stream( file );
+  crosstalk::ColumnStore<CommStatus> store;
+  ASSERT_EQ( crosstalk::readObjects( split_stream, decoder.findFrames( split_stream ), store ),
+             statuses.size() );
+  for ( size_t i = 0; i < statuses.size(); ++i )
+    EXPECT_EQ( store.row( i ).radio_rssi, statuses[i].radio_rssi );
+  EXPECT_FALSE( store.append( data.data(), 10 ) );
+}
+
+TEST( OfflineDecoderTest, columnStoreMismatchedRun )
+{
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> unused;
+  crosstalk::CrossTalker<256> sender( std::make_unique<TestSerialAbstraction>( data, unused ) );
+  for ( int i = 0; i < 20; ++i ) sender.sendObject( CommStatus{ uint64_t( i ) } );
+  // A frame with the id of CommStatus but a shorter payload directly after the run
+  const size_t fake_offset = data.size();
+  constexpr int16_t id = crosstalk::object_id<CommStatus>();
+  data.insert( data.end(), { 0x02, 0x42, uint8_t( id & 0xFF ), uint8_t( id >> 8 ), 24, 0x00 } );
+  data.insert( data.end(), 24, 0xAB );
+  uint16_t crc = crosstalk::util::compute_crc16( &data[fake_offset], 30 );
+  data.push_back( crc & 0xFF );
+  data.push_back( crc >> 8 );
+  // Followed by frames with sequence counters
+  sender.setSequenceNumbers( crosstalk::SequenceNumbers::TwoBytes );
+  for ( int i = 20; i < 40; ++i ) sender.sendObject( CommStatus{ uint64_t( i ) } );
+
+  crosstalk::CaptureStream stream( data.data(), data.size() );
+  std::vector<crosstalk::FrameInfo> frames = crosstalk::OfflineDecoder().findFrames( stream );
+  ASSERT_EQ( frames.size(), 41 );
+  EXPECT_EQ( frames[20].payload_size, 24 );
+  auto columns = crosstalk::readObjects<CommStatus>( stream, frames );
+  ASSERT_EQ( columns.size(), 40 );
+  for ( size_t i = 0; i < columns.size(); ++i ) EXPECT_EQ( columns.column<0>()[i], i );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_udp_serial_wrapper.hpp"
+#include "test_objects.hpp"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <thread>
+
+//! Counts the packets sent through the wrapped transport.
+class CountingPacketWrapper : public crosstalk::SerialAbstraction
+{
+public:
+  explicit CountingPacketWrapper( std::unique_ptr<crosstalk::SerialAbstraction> serial )
+      : serial_( std::move( serial ) )
+  {
+  }
+
+  int available() const override { return serial_->available(); }
+
+  int read( uint8_t *data, size_t length ) override { return serial_->read( data, length ); }
+
+  bool write( const uint8_t *data, size_t length ) override { return serial_->write( data, length ); }
+
+  bool isPacketTransport() const override { return serial_->isPacketTransport(); }
+
+  size_t maxPacketSize() const override { return serial_->maxPacketSize(); }
+
+  bool sendPacket( const uint8_t *data, size_t length ) override
+  {
+    if ( fail )
+      return false;
+    ++packets;
+    max_size = std::max( max_size, length );
+    return serial_->sendPacket( data, length );
+  }
+
+  int receivePacket( uint8_t *data, size_t length ) override { return serial_->receivePacket( data, length ); }
+
+  size_t packets = 0;
+  size_t max_size = 0;
+  //! If true, sending packets fails.
+  bool fail = false;
+
+private:
+  std::unique_ptr<crosstalk::SerialAbstraction> serial_;
+};
+
+//! Waits until the host received count objects of type T, returns the number received.
+template<typename T, typename CrossTalkerT>
+int receive( CrossTalkerT &host, std::vector<T> &objects, int count )
+{
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 5 );
+  while ( static_cast<int>( objects.size() ) < count && std::chrono::steady_clock::now() < deadline ) {
+    host.processSerialData( false );
+    T obj;
+    while ( host.readObject( obj ) == crosstalk::ReadResult::Success ) objects.push_back( obj );
+  }
+  return objects.size();
+}
+
+TEST( PacketTransportTest, batching )
+{
+  auto host_socket = std::make_unique<crosstalk::UdpSerialWrapper>( "127.0.0.1", 0 );
+  ASSERT_TRUE( host_socket->isOpen() );
+  auto device_socket = std::make_unique<crosstalk::UdpSerialWrapper>( "127.0.0.1", host_socket->localPort(),
+                                                                      0, 100 );
+  ASSERT_TRUE( device_socket->isOpen() );
+  ASSERT_TRUE( host_socket->connect( "127.0.0.1", device_socket->localPort() ) );
+  auto counting = std::make_unique<CountingPacketWrapper>( std::move( device_socket ) );
+  CountingPacketWrapper &device_packets = *counting;
+  crosstalk::CrossTalker<1024, 256> device( std::move( counting ) );
+  crosstalk::CrossTalker<1024, 256> host( std::move( host_socket ) );
+
+  // One packet per frame by default, 14 bytes per TestObjectSimple without the start marker
+  for ( int i = 0; i < 3; ++i ) device.sendObject( TestObjectSimple{ i, 1.0f } );
+  EXPECT_EQ( device_packets.packets, 3 );
+  std::vector<TestObjectSimple> simple;
+  ASSERT_EQ( receive( host, simple, 3 ), 3 );
+
+  // With batching, frames are packed up to the maximum packet size of 100 bytes
+  device.setPacketBatching( true );
+  for ( int i = 3; i < 20; ++i ) device.sendObject( TestObjectSimple{ i, 1.0f } );
+  EXPECT_EQ( device_packets.packets, 3 + 2 );
+  EXPECT_EQ( device_packets.max_size, 7 * 14 );
+  EXPECT_TRUE( device.flushPackets() );
+  EXPECT_EQ( device_packets.packets, 3 + 3 );
+  ASSERT_EQ( receive( host, simple, 20 ), 20 );
+  for ( int i = 0; i < 20; ++i ) EXPECT_EQ( simple[i].id, i );
+  EXPECT_EQ( host.statistics().dropped_frames, 0 );
+
+  // Frames of different types share packets and pending frames are sent before receiving
+  device.sendObject( TestObjectWithString{ 1, "first" } );
+  device.sendObject( TestObjectSimple{ 20, 2.0f } );
+  device.sendObject( TestObjectWithString{ 2, "second" } );
+  EXPECT_EQ( device_packets.packets, 6 );
+  device.processSerialData();
+  EXPECT_EQ( device_packets.packets, 7 );
+  std::vector<TestObjectWithString> strings;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 5 );
+  while ( strings.size() < 2 && std::chrono::steady_clock::now() < deadline ) {
+    host.processSerialData( false );
+    TestObjectWithString with_string;
+    TestObjectSimple obj;
+    if ( host.readObject( with_string ) == crosstalk::ReadResult::Success )
+      strings.push_back( with_string );
+    else if ( host.readObject( obj ) == crosstalk::ReadResult::Success )
+      simple.push_back( obj );
+  }
+  ASSERT_EQ( strings.size(), 2 );
+  EXPECT_EQ( strings[1].name, "second" );
+  ASSERT_EQ( simple.size(), 21 );
+  EXPECT_EQ( simple.back().value, 2.0f );
+
+  // Frames larger than the maximum packet size can not be sent
+  EXPECT_EQ( device.sendObject( TestObjectWithString{ 3, std::string( 100, 'x' ) } ),
+             crosstalk::WriteResult::ObjectTooLarge );
+}
+
+TEST( PacketTransportTest, failedImplicitFlush )
+{
+  auto host_socket = std::make_unique<crosstalk::UdpSerialWrapper>( "127.0.0.1", 0 );
+  ASSERT_TRUE( host_socket->isOpen() );
+  auto device_socket = std::make_unique<crosstalk::UdpSerialWrapper>( "127.0.0.1", host_socket->localPort() );
+  ASSERT_TRUE( device_socket->isOpen() );
+  ASSERT_TRUE( host_socket->connect( "127.0.0.1", device_socket->localPort() ) );
+  auto counting = std::make_unique<CountingPacketWrapper>( std::move( device_socket ) );
+  CountingPacketWrapper &device_packets = *counting;
+  crosstalk::CrossTalker<1024, 256> device( std::move( counting ) );
+  crosstalk::CrossTalker<1024, 256> host( std::move( host_socket ) );
+  device.setPacketBatching( true );
+
+  // The packet flushed in processSerialData fails, the next send reports it without sending
+  ASSERT_EQ( device.sendObject( TestObjectSimple{ 0, 1.0f } ), crosstalk::WriteResult::Success );
+  ASSERT_EQ( device.sendObject( TestObjectSimple{ 1, 1.0f } ), crosstalk::WriteResult::Success );
+  device_packets.fail = true;
+  device.processSerialData();
+  device_packets.fail = false;
+  EXPECT_EQ( device.sendObject( TestObjectSimple{ 2, 1.0f } ), crosstalk::WriteResult::WriteError );
+  EXPECT_EQ( device.sendObject( TestObjectSimple{ 3, 1.0f } ), crosstalk::WriteResult::Success );
+  EXPECT_TRUE( device.flushPackets() );
+
+  // Or the next flushPackets
+  ASSERT_EQ( device.sendObject( TestObjectSimple{ 4, 1.0f } ), crosstalk::WriteResult::Success );
+  device_packets.fail = true;
+  device.processSerialData();
+  device_packets.fail = false;
+  EXPECT_FALSE( device.flushPackets() );
+  EXPECT_TRUE( device.flushPackets() );
+  ASSERT_EQ( device.sendObject( TestObjectSimple{ 5, 1.0f } ), crosstalk::WriteResult::Success );
+  EXPECT_TRUE( device.flushPackets() );
+
+  std::vector<TestObjectSimple> simple;
+  ASSERT_EQ( receive( host, simple, 2 ), 2 );
+  EXPECT_EQ( simple[0].id, 3 );
+  EXPECT_EQ( simple[1].id, 5 );
+  EXPECT_EQ( device_packets.packets, 2 );
+}
+
+TEST( PacketTransportTest, emptyDatagram )
+{
+  auto host_socket = std::make_unique<crosstalk::UdpSerialWrapper>( "127.0.0.1", 0 );
+  ASSERT_TRUE( host_socket->isOpen() );
+  auto device_socket = std::make_unique<crosstalk::UdpSerialWrapper>( "127.0.0.1", host_socket->localPort() );
+  ASSERT_TRUE( device_socket->isOpen() );
+  ASSERT_TRUE( host_socket->connect( "127.0.0.1", device_socket->localPort() ) );
+  crosstalk::UdpSerialWrapper &raw = *device_socket;
+  crosstalk::CrossTalker<256> device( std::move( device_socket ) );
+  crosstalk::CrossTalker<256> host( std::move( host_socket ) );
+
+  // An empty datagram must not block the datagrams queued behind it
+  ASSERT_TRUE( raw.write( nullptr, 0 ) );
+  device.sendObject( TestObjectSimple{ 1, 1.0f } );
+  std::vector<TestObjectSimple> simple;
+  ASSERT_EQ( receive( host, simple, 1 ), 1 );
+  EXPECT_EQ( simple[0].id, 1 );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
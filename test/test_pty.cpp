@@ -0,0 +1,126 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_fd_serial_wrapper.hpp"
+#include "test_objects.hpp"
+#include "test_sequence.hpp"
+#include "verify_test_sequence.hpp"
+#include <atomic>
+#include <cstring>
+#include <pty.h>
+#include <thread>
+
+//! Pseudo terminal pair in raw mode. The slave side plays the device, the master side the host.
+struct PtyPair {
+  PtyPair()
+  {
+    if ( openpty( &master, &slave, nullptr, nullptr, nullptr ) != 0 )
+      throw std::runtime_error( "Failed to open pty: " + std::string( strerror( errno ) ) );
+    crosstalk::makeRawTty( slave );
+  }
+
+  ~PtyPair()
+  {
+    close( master );
+    close( slave );
+  }
+
+  int master = -1;
+  int slave = -1;
+};
+
+//! Emulates the ESP32 test firmware on the given fd. Fatal assertions only return from a thread,
+//! hence, failures are reported with EXPECT and the failed flag.
+void runTestFirmware( int fd, std::atomic<bool> &failed )
+{
+  uint8_t start = 0;
+  while ( start != 0x42 ) {
+    if ( ::read( fd, &start, 1 ) != 1 ) {
+      ADD_FAILURE() << "Failed to read the start byte: " << strerror( errno );
+      failed = true;
+      return;
+    }
+  }
+  crosstalk::CrossTalker<512, 256> crosstalker(
+      std::make_unique<crosstalk::FileDescriptorSerialWrapper>( fd ) );
+  sendTestSequence(
+      crosstalker,
+      [fd, &failed]( const char *text ) {
+        const ssize_t written = ::write( fd, text, strlen( text ) );
+        EXPECT_GT( written, 0 );
+        if ( written <= 0 )
+          failed = true;
+      },
+      []() { std::this_thread::sleep_for( 20ms ); } );
+}
+
+TEST( PtyTest, communication )
+{
+  PtyPair pty;
+  // The start byte is buffered by the pty, so it is written before the device thread exists
+  const uint8_t start = 0x42;
+  ASSERT_EQ( ::write( pty.master, &start, 1 ), 1 );
+  std::atomic<bool> device_failed{ false };
+  std::thread device( runTestFirmware, pty.slave, std::ref( device_failed ) );
+  crosstalk::CrossTalker<256, 256> comm(
+      std::make_unique<crosstalk::FileDescriptorSerialWrapper>( pty.master ) );
+  verifyTestSequence( comm );
+  device.join();
+  EXPECT_FALSE( device_failed );
+}
+
+TEST( PtyTest, bulkTransfer )
+{
+  // The device writes without pacing, so the host sees kernel buffering and partial reads
+  PtyPair pty;
+  constexpr int count = 2000;
+  std::atomic<bool> device_failed{ false };
+  std::thread device( [fd = pty.slave, &device_failed]() {
+    crosstalk::CrossTalker<512, 256> crosstalker(
+        std::make_unique<crosstalk::FileDescriptorSerialWrapper>( fd ) );
+    for ( int i = 0; i < count; ++i ) {
+      crosstalker.sendObject( TestObjectWithString{ i, "Object " + std::to_string( i ) } );
+      const ssize_t written = ::write( fd, "LOG\n", 4 );
+      EXPECT_EQ( written, 4 );
+      if ( written != 4 ) {
+        device_failed = true;
+        return;
+      }
+    }
+  } );
+  crosstalk::CrossTalker<128> comm(
+      std::make_unique<crosstalk::FileDescriptorSerialWrapper>( pty.master ) );
+  int received = 0;
+  size_t text_bytes = 0;
+  steady_clock::time_point start = steady_clock::now();
+  while ( received < count && !device_failed && steady_clock::now() - start < 10s ) {
+    comm.processSerialData( false ); // Lossless, the kernel buffers what does not fit
+    text_bytes += comm.skip();
+    if ( !comm.hasObject() )
+      continue;
+    TestObjectWithString obj;
+    auto result = comm.readObject( obj );
+    if ( result == crosstalk::ReadResult::NotEnoughData )
+      continue;
+    EXPECT_EQ( result, crosstalk::ReadResult::Success );
+    EXPECT_EQ( obj.uuid, received );
+    EXPECT_EQ( obj.name, "Object " + std::to_string( received ) );
+    if ( result != crosstalk::ReadResult::Success || obj.uuid != received )
+      break;
+    ++received;
+  }
+  if ( received < count ) {
+    // Hanging up the master wakes the device if it is blocked on the full pty
+    close( pty.master );
+    pty.master = -1;
+  }
+  device.join();
+  ASSERT_EQ( received, count );
+  comm.processSerialData();
+  text_bytes += comm.skip();
+  EXPECT_EQ( text_bytes, 4 * count );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,163 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/reliable.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_link_simulator.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+using Side = crosstalk::LinkSimulator::Side;
+
+static constexpr int16_t RELIABLE_ID = static_cast<int16_t>( crosstalk::InternalObjectId::Reliable );
+static constexpr int16_t ACK_ID = static_cast<int16_t>( crosstalk::InternalObjectId::ReliableAck );
+
+template<typename CrossTalker, typename Receiver>
+void receiveAll( CrossTalker &crosstalker, Receiver &receiver )
+{
+  crosstalker.processSerialData();
+  while ( crosstalker.hasObject() ) ASSERT_EQ( receiver.receive( crosstalker ), crosstalk::ReadResult::Success );
+}
+
+template<typename CrossTalker, typename Sender>
+void readAcks( CrossTalker &crosstalker, Sender &sender, uint32_t now_ms )
+{
+  crosstalker.processSerialData();
+  while ( crosstalker.hasObject() ) ASSERT_EQ( sender.readAck( crosstalker, now_ms ), crosstalk::ReadResult::Success );
+}
+
+TEST( ReliableTest, selectiveRetransmission )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  crosstalk::ReliableSender<4> sender;
+  crosstalk::ReliableReceiver<4> receiver;
+
+  for ( int i = 0; i < 4; ++i ) {
+    const size_t size = host_buffer.size();
+    ASSERT_EQ( sender.send( device, TestObjectSimple{ i, 0.5f }, 0 ), crosstalk::WriteResult::Success );
+    if ( i == 1 )
+      host_buffer.resize( size ); // Lost on the link
+  }
+  EXPECT_EQ( sender.send( device, TestObjectSimple{ 4, 0.5f }, 0 ), crosstalk::WriteResult::WindowFull );
+  receiveAll( host, receiver );
+  EXPECT_EQ( receiver.statistics().out_of_order_frames, 2 );
+  TestObjectSimple simple;
+  ASSERT_EQ( receiver.readObject( simple ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( simple.id, 0 );
+  // The next object in order is missing
+  EXPECT_FALSE( receiver.hasObject() );
+
+  // Frame 0 is acknowledged cumulatively, 2 and 3 selectively
+  readAcks( device, sender, 10 );
+  EXPECT_EQ( sender.inFlight(), 3 );
+  EXPECT_EQ( sender.smoothedRtt(), 10 );
+  // Three acknowledgements with the same round-trip time reduce the variance
+  EXPECT_EQ( sender.rto(), 22 );
+  EXPECT_EQ( sender.poll( device, 21 ), 0 );
+  EXPECT_EQ( sender.poll( device, 22 ), 1 );
+  EXPECT_EQ( sender.rto(), 44 );
+  // Duplicates are dropped
+  const std::vector<uint8_t> retransmission = host_buffer;
+  host_buffer.insert( host_buffer.end(), retransmission.begin(), retransmission.end() );
+  receiveAll( host, receiver );
+  EXPECT_EQ( receiver.statistics().duplicate_frames, 1 );
+  for ( int i = 1; i < 4; ++i ) {
+    ASSERT_EQ( receiver.readObject( simple ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( simple.id, i );
+  }
+  EXPECT_FALSE( receiver.hasObject() );
+  readAcks( device, sender, 40 );
+  EXPECT_EQ( sender.inFlight(), 0 );
+  EXPECT_EQ( sender.statistics().retransmitted_frames, 1 );
+  // Nothing is retransmitted once everything was acknowledged
+  EXPECT_EQ( sender.poll( device, 1000 ), 0 );
+
+  // A restarted sender uses a new session and the receiver starts over
+  crosstalk::ReliableSender<4> restarted( 1 );
+  ASSERT_EQ( restarted.send( device, TestObjectWithString{ 1, "restarted" }, 50 ), crosstalk::WriteResult::Success );
+  receiveAll( host, receiver );
+  EXPECT_EQ( receiver.getObjectId(), crosstalk::object_id<TestObjectWithString>() );
+  EXPECT_EQ( receiver.readObject( simple ), crosstalk::ReadResult::ObjectIdMismatch );
+  EXPECT_EQ( receiver.skipObject(), crosstalk::ReadResult::Success );
+  // Acknowledgements for the old session are ignored by the new sender and vice versa
+  readAcks( device, sender, 60 );
+  EXPECT_EQ( restarted.inFlight(), 1 );
+  receiver.sendAck( host );
+  readAcks( device, restarted, 60 );
+  EXPECT_EQ( restarted.inFlight(), 0 );
+}
+
+TEST( ReliableTest, lossyLink )
+{
+  crosstalk::LinkSimulatorConfig config;
+  config.baud_rate = 115200;
+  config.tx_buffer_size = 1024;
+  config.latency = 2ms;
+  config.byte_drop_rate = 2e-3;
+  crosstalk::LinkSimulator link( config );
+  crosstalk::CrossTalker<1024> device( link.createEndpoint( Side::A ) );
+  crosstalk::CrossTalker<1024> host( link.createEndpoint( Side::B ) );
+  crosstalk::ReliableSender<8> sender;
+  crosstalk::ReliableReceiver<8> receiver;
+
+  constexpr int COUNT = 300;
+  int next_reliable = 0;
+  std::vector<int> received;
+  int telemetry_sent = 0;
+  int telemetry_received = 0;
+  uint32_t now_ms = 0;
+  for ( ; now_ms < 20000 && static_cast<int>( received.size() ) < COUNT; ++now_ms ) {
+    link.advance( 1ms );
+    // Best-effort telemetry on the same link
+    if ( now_ms % 10 == 0 && device.sendObject( CommStatus{ now_ms, 0.0f, 0.0f, 0.0f } ) == crosstalk::WriteResult::Success )
+      ++telemetry_sent;
+    while ( next_reliable < COUNT &&
+            sender.send( device, TestObjectSimple{ next_reliable, 1.0f }, now_ms ) == crosstalk::WriteResult::Success )
+      ++next_reliable;
+
+    host.processSerialData();
+    host.skip();
+    while ( host.hasObject() ) {
+      crosstalk::ReadResult result = host.getObjectId() == RELIABLE_ID ? receiver.receive( host ) : [&]() {
+        CommStatus status;
+        return host.readObject( status );
+      }();
+      if ( result == crosstalk::ReadResult::NotEnoughData )
+        break;
+      if ( result == crosstalk::ReadResult::Success && host.getObjectId() != RELIABLE_ID )
+        ++telemetry_received;
+      if ( result == crosstalk::ReadResult::ObjectIdMismatch && host.skipObject() == crosstalk::ReadResult::NotEnoughData )
+        break;
+      host.skip();
+    }
+    TestObjectSimple simple;
+    while ( receiver.readObject( simple ) == crosstalk::ReadResult::Success ) received.push_back( simple.id );
+
+    device.processSerialData();
+    device.skip();
+    while ( device.hasObject() ) {
+      crosstalk::ReadResult result = device.getObjectId() == ACK_ID ? sender.readAck( device, now_ms )
+                                                                     : device.skipObject();
+      if ( result == crosstalk::ReadResult::NotEnoughData )
+        break;
+      device.skip();
+    }
+    sender.poll( device, now_ms );
+  }
+  std::vector<int> expected( COUNT );
+  for ( int i = 0; i < COUNT; ++i ) expected[i] = i;
+  EXPECT_EQ( received, expected );
+  EXPECT_GT( link.counters().bytes_dropped, 0 );
+  EXPECT_GT( sender.statistics().retransmitted_frames, 0 );
+  EXPECT_GT( sender.smoothedRtt(), 0 );
+  // Telemetry kept flowing while reliable frames were retransmitted
+  EXPECT_GT( telemetry_received, telemetry_sent * 8 / 10 );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
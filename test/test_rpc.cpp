@@ -0,0 +1,227 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/rpc.hpp"
+#include "crosstalk/host/rpc_future.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_link_simulator.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+using Side = crosstalk::LinkSimulator::Side;
+
+struct ReadSensor {
+  uint8_t channel;
+};
+
+REFL_AUTO( type( ReadSensor, crosstalk::id( 20 ) ), field( channel ) )
+
+struct SensorReading {
+  uint8_t channel;
+  float value;
+};
+
+REFL_AUTO( type( SensorReading, crosstalk::id( 21 ) ), field( channel ), field( value ) )
+
+struct SetName {
+  std::string name;
+};
+
+REFL_AUTO( type( SetName, crosstalk::id( 22 ) ), field( name ) )
+
+struct NameReply {
+  std::string previous;
+};
+
+REFL_AUTO( type( NameReply, crosstalk::id( 23 ) ), field( previous ) )
+
+static std::string device_name = "device";
+
+SensorReading readSensor( const ReadSensor &request ) { return { request.channel, request.channel * 1.5f }; }
+
+NameReply setName( const SetName &request )
+{
+  NameReply reply{ device_name };
+  device_name = request.name;
+  return reply;
+}
+
+using Server = crosstalk::RpcServer<32, &readSensor, &setName>;
+static_assert( Server::hasHandler( crosstalk::object_id<ReadSensor>() ) );
+static_assert( !Server::hasHandler( crosstalk::object_id<TestObjectSimple>() ) );
+
+template<typename Crosstalker>
+void serve( Crosstalker &device, Server &server )
+{
+  device.processSerialData();
+  while ( device.hasObject() ) {
+    const crosstalk::ReadResult result = server.handle( device );
+    // Over the simulated link, frames may be incomplete
+    if ( result == crosstalk::ReadResult::NotEnoughData )
+      break;
+    ASSERT_EQ( result, crosstalk::ReadResult::Success );
+  }
+}
+
+template<typename Crosstalker, typename Client>
+void readResponses( Crosstalker &host, Client &client )
+{
+  host.processSerialData();
+  while ( host.hasObject() ) {
+    const crosstalk::ReadResult result = client.readResponse( host );
+    if ( result == crosstalk::ReadResult::NotEnoughData )
+      break;
+    ASSERT_EQ( result, crosstalk::ReadResult::Success );
+  }
+}
+
+TEST( RpcTest, callsInFlight )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<512> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<512> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  Server server;
+  crosstalk::RpcClient<4, 32> client;
+
+  std::vector<std::pair<crosstalk::RpcStatus, SensorReading>> readings;
+  auto on_reading = [&readings]( crosstalk::RpcStatus status, const SensorReading &reading ) {
+    readings.emplace_back( status, reading );
+  };
+  for ( uint8_t channel = 1; channel <= 3; ++channel )
+    ASSERT_EQ( ( client.call<ReadSensor, SensorReading>( host, ReadSensor{ channel }, 100, 0, on_reading ) ),
+               crosstalk::WriteResult::Success );
+  crosstalk::RpcStatus unknown_status = crosstalk::RpcStatus::Success;
+  ASSERT_EQ( ( client.call<TestObjectSimple, TestObjectSimple>(
+                 host, TestObjectSimple{ 1, 1.0f }, 100, 0,
+                 [&]( crosstalk::RpcStatus status, const TestObjectSimple & ) { unknown_status = status; } ) ),
+             crosstalk::WriteResult::Success );
+  EXPECT_EQ( client.pending(), 4 );
+  EXPECT_EQ( ( client.call<ReadSensor, SensorReading>( host, ReadSensor{ 4 }, 100, 0, on_reading ) ),
+             crosstalk::WriteResult::WindowFull );
+
+  serve( device, server );
+  readResponses( host, client );
+  EXPECT_EQ( client.pending(), 0 );
+  ASSERT_EQ( readings.size(), 3 );
+  for ( uint8_t i = 0; i < 3; ++i ) {
+    EXPECT_EQ( readings[i].first, crosstalk::RpcStatus::Success );
+    EXPECT_EQ( readings[i].second.channel, i + 1 );
+    EXPECT_EQ( readings[i].second.value, ( i + 1 ) * 1.5f );
+  }
+  EXPECT_EQ( unknown_status, crosstalk::RpcStatus::UnknownMethod );
+
+  // Callbacks can start new calls and responses of the wrong type are rejected
+  std::vector<std::string> names;
+  ASSERT_EQ( ( client.call<SetName, NameReply>( host, SetName{ "first" }, 100, 0,
+                                              [&]( crosstalk::RpcStatus status, const NameReply &reply ) {
+                                                EXPECT_EQ( status, crosstalk::RpcStatus::Success );
+                                                names.push_back( reply.previous );
+                                                client.call<SetName, NameReply>(
+                                                    host, SetName{ "second" }, 100, 0,
+                                                    [&names]( crosstalk::RpcStatus, const NameReply &reply ) {
+                                                      names.push_back( reply.previous );
+                                                    } );
+                                              } ) ),
+             crosstalk::WriteResult::Success );
+  crosstalk::RpcStatus mismatch_status = crosstalk::RpcStatus::Success;
+  client.call<SetName, SensorReading>(
+      host, SetName{ "third" }, 100, 0,
+      [&]( crosstalk::RpcStatus status, const SensorReading & ) { mismatch_status = status; } );
+  serve( device, server );
+  readResponses( host, client );
+  EXPECT_EQ( mismatch_status, crosstalk::RpcStatus::InvalidResponse );
+  serve( device, server );
+  readResponses( host, client );
+  EXPECT_EQ( names, ( std::vector<std::string>{ "device", "third" } ) );
+  EXPECT_EQ( device_name, "second" );
+  EXPECT_EQ( client.pending(), 0 );
+}
+
+TEST( RpcTest, timeout )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<512> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<512> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  Server server;
+  crosstalk::RpcClient<4, 32> client;
+  std::vector<crosstalk::RpcStatus> statuses;
+  auto on_reading = [&statuses]( crosstalk::RpcStatus status, const SensorReading & ) { statuses.push_back( status ); };
+  // The timer wraps around
+  client.call<ReadSensor, SensorReading>( host, ReadSensor{ 1 }, 50, 0xFFFFFFF0, on_reading );
+  client.call<ReadSensor, SensorReading>( host, ReadSensor{ 2 }, 100, 0xFFFFFFF0, on_reading );
+  EXPECT_EQ( client.poll( 0x21 ), 0 );
+  EXPECT_EQ( client.poll( 0x22 ), 1 );
+  EXPECT_EQ( statuses, std::vector<crosstalk::RpcStatus>{ crosstalk::RpcStatus::Timeout } );
+
+  // The late response is ignored, the other call completes
+  serve( device, server );
+  readResponses( host, client );
+  EXPECT_EQ( statuses,
+             ( std::vector<crosstalk::RpcStatus>{ crosstalk::RpcStatus::Timeout, crosstalk::RpcStatus::Success } ) );
+
+  client.call<ReadSensor, SensorReading>( host, ReadSensor{ 3 }, 100, 0, on_reading );
+  client.cancelAll();
+  EXPECT_EQ( statuses.back(), crosstalk::RpcStatus::Cancelled );
+  EXPECT_EQ( client.pending(), 0 );
+}
+
+TEST( RpcTest, futures )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<512> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<512> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  Server server;
+  crosstalk::RpcClient<2, 32> client;
+  auto first = crosstalk::callAsync<ReadSensor, SensorReading>( client, host, ReadSensor{ 7 }, 100, 0 );
+  auto second = crosstalk::callAsync<ReadSensor, SensorReading>( client, host, ReadSensor{ 8 }, 100, 0 );
+  auto rejected = crosstalk::callAsync<ReadSensor, SensorReading>( client, host, ReadSensor{ 9 }, 100, 0 );
+  ASSERT_EQ( rejected.wait_for( 0s ), std::future_status::ready );
+  EXPECT_EQ( rejected.get().status, crosstalk::RpcStatus::NotSent );
+  EXPECT_EQ( first.wait_for( 0s ), std::future_status::timeout );
+  serve( device, server );
+  readResponses( host, client );
+  ASSERT_EQ( second.wait_for( 0s ), std::future_status::ready );
+  crosstalk::RpcReply<SensorReading> reply = first.get();
+  EXPECT_EQ( reply.status, crosstalk::RpcStatus::Success );
+  EXPECT_EQ( reply.response.value, 10.5f );
+  EXPECT_EQ( second.get().response.channel, 8 );
+}
+
+TEST( RpcTest, overlappingRoundTrips )
+{
+  crosstalk::LinkSimulatorConfig config;
+  config.baud_rate = 2000000;
+  config.latency = 10ms;
+  crosstalk::LinkSimulator link( config );
+  crosstalk::CrossTalker<512> device( link.createEndpoint( Side::A ) );
+  crosstalk::CrossTalker<512> host( link.createEndpoint( Side::B ) );
+  Server server;
+  crosstalk::RpcClient<8, 32> client;
+  int completed = 0;
+  uint32_t now_ms = 0;
+  for ( uint8_t channel = 0; channel < 8; ++channel )
+    ASSERT_EQ( ( client.call<ReadSensor, SensorReading>( host, ReadSensor{ channel }, 100, now_ms,
+                                                       [&]( crosstalk::RpcStatus status, const SensorReading & ) {
+                                                         EXPECT_EQ( status, crosstalk::RpcStatus::Success );
+                                                         ++completed;
+                                                       } ) ),
+               crosstalk::WriteResult::Success );
+  while ( completed < 8 && now_ms < 100 ) {
+    link.advance( 1ms );
+    ++now_ms;
+    serve( device, server );
+    readResponses( host, client );
+    client.poll( now_ms );
+  }
+  EXPECT_EQ( completed, 8 );
+  // About one round trip of two latencies instead of eight consecutive round trips
+  EXPECT_LT( now_ms, 25 );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
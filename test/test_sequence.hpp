@@ -0,0 +1,55 @@
+//
+// Sequence of objects and text sent by the device in the end-to-end tests.
+// Used by the ESP32 test firmware and the host-side device thread in test_pty.
+//
+
+#ifndef SERIALLIBRARY_TEST_SEQUENCE_HPP
+#define SERIALLIBRARY_TEST_SEQUENCE_HPP
+
+inline TestWithClassVectorAndArray makeTestWithClassVectorAndArray()
+{
+  return TestWithClassVectorAndArray{
+      456,
+      { TestWithComplexVectorAndArray{
+            "uuid-456", { "nameA", "nameB" }, { std::vector<int>{ 10, 11 }, { 12, 13 }, { 14, 15 } } },
+        TestWithComplexVectorAndArray{
+            "uuid-789", { "nameC" }, { std::vector<int>{ 16, 17, 18 }, {} } } },
+      { TestObjectWithString{ 789, "Object1" }, TestObjectWithString{ 101112, "Object2" },
+        TestObjectWithString{ 131415, "Object3" } } };
+}
+
+template<typename CrossTalkerT, typename Msg, typename PrintFn, typename AfterSendFn>
+void sendTestObject( CrossTalkerT &crosstalker, const Msg &msg, PrintFn &print, AfterSendFn &after_send )
+{
+  auto result = crosstalker.sendObject( msg );
+  print( result == crosstalk::WriteResult::Success ? "SUCCESS" : "FAIL" );
+  after_send();
+}
+
+/*!
+ * @param print Called with the generic text that is sent between objects.
+ * @param after_send Called after each object, e.g., to pace the sequence.
+ */
+template<typename CrossTalkerT, typename PrintFn, typename AfterSendFn>
+void sendTestSequence( CrossTalkerT &crosstalker, PrintFn print, AfterSendFn after_send )
+{
+  print( "Test started!" );
+  sendTestObject( crosstalker, TestObjectSimple{ 42, 3.14f }, print, after_send );
+  sendTestObject( crosstalker, TestObjectWithString{ 123, "TestName" }, print, after_send );
+  sendTestObject( crosstalker,
+                  TestWithSimpleVectorAndArray{ 3.14159f, { 1, 2, 3 }, { 4.0, 5.0, 6.0 } }, print,
+                  after_send );
+  sendTestObject( crosstalker,
+                  TestWithComplexVectorAndArray{ "uuid-123",
+                                                 { "name1", "name2" },
+                                                 { std::vector<int>{ 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } } },
+                  print, after_send );
+  sendTestObject( crosstalker, makeTestWithClassVectorAndArray(), print, after_send );
+  sendTestObject( crosstalker,
+                  CommStatus{ 1378, -98.0f, -85.0f, 0.0f, CommQuality::NONE,
+                              CommQuality::MEDIUM_QUALITY, CommQuality::HIGH_QUALITY,
+                              CommState::DISCONNECTED, CommState::CONNECTED, CommState::CONNECTED },
+                  print, after_send );
+}
+
+#endif // SERIALLIBRARY_TEST_SEQUENCE_HPP
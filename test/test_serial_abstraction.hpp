@@ -0,0 +1,41 @@
+//
+// Serial abstraction that reads from and writes to byte vectors for unit tests.
+//
+
+#ifndef SERIALLIBRARY_TEST_SERIAL_ABSTRACTION_HPP
+#define SERIALLIBRARY_TEST_SERIAL_ABSTRACTION_HPP
+
+#include <cstring>
+#include <vector>
+
+class TestSerialAbstraction : public crosstalk::SerialAbstraction
+{
+public:
+  TestSerialAbstraction( std::vector<uint8_t> &send_buffer, std::vector<uint8_t> &receive_buffer )
+      : send_buffer( send_buffer ), receive_buffer( receive_buffer )
+  {
+  }
+
+  int available() const override { return receive_buffer.size(); }
+
+  int read( uint8_t *data, size_t length ) override
+  {
+    if ( receive_buffer.size() < length ) {
+      length = receive_buffer.size();
+    }
+    std::memcpy( data, receive_buffer.data(), length );
+    receive_buffer.erase( receive_buffer.begin(), receive_buffer.begin() + length );
+    return length;
+  }
+
+  bool write( const uint8_t *data, size_t length ) override
+  {
+    send_buffer.insert( send_buffer.end(), data, data + length );
+    return true; // Simulate successful write
+  }
+
+  std::vector<uint8_t> &send_buffer;
+  std::vector<uint8_t> &receive_buffer;
+};
+
+#endif // SERIALLIBRARY_TEST_SERIAL_ABSTRACTION_HPP
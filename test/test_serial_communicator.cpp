@@ -1,37 +1,11 @@
 #include "crosstalk/crosstalker.hpp"
+#include "crosstalk/log.hpp"
+#include "crosstalk/host/log_formatter.hpp"
 #include "test_objects.hpp"
+#include "test_log_formats.hpp"
+#include "test_serial_abstraction.hpp"
 #include "gtest/gtest.h"
 
-class TestSerialAbstraction : public crosstalk::SerialAbstraction
-{
-public:
-  TestSerialAbstraction( std::vector<uint8_t> &send_buffer, std::vector<uint8_t> &receive_buffer )
-      : send_buffer( send_buffer ), receive_buffer( receive_buffer )
-  {
-  }
-
-  int available() const override { return receive_buffer.size(); }
-
-  int read( uint8_t *data, size_t length ) override
-  {
-    if ( receive_buffer.size() < length ) {
-      length = receive_buffer.size();
-    }
-    std::memcpy( data, receive_buffer.data(), length );
-    receive_buffer.erase( receive_buffer.begin(), receive_buffer.begin() + length );
-    return length;
-  }
-
-  bool write( const uint8_t *data, size_t length ) override
-  {
-    send_buffer.insert( send_buffer.end(), data, data + length );
-    return true; // Simulate successful write
-  }
-
-  std::vector<uint8_t> &send_buffer;
-  std::vector<uint8_t> &receive_buffer;
-};
-
 TEST( SerialCommunicatorTest, serialization )
 {
   std::vector<uint8_t> device_buffer;
@@ -246,6 +220,17 @@ TEST( SerialCommunicatorTest, errors )
   result = comm2.readObject( wrong_object );
   ASSERT_EQ( result, crosstalk::ReadResult::ObjectIdMismatch );
 
+  // Corrupted size can never be satisfied and must not stall the receiver
+  comm2.clearBuffer();
+  host_buffer.clear();
+  ASSERT_EQ( comm1.sendObject( obj ), crosstalk::WriteResult::Success );
+  host_buffer[5] = 0xFF;
+  ASSERT_EQ( comm1.sendObject( obj ), crosstalk::WriteResult::Success );
+  comm2.processSerialData();
+  ASSERT_EQ( comm2.readObject( obj2 ), crosstalk::ReadResult::ObjectTooLarge );
+  comm2.skip();
+  ASSERT_EQ( comm2.readObject( obj2 ), crosstalk::ReadResult::Success );
+
   auto send_result = comm1.sendObject( TestWithClassVectorAndArray{
       456,
       { TestWithComplexVectorAndArray{
@@ -344,6 +329,508 @@ TEST( SerialCommunicatorTest, wrapping )
   for ( int i = 16; i < 32; ++i ) { EXPECT_EQ( data[i], static_cast<uint8_t>( i - 16 ) ); }
 }
 
+TEST( SerialCommunicatorTest, frames )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device(
+      std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  const uint8_t payload[] = { 1, 2, 3 };
+  ASSERT_EQ( device.sendFrame( -42, sizeof( payload ),
+                               [&payload]( uint8_t *data ) {
+                                 std::memcpy( data, payload, sizeof( payload ) );
+                               } ),
+             crosstalk::WriteResult::Success );
+  ASSERT_EQ( device.sendObject( TestObjectSimple{ 1, 2.0f } ), crosstalk::WriteResult::Success );
+  host.processSerialData();
+  EXPECT_EQ( host.getObjectId(), -42 );
+  int16_t received_id = 0;
+  std::vector<uint8_t> received;
+  auto handler = [&]( int16_t id, const uint8_t *data, size_t size ) {
+    received_id = id;
+    received.assign( data, data + size );
+    return size;
+  };
+  ASSERT_EQ( host.readFrame( handler ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( received_id, -42 );
+  EXPECT_EQ( received, std::vector<uint8_t>( payload, payload + sizeof( payload ) ) );
+  ASSERT_EQ( host.readFrame( handler ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( received_id, 1 );
+  EXPECT_EQ( received.size(), 8 );
+  EXPECT_EQ( host.readFrame( handler ), crosstalk::ReadResult::NoObjectAvailable );
+}
+
+TEST( SerialCommunicatorTest, deferredLogging )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device(
+      std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  auto table = crosstalk::LogStringTable::create<LogTestStarted, LogObjectResult, LogSensorReading>();
+  EXPECT_FALSE( table.add<LogTestStarted>() );
+  EXPECT_STREQ( table.formatString( 2 ), "{}: {}" );
+  // An empty buffer does not hold a log message
+  std::string message;
+  EXPECT_NE( host.getObjectId(), static_cast<int16_t>( crosstalk::InternalObjectId::Log ) );
+  EXPECT_EQ( crosstalk::readLog( host, table, message ), crosstalk::ReadResult::NoObjectAvailable );
+
+  ASSERT_EQ( crosstalk::sendLog<LogTestStarted>( device ), crosstalk::WriteResult::Success );
+  ASSERT_EQ( crosstalk::sendLog<LogObjectResult>( device, "TestObjectSimple", true ),
+             crosstalk::WriteResult::Success );
+  ASSERT_EQ( device.sendObject( TestObjectSimple{ 1, 2.0f } ), crosstalk::WriteResult::Success );
+  const size_t before_reading = host_buffer.size();
+  ASSERT_EQ( crosstalk::sendLog<LogSensorReading>( device, 3, 3.25f, -1500, CommState::ERROR ),
+             crosstalk::WriteResult::Success );
+  const size_t reading_size = host_buffer.size() - before_reading;
+
+  host.processSerialData();
+  ASSERT_EQ( crosstalk::readLog( host, table, message ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( message, "Test started!" );
+  ASSERT_EQ( crosstalk::readLog( host, table, message ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( message, "TestObjectSimple: true" );
+  EXPECT_EQ( crosstalk::readLog( host, table, message ), crosstalk::ReadResult::ObjectIdMismatch );
+  TestObjectSimple obj;
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  ASSERT_EQ( crosstalk::readLog( host, table, message ), crosstalk::ReadResult::Success );
+  const std::string expected = "Sensor 3 read 3.25 V after -1500 us in state 10";
+  EXPECT_EQ( message, expected );
+  // Id, 1 + 4 + 4 + 1 bytes of arguments and the frame overhead instead of the formatted text
+  EXPECT_EQ( reading_size, 8 + 2 + 10 );
+  EXPECT_LT( 2 * reading_size, expected.size() );
+
+  // A host table that does not match the firmware
+  ASSERT_EQ( crosstalk::sendLog<LogObjectResult>( device, "Unknown", false ),
+             crosstalk::WriteResult::Success );
+  host.processSerialData();
+  auto old_table = crosstalk::LogStringTable::create<LogTestStarted>();
+  EXPECT_EQ( crosstalk::readLog( host, old_table, message ), crosstalk::ReadResult::ObjectSizeMismatch );
+  EXPECT_EQ( message, "Unknown log format 2" );
+  EXPECT_FALSE( host.hasObject() );
+  EXPECT_NE( host.getObjectId(), static_cast<int16_t>( crosstalk::InternalObjectId::Log ) );
+}
+
+TEST( SerialCommunicatorTest, lines )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<32> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<32> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  std::vector<std::string> lines;
+  auto collect = [&lines]( const char *line, size_t length ) { lines.emplace_back( line, length ); };
+  auto write = [&host_buffer]( const std::string &text ) {
+    host_buffer.insert( host_buffer.end(), text.begin(), text.end() );
+  };
+
+  write( "hello\r\nworld\nincomp" );
+  host.processSerialData();
+  EXPECT_EQ( host.forEachLine( collect ), 2 );
+  EXPECT_EQ( lines, ( std::vector<std::string>{ "hello", "world" } ) );
+  EXPECT_EQ( host.available(), 6 );
+  write( "lete\n" );
+  host.processSerialData();
+  std::string line;
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, "incomplete" );
+  EXPECT_FALSE( host.readLine( line ) );
+
+  // A partial line in front of an object is continued after the object
+  write( "par" );
+  device.sendObject( TestObjectSimple{ 1, 2.0f } );
+  write( "tial\n" );
+  host.processSerialData();
+  EXPECT_EQ( host.forEachLine( collect ), 0 );
+  TestObjectSimple obj;
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, "partial" );
+
+  // Lines wrapping around the end of the ring buffer
+  write( std::string( 12, 'x' ) + "\n" + "wrapping line\n" );
+  host.processSerialData();
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, std::string( 12, 'x' ) );
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, "wrapping line" );
+
+  // A full buffer without a line ending is passed as a line of BUFFER_SIZE bytes
+  write( std::string( 40, 'a' ) + "\n" );
+  host.processSerialData( false );
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, std::string( 32, 'a' ) );
+  EXPECT_FALSE( host.readLine( line ) );
+  host.processSerialData( false );
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, std::string( 8, 'a' ) );
+  EXPECT_EQ( host.available(), 0 );
+}
+
+TEST( SerialCommunicatorTest, peekGeneric )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<32> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<32> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  crosstalk::GenericData data = host.peekGeneric();
+  EXPECT_EQ( data.size(), 0 );
+
+  for ( int i = 0; i < 30; ++i ) host_buffer.push_back( static_cast<uint8_t>( i ) );
+  device.sendObject( TestObjectSimple{ 1, 2.0f } );
+  host.processSerialData();
+  data = host.peekGeneric();
+  ASSERT_EQ( data.first.size, 30 );
+  EXPECT_EQ( data.second.size, 0 );
+  EXPECT_EQ( data.first.data[29], 29 );
+  EXPECT_EQ( host.consumeGeneric( 20 ), 20 );
+  // Does not consume the object
+  EXPECT_EQ( host.consumeGeneric( 20 ), 10 );
+  host.processSerialData();
+  TestObjectSimple obj;
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+
+  // Data wrapping around the end of the buffer is returned as two spans
+  for ( int i = 0; i < 40; ++i ) host_buffer.push_back( static_cast<uint8_t>( 100 + i ) );
+  host.processSerialData( false );
+  EXPECT_EQ( host.consumeGeneric( 16 ), 16 );
+  host.processSerialData( false );
+  data = host.peekGeneric();
+  ASSERT_EQ( data.size(), 24 );
+  ASSERT_EQ( data.first.size, 16 );
+  ASSERT_EQ( data.second.size, 8 );
+  EXPECT_EQ( data.first.data[0], 116 );
+  EXPECT_EQ( data.second.data[0], 132 );
+  EXPECT_EQ( data.second.data[7], 139 );
+  EXPECT_EQ( host.consumeGeneric( 24 ), 24 );
+  EXPECT_EQ( host.peekGeneric().size(), 0 );
+}
+
+TEST( SerialCommunicatorTest, demultiplexing )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<64> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<64, 32, 48> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  auto write = [&host_buffer]( const std::string &text ) {
+    host_buffer.insert( host_buffer.end(), text.begin(), text.end() );
+  };
+  TestObjectSimple obj;
+  std::string line;
+
+  // Unread text does not block objects
+  write( "first line\n" );
+  device.sendObject( TestObjectSimple{ 1, 1.0f } );
+  write( "second" );
+  device.sendObject( TestObjectSimple{ 2, 2.0f } );
+  write( " line\n" );
+  host.processSerialData();
+  EXPECT_EQ( host.available(), 23 );
+  ASSERT_TRUE( host.hasObject() );
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 1 );
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 2 );
+  EXPECT_FALSE( host.hasObject() );
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, "first line" );
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, "second line" );
+  EXPECT_EQ( host.available(), 0 );
+
+  // Unread objects do not stall text. The oldest objects are dropped as a whole.
+  for ( int i = 0; i < 10; ++i ) {
+    device.sendObject( TestObjectSimple{ 10 + i, 0.5f } );
+    write( "line " + std::to_string( i ) + "\n" );
+    host.processSerialData();
+    ASSERT_TRUE( host.readLine( line ) );
+    EXPECT_EQ( line, "line " + std::to_string( i ) );
+  }
+  int count = 0;
+  while ( host.hasObject() ) {
+    ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( obj.id, 10 + 10 - 64 / 16 + count );
+    ++count;
+  }
+  EXPECT_EQ( count, 64 / 16 );
+
+  // Text is dropped from the front if it is not read
+  write( std::string( 40, 'a' ) + "\n" + std::string( 20, 'b' ) );
+  device.sendObject( TestObjectSimple{ 3, 3.0f } );
+  host.processSerialData();
+  EXPECT_EQ( host.available(), 48 );
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 3 );
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, std::string( 27, 'a' ) );
+  host.clearBuffer();
+
+  // A marker followed by an impossible size and a marker split between reads are text
+  const uint8_t fake_header[] = { 0x02, 0x42, 0x01, 0x00, 0xFF, 0x7F, 'x', '\n', 0x02 };
+  host_buffer.insert( host_buffer.end(), fake_header, fake_header + sizeof( fake_header ) );
+  host.processSerialData();
+  EXPECT_FALSE( host.hasObject() );
+  EXPECT_EQ( host.available(), 8 );
+  write( "y\n" );
+  host.processSerialData();
+  EXPECT_EQ( host.available(), 11 );
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line.size(), 7 );
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, "\x02y" );
+
+  // Lossless processing only reads what fits into both buffers
+  host.clearBuffer();
+  for ( int i = 0; i < 8; ++i ) device.sendObject( TestObjectSimple{ 100 + i, 1.0f } );
+  host.processSerialData( false );
+  for ( int i = 0; i < 8; ++i ) {
+    ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( obj.id, 100 + i );
+    host.processSerialData( false );
+  }
+  EXPECT_FALSE( host.hasObject() );
+}
+
+TEST( SerialCommunicatorTest, overflowPolicies )
+{
+  struct Case {
+    crosstalk::OverflowPolicy policy;
+    std::vector<int> ids;
+    uint32_t dropped_bytes;
+    uint32_t dropped_frames;
+  };
+  // 5 bytes text, objects 1, 2, 1 and 3 bytes text fill 56 of 64 bytes. Object 3 then needs 8 bytes.
+  const std::vector<Case> cases = {
+      { crosstalk::OverflowPolicy::DropOldestBytes, { 2, 1, 3 }, 8, 0 },
+      { crosstalk::OverflowPolicy::DropGenericFirst, { 1, 2, 1, 3 }, 8, 0 },
+      { crosstalk::OverflowPolicy::DropOldestFrames, { 2, 1, 3 }, 5, 1 },
+      { crosstalk::OverflowPolicy::KeepNewestPerId, { 2, 1, 3 }, 0, 1 },
+  };
+  for ( const auto &test_case : cases ) {
+    SCOPED_TRACE( crosstalk::to_string( test_case.policy ) );
+    std::vector<uint8_t> device_buffer;
+    std::vector<uint8_t> host_buffer;
+    crosstalk::CrossTalker<64> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+    crosstalk::CrossTalker<64> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+    host.setOverflowPolicy( test_case.policy );
+    host_buffer.insert( host_buffer.end(), { '0', '1', '2', '3', '4' } );
+    device.sendObject( TestObjectSimple{ 1, 1.0f } );
+    device.sendObject( TestObjectSimple{ 2, 1.0f } );
+    device.sendObject( TestObjectSimple{ 1, 2.0f } );
+    host_buffer.insert( host_buffer.end(), { 'a', 'b', 'c' } );
+    host.processSerialData();
+    ASSERT_EQ( host.statistics().dropped_bytes, 0 );
+    device.sendObject( TestObjectSimple{ 3, 1.0f } );
+    host.processSerialData();
+    EXPECT_EQ( host.statistics().dropped_bytes, test_case.dropped_bytes );
+    EXPECT_EQ( host.statistics().dropped_frames, test_case.dropped_frames );
+
+    std::vector<int> ids;
+    int crc_errors = 0;
+    while ( host.available() > 0 || host.hasObject() ) {
+      host.skip();
+      TestObjectSimple obj;
+      crosstalk::ReadResult result = host.readObject( obj );
+      if ( result == crosstalk::ReadResult::Success )
+        ids.push_back( obj.id );
+      else if ( result == crosstalk::ReadResult::CrcError )
+        ++crc_errors;
+    }
+    EXPECT_EQ( ids, test_case.ids );
+    EXPECT_EQ( crc_errors, 0 );
+    host.resetStatistics();
+    EXPECT_EQ( host.statistics().dropped_bytes, 0 );
+  }
+
+  // The frame queue of the demultiplexing mode uses the policy as well
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<64> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<64, 32, 32> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  host.setOverflowPolicy( crosstalk::OverflowPolicy::KeepNewestPerId );
+  for ( int id : { 1, 2, 1, 2, 3 } ) device.sendObject( TestObjectSimple{ id, 1.0f } );
+  host.processSerialData();
+  std::vector<int> ids;
+  TestObjectSimple obj;
+  while ( host.readObject( obj ) == crosstalk::ReadResult::Success ) ids.push_back( obj.id );
+  EXPECT_EQ( ids, ( std::vector<int>{ 2, 1, 2, 3 } ) );
+  EXPECT_EQ( host.statistics().dropped_frames, 1 );
+}
+
+TEST( SerialCommunicatorTest, extractObjects )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<128> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<128> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  auto write = [&host_buffer]( const std::string &text ) {
+    host_buffer.insert( host_buffer.end(), text.begin(), text.end() );
+  };
+  // A marker in the text followed by a size that covers the start of the next frame
+  const uint8_t fake_header[] = { 0x02, 0x42, 0x01, 0x00, 0x02, 0x00 };
+  write( "abc" );
+  host_buffer.insert( host_buffer.end(), fake_header, fake_header + sizeof( fake_header ) );
+  device.sendObject( TestObjectSimple{ 1, 1.0f } );
+  write( "def" );
+  device.sendObject( TestObjectWithString{ 2, "two" } );
+  write( "ghi" );
+  device.sendObject( TestObjectSimple{ 3, 3.0f } );
+  host.processSerialData();
+  ASSERT_FALSE( host.hasObject() );
+
+  TestObjectWithString with_string;
+  ASSERT_EQ( host.extractObject( with_string ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( with_string.uuid, 2 );
+  EXPECT_EQ( with_string.name, "two" );
+  EXPECT_EQ( host.extractObject( with_string ), crosstalk::ReadResult::NoObjectAvailable );
+  std::vector<int16_t> ids;
+  auto handler = [&ids]( int16_t id, const uint8_t *, size_t size ) {
+    ids.push_back( id );
+    return size;
+  };
+  ASSERT_EQ( host.extractFrame( handler ), crosstalk::ReadResult::Success );
+  TestObjectSimple obj;
+  ASSERT_EQ( host.extractObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 3 );
+  EXPECT_EQ( ids, std::vector<int16_t>{ 1 } );
+  EXPECT_EQ( host.extractFrame( handler ), crosstalk::ReadResult::NoObjectAvailable );
+
+  // The generic data is untouched
+  std::vector<uint8_t> data( host.available() );
+  ASSERT_EQ( data.size(), 3 );
+  host.read( data.data(), data.size() );
+  EXPECT_EQ( std::string( data.begin(), data.end() ), "abc" );
+  // The fake frame now covers the fake header and "defg"
+  ASSERT_TRUE( host.hasObject() );
+  EXPECT_EQ( host.readObject( obj ), crosstalk::ReadResult::CrcError );
+  data.resize( host.available() );
+  ASSERT_EQ( data.size(), 2 );
+  host.read( data.data(), data.size() );
+  EXPECT_EQ( std::string( data.begin(), data.end() ), "hi" );
+  EXPECT_FALSE( host.hasObject() );
+}
+
+TEST( SerialCommunicatorTest, catchUp )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<128> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<128> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  for ( int i = 0; i < 10; ++i ) {
+    device.sendObject( CommStatus{ uint64_t( i ), 0.0f, 0.0f, 0.0f } );
+    if ( i == 2 )
+      host_buffer.insert( host_buffer.end(), { 'l', 'o', 'g', '\n' } );
+    if ( i == 5 )
+      device.sendObject( TestObjectWithString{ 5, "keep" } );
+  }
+  // Below the threshold nothing is skipped
+  EXPECT_EQ( host.catchUp<CommStatus>( 1000 ), 0 );
+  EXPECT_EQ( host.catchUp<CommStatus>(), 9 );
+  EXPECT_EQ( host.statistics().skipped_frames, 9 );
+  EXPECT_TRUE( host_buffer.empty() );
+
+  std::string line;
+  ASSERT_TRUE( host.readLine( line ) );
+  EXPECT_EQ( line, "log" );
+  TestObjectWithString with_string;
+  ASSERT_EQ( host.readObject( with_string ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( with_string.name, "keep" );
+  CommStatus status;
+  ASSERT_EQ( host.readObject( status ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( status.last_received_message_age_ms, 9 );
+  EXPECT_FALSE( host.hasObject() );
+  EXPECT_EQ( host.available(), 0 );
+
+  // Non-conflatable frames are kept even if they fill the buffer
+  for ( int i = 0; i < 20; ++i ) device.sendObject( TestObjectSimple{ i, 0.0f } );
+  EXPECT_EQ( host.catchUp<CommStatus>(), 0 );
+  TestObjectSimple obj;
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 0 );
+}
+
+TEST( SerialCommunicatorTest, sequenceNumbers )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<512> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<512> host( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  device.setSequenceNumbers( crosstalk::SequenceNumbers::OneByte );
+  std::vector<std::vector<uint8_t>> frames;
+  for ( int i = 0; i < 7; ++i ) {
+    device.sendObject( TestObjectSimple{ i, 0.0f } );
+    frames.push_back( host_buffer );
+    host_buffer.clear();
+  }
+  EXPECT_EQ( frames[0].size(), 17 );
+  // Frame 2 is lost, 5 and 6 are swapped and there is a frame without a counter in between
+  for ( int i : { 0, 1, 3, 4, 6, 5 } ) {
+    host_buffer.insert( host_buffer.end(), frames[i].begin(), frames[i].end() );
+    if ( i == 1 ) {
+      device.setSequenceNumbers( crosstalk::SequenceNumbers::None );
+      device.sendObject( CommStatus{} );
+      device.setSequenceNumbers( crosstalk::SequenceNumbers::OneByte );
+    }
+  }
+  host.processSerialData();
+  TestObjectSimple obj;
+  std::vector<uint16_t> lost;
+  std::vector<bool> reordered;
+  while ( host.hasObject() ) {
+    if ( host.getObjectId() != crosstalk::object_id<TestObjectSimple>() ) {
+      CommStatus status;
+      ASSERT_EQ( host.readObject( status ), crosstalk::ReadResult::Success );
+      EXPECT_FALSE( host.lastSequence().valid );
+      continue;
+    }
+    ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+    ASSERT_TRUE( host.lastSequence().valid );
+    EXPECT_EQ( host.lastSequence().sequence, obj.id );
+    lost.push_back( host.lastSequence().lost_frames );
+    reordered.push_back( host.lastSequence().reordered );
+  }
+  EXPECT_EQ( lost, ( std::vector<uint16_t>{ 0, 0, 1, 0, 1, 0 } ) );
+  EXPECT_EQ( reordered, ( std::vector<bool>{ false, false, false, false, false, true } ) );
+  EXPECT_EQ( host.statistics().lost_frames, 2 );
+  EXPECT_EQ( host.statistics().reordered_frames, 1 );
+
+  // Skipped frames are not lost and the one byte counter wraps around
+  host.resetStatistics();
+  for ( int i = 7; i < 300; ++i ) {
+    device.sendObject( TestObjectSimple{ i, 0.0f } );
+    host.processSerialData();
+    ASSERT_EQ( i % 3 == 0 ? host.skipObject() : host.readObject( obj ), crosstalk::ReadResult::Success );
+  }
+  EXPECT_EQ( host.statistics().lost_frames, 0 );
+  EXPECT_EQ( host.statistics().reordered_frames, 0 );
+  EXPECT_EQ( host.lastSequence().sequence, 299 % 256 );
+
+  // Two byte counters, also with extractObject and frames of several ids.
+  // Changing the counter size resynchronizes the receiver without reporting a gap.
+  device.setSequenceNumbers( crosstalk::SequenceNumbers::TwoBytes );
+  TestObjectWithString with_string;
+  device.sendObject( TestObjectWithString{ 0, "zero" } );
+  host.processSerialData();
+  ASSERT_EQ( host.readObject( with_string ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( host.lastSequence().sequence, 0 );
+  device.sendObject( TestObjectWithString{ 1, "lost" } );
+  device.sendObject( TestObjectWithString{ 2, "lost" } );
+  host_buffer.clear();
+  host_buffer.insert( host_buffer.end(), { 'h', 'i' } );
+  device.sendObject( TestObjectSimple{ 300, 0.0f } );
+  device.sendObject( TestObjectWithString{ 3, "third" } );
+  host.processSerialData();
+  ASSERT_EQ( host.extractObject( with_string ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( with_string.name, "third" );
+  EXPECT_EQ( host.lastSequence().sequence, 3 );
+  EXPECT_EQ( host.lastSequence().lost_frames, 2 );
+  ASSERT_EQ( host.extractObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 300 );
+  EXPECT_EQ( host.lastSequence().sequence, 300 );
+  EXPECT_EQ( host.lastSequence().lost_frames, 0 );
+  EXPECT_EQ( host.statistics().lost_frames, 2 );
+  EXPECT_EQ( host.available(), 2 );
+}
+
 int main( int argc, char **argv )
 {
   ::testing::InitGoogleTest( &argc, argv );
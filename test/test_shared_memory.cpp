@@ -0,0 +1,224 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/host/shared_memory.hpp"
+#include "test_objects.hpp"
+#include "test_serial_abstraction.hpp"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <sys/wait.h>
+
+static std::string ringName( const char *test )
+{
+  return "/crosstalk_test_" + std::string( test ) + "_" + std::to_string( getpid() );
+}
+
+TEST( SharedMemoryTest, fanOut )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> port_owner( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  const std::string name = ringName( "fanOut" );
+  crosstalk::SharedFrameBroker broker( name );
+  ASSERT_TRUE( broker.isOpen() );
+
+  crosstalk::SharedFrameReader direct( name );
+  ASSERT_TRUE( direct.isAttached() );
+  crosstalk::CrossTalker<256> stream( std::make_unique<crosstalk::SharedMemorySerialWrapper>( name ) );
+  EXPECT_EQ( broker.readerCount(), 2 );
+
+  // The other process attaches before the frames are sent and reports the number of valid objects
+  int ready[2];
+  ASSERT_EQ( pipe( ready ), 0 );
+  pid_t child = fork();
+  if ( child == 0 ) {
+    crosstalk::SharedFrameReader reader( name );
+    char attached = reader.isAttached() ? 1 : 0;
+    if ( write( ready[1], &attached, 1 ) != 1 )
+      _exit( 100 );
+    int received = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 5 );
+    while ( received < 10 && std::chrono::steady_clock::now() < deadline ) {
+      TestObjectSimple obj;
+      if ( reader.readObject( obj ) != crosstalk::ReadResult::Success )
+        continue;
+      if ( obj.id != received || obj.value != received * 0.5f )
+        _exit( 101 );
+      ++received;
+    }
+    reader.detach();
+    _exit( received );
+  }
+  char attached = 0;
+  ASSERT_EQ( read( ready[0], &attached, 1 ), 1 );
+  ASSERT_EQ( attached, 1 );
+  EXPECT_EQ( broker.readerCount(), 3 );
+
+  const std::string text = "text is not forwarded ";
+  host_buffer.insert( host_buffer.end(), text.begin(), text.end() );
+  for ( int i = 0; i < 10; ++i ) device.sendObject( TestObjectSimple{ i, i * 0.5f } );
+  device.sendObject( TestObjectWithString{ 5, "other type" } );
+  port_owner.processSerialData();
+  while ( port_owner.available() > 0 || port_owner.hasObject() ) {
+    if ( !port_owner.hasObject() ) {
+      port_owner.skip( port_owner.available() );
+      continue;
+    }
+    ASSERT_EQ( broker.forward( port_owner ), crosstalk::ReadResult::Success );
+  }
+  EXPECT_EQ( broker.frameCount(), 11 );
+
+  for ( int i = 0; i < 10; ++i ) {
+    TestObjectSimple obj;
+    ASSERT_EQ( direct.readObject( obj ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( obj.id, i );
+  }
+  TestObjectSimple simple;
+  EXPECT_EQ( direct.readObject( simple ), crosstalk::ReadResult::ObjectIdMismatch );
+  TestObjectWithString with_string;
+  ASSERT_EQ( direct.readObject( with_string ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( with_string.name, "other type" );
+  EXPECT_FALSE( direct.hasObject() );
+
+  stream.processSerialData();
+  EXPECT_EQ( stream.available(), 0 );
+  for ( int i = 0; i < 10; ++i ) {
+    ASSERT_EQ( stream.readObject( simple ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( simple.id, i );
+  }
+  EXPECT_EQ( stream.skipObject(), crosstalk::ReadResult::Success );
+  EXPECT_EQ( stream.sendObject( simple ), crosstalk::WriteResult::WriteError );
+
+  int status = 0;
+  ASSERT_EQ( waitpid( child, &status, 0 ), child );
+  ASSERT_TRUE( WIFEXITED( status ) );
+  EXPECT_EQ( WEXITSTATUS( status ), 10 );
+  EXPECT_EQ( broker.readerCount(), 2 );
+  close( ready[0] );
+  close( ready[1] );
+
+  broker.close();
+  EXPECT_TRUE( direct.isClosed() );
+  EXPECT_FALSE( crosstalk::SharedFrameReader( name ).isAttached() );
+}
+
+TEST( SharedMemoryTest, slowReader )
+{
+  const std::string name = ringName( "slowReader" );
+  crosstalk::SharedFrameRingOptions options;
+  options.capacity = 1;
+  options.max_readers = 1;
+  crosstalk::SharedFrameBroker broker( name, options );
+  ASSERT_TRUE( broker.isOpen() );
+  const size_t capacity = broker.capacity();
+  EXPECT_EQ( capacity, static_cast<size_t>( sysconf( _SC_PAGESIZE ) ) );
+
+  crosstalk::SharedFrameReader reader( name );
+  ASSERT_TRUE( reader.isAttached() );
+  EXPECT_FALSE( crosstalk::SharedFrameReader( name ).isAttached() ) << "Only one reader slot";
+
+  // Raw frames are validated before they are written
+  std::vector<uint8_t> frame = { 0x02, 0x42, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 };
+  EXPECT_FALSE( broker.publishFrame( frame.data(), frame.size() ) );
+  const uint16_t crc = crosstalk::hosttole16( crosstalk::util::compute_crc16( frame.data(), 6 ) );
+  std::memcpy( &frame[6], &crc, 2 );
+  EXPECT_TRUE( broker.publishFrame( frame.data(), frame.size() ) );
+  EXPECT_TRUE( reader.skipObject() == crosstalk::ReadResult::Success );
+
+  // Frames wrapping around the end of the ring are contiguous for readers
+  std::vector<uint8_t> payload( 1000 );
+  int written = 0;
+  for ( ; written < 3; ++written ) {
+    payload.assign( payload.size(), static_cast<uint8_t>( written ) );
+    ASSERT_TRUE( broker.publish( 7, payload.data(), payload.size() ) );
+  }
+  EXPECT_EQ( broker.maxReaderLag(), 3 * 1008 );
+  for ( int i = 0; i < 3; ++i ) {
+    ASSERT_EQ( reader.readFrame( [i]( int16_t id, const uint8_t *data, size_t size ) -> size_t {
+      EXPECT_EQ( id, 7 );
+      EXPECT_EQ( data[0], i );
+      EXPECT_EQ( data[size - 1], i );
+      return size;
+    } ),
+               crosstalk::ReadResult::Success );
+  }
+
+  // A reader that falls behind by more than the capacity continues at the newest frame
+  for ( ; written < 10; ++written ) {
+    payload.assign( payload.size(), static_cast<uint8_t>( written ) );
+    ASSERT_TRUE( broker.publish( 7, payload.data(), payload.size() ) );
+  }
+  EXPECT_GT( broker.maxReaderLag(), capacity );
+  EXPECT_EQ( reader.skipObject(), crosstalk::ReadResult::CrcError );
+  EXPECT_EQ( reader.droppedBytes(), 7 * 1008 );
+  EXPECT_FALSE( reader.hasObject() );
+  payload.assign( payload.size(), 42 );
+  ASSERT_TRUE( broker.publish( 7, payload.data(), payload.size() ) );
+  std::vector<uint8_t> copy( 2000 );
+  ASSERT_EQ( reader.read( copy.data(), copy.size() ), 1008 );
+  EXPECT_EQ( copy[6], 42 );
+  EXPECT_FALSE( broker.publish( 7, copy.data(), capacity ) ) << "Frames larger than the ring";
+}
+
+TEST( SharedMemoryTest, sequenceNumbers )
+{
+  std::vector<uint8_t> device_buffer;
+  std::vector<uint8_t> host_buffer;
+  crosstalk::CrossTalker<256> device( std::make_unique<TestSerialAbstraction>( host_buffer, device_buffer ) );
+  crosstalk::CrossTalker<256> port_owner( std::make_unique<TestSerialAbstraction>( device_buffer, host_buffer ) );
+  const std::string name = ringName( "sequenceNumbers" );
+  crosstalk::SharedFrameBroker broker( name );
+  ASSERT_TRUE( broker.isOpen() );
+  crosstalk::SharedFrameReader reader( name );
+  crosstalk::CrossTalker<256> stream( std::make_unique<crosstalk::SharedMemorySerialWrapper>( name ) );
+
+  device.setSequenceNumbers( crosstalk::SequenceNumbers::TwoBytes );
+  for ( int i = 0; i < 4; ++i ) {
+    device.sendObject( TestObjectSimple{ i, 1.0f } );
+    // Frame 2 is lost
+    if ( i == 2 )
+      host_buffer.clear();
+    port_owner.processSerialData();
+    while ( port_owner.hasObject() ) ASSERT_EQ( broker.forward( port_owner ), crosstalk::ReadResult::Success );
+  }
+  device.setSequenceNumbers( crosstalk::SequenceNumbers::OneByte );
+  const TestObjectWithString one_byte{ 1, "one byte counter" };
+  device.sendObject( one_byte );
+  // Raw frames with a counter are accepted as they are
+  std::vector<uint8_t> raw = host_buffer;
+  ASSERT_EQ( raw.size(), 8 + crosstalk::util::compute_size( one_byte ) + 1 );
+  port_owner.processSerialData();
+  ASSERT_EQ( broker.forward( port_owner ), crosstalk::ReadResult::Success );
+  EXPECT_TRUE( broker.publishFrame( raw.data(), raw.size() ) );
+  raw.pop_back();
+  EXPECT_FALSE( broker.publishFrame( raw.data(), raw.size() ) );
+
+  // The frames keep their counters, so readers on the stream still detect the lost frame
+  TestObjectSimple obj;
+  for ( int i : { 0, 1, 3 } ) {
+    ASSERT_EQ( reader.readObject( obj ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( obj.id, i );
+  }
+  TestObjectWithString with_string;
+  for ( int i = 0; i < 2; ++i ) {
+    ASSERT_EQ( reader.readObject( with_string ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( with_string.name, "one byte counter" );
+  }
+  EXPECT_FALSE( reader.hasObject() );
+
+  stream.processSerialData();
+  for ( int i : { 0, 1, 3 } ) {
+    ASSERT_EQ( stream.readObject( obj ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( obj.id, i );
+    EXPECT_EQ( stream.lastSequence().sequence, i );
+    EXPECT_EQ( stream.lastSequence().sequence_bytes, 2 );
+  }
+  EXPECT_EQ( stream.statistics().lost_frames, 1 );
+  ASSERT_EQ( stream.readObject( with_string ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( stream.lastSequence().sequence_bytes, 1 );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
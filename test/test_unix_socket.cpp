@@ -0,0 +1,124 @@
+#include "crosstalk/crosstalker.hpp"
+#include "crosstalk/serial_abstractions/crosstalk_unix_socket_serial_wrapper.hpp"
+#include "test_objects.hpp"
+#include "test_sequence.hpp"
+#include "verify_test_sequence.hpp"
+#include <thread>
+
+TEST( UnixSocketTest, streamMode )
+{
+  const std::string path = "/tmp/crosstalk_test_" + std::to_string( getpid() ) + ".sock";
+  crosstalk::UnixSocketServer server( path );
+  ASSERT_TRUE( server.isOpen() );
+  std::thread device( [&server]() {
+    std::unique_ptr<crosstalk::UnixSocketSerialWrapper> connection = server.accept( 5000 );
+    ASSERT_NE( connection, nullptr );
+    EXPECT_FALSE( connection->isPacketTransport() );
+    const int fd = connection->fd();
+    crosstalk::CrossTalker<512, 256> crosstalker( std::move( connection ) );
+    sendTestSequence(
+        crosstalker, [fd]( const char *text ) { ASSERT_GT( ::write( fd, text, strlen( text ) ), 0 ); },
+        []() { std::this_thread::sleep_for( 20ms ); } );
+  } );
+  crosstalk::CrossTalker<256, 256> comm(
+      crosstalk::UnixSocketSerialWrapper::connect( path, crosstalk::UnixSocketMode::Stream ) );
+  verifyTestSequence( comm );
+  device.join();
+}
+
+TEST( UnixSocketTest, packetMode )
+{
+  std::unique_ptr<crosstalk::UnixSocketSerialWrapper> device_socket, host_socket;
+  ASSERT_TRUE( crosstalk::UnixSocketSerialWrapper::pair( crosstalk::UnixSocketMode::Packet, device_socket,
+                                                         host_socket ) );
+  ASSERT_TRUE( host_socket->isPacketTransport() );
+  crosstalk::UnixSocketSerialWrapper &raw = *device_socket;
+  crosstalk::CrossTalker<128, 64> device( std::move( device_socket ) );
+  crosstalk::CrossTalker<128, 64> host( std::move( host_socket ) );
+
+  // Packets contain frames without start markers, the CRC still covers the marker
+  std::vector<uint8_t> frame = { 0x02, 0x42, 0x01, 0x00, 0x08, 0x00, 1, 0, 0, 0, 0, 0, 0x80, 0x3F };
+  const uint16_t crc = crosstalk::hosttole16( crosstalk::util::compute_crc16( frame.data(), frame.size() ) );
+  frame.resize( frame.size() + 2 );
+  std::memcpy( &frame[14], &crc, 2 );
+  frame.erase( frame.begin(), frame.begin() + 2 );
+  ASSERT_TRUE( raw.sendPacket( frame.data(), frame.size() ) );
+  // Packets that can not be split into frames are dropped without affecting the frames around them
+  ASSERT_TRUE( raw.sendPacket( reinterpret_cast<const uint8_t *>( "text" ), 4 ) );
+  ASSERT_TRUE( raw.sendPacket( frame.data(), frame.size() - 1 ) );
+  std::vector<uint8_t> large( 40, 0x42 );
+  ASSERT_TRUE( raw.sendPacket( large.data(), large.size() ) );
+  std::vector<uint8_t> corrupted = frame;
+  corrupted[4] = 2;
+  ASSERT_TRUE( raw.sendPacket( corrupted.data(), corrupted.size() ) );
+  ASSERT_EQ( device.sendObject( TestObjectSimple{ 2, 2.0f } ), crosstalk::WriteResult::Success );
+
+  host.processSerialData( false );
+  EXPECT_EQ( host.statistics().dropped_frames, 3 );
+  EXPECT_EQ( host.available(), 0 );
+  TestObjectSimple obj;
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 1 );
+  EXPECT_EQ( obj.value, 1.0f );
+  EXPECT_EQ( host.readObject( obj ), crosstalk::ReadResult::CrcError );
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 2 );
+  EXPECT_FALSE( host.hasObject() );
+
+  // Without overwriting, packets that do not fit stay in the socket
+  for ( int i = 0; i < 10; ++i ) device.sendObject( TestObjectSimple{ i, 0.5f } );
+  host.processSerialData( false );
+  for ( int i = 0; i < 10; ++i ) {
+    if ( !host.hasObject() )
+      host.processSerialData( false );
+    ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( obj.id, i );
+  }
+  EXPECT_EQ( host.statistics().dropped_frames, 3 );
+
+  // When overwriting, whole frames are dropped even with the DropOldestBytes policy
+  for ( int i = 0; i < 10; ++i ) device.sendObject( TestObjectSimple{ i, 0.5f } );
+  host.processSerialData();
+  host.processSerialData();
+  EXPECT_EQ( host.statistics().dropped_frames, 5 );
+  for ( int i = 2; i < 10; ++i ) {
+    if ( !host.hasObject() )
+      host.processSerialData();
+    ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+    EXPECT_EQ( obj.id, i );
+  }
+}
+
+TEST( UnixSocketTest, emptyPacket )
+{
+  std::unique_ptr<crosstalk::UnixSocketSerialWrapper> device_socket, host_socket;
+  ASSERT_TRUE( crosstalk::UnixSocketSerialWrapper::pair( crosstalk::UnixSocketMode::Packet, device_socket,
+                                                         host_socket ) );
+  crosstalk::UnixSocketSerialWrapper &raw = *device_socket;
+  crosstalk::CrossTalker<128, 64> device( std::move( device_socket ) );
+  crosstalk::CrossTalker<128, 64> host( std::move( host_socket ) );
+
+  // An empty packet must not block the packets queued behind it
+  ASSERT_EQ( send( raw.fd(), "", 0, 0 ), 0 );
+  ASSERT_EQ( device.sendObject( TestObjectSimple{ 1, 1.0f } ), crosstalk::WriteResult::Success );
+  host.processSerialData();
+  TestObjectSimple obj;
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 1 );
+
+  // Also after the peer closed the socket, and the end of the stream does not block
+  ASSERT_EQ( send( raw.fd(), "", 0, 0 ), 0 );
+  ASSERT_EQ( device.sendObject( TestObjectSimple{ 2, 2.0f } ), crosstalk::WriteResult::Success );
+  shutdown( raw.fd(), SHUT_WR );
+  for ( int i = 0; i < 3 && !host.hasObject(); ++i ) host.processSerialData();
+  ASSERT_EQ( host.readObject( obj ), crosstalk::ReadResult::Success );
+  EXPECT_EQ( obj.id, 2 );
+  host.processSerialData();
+  EXPECT_FALSE( host.hasObject() );
+}
+
+int main( int argc, char **argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}